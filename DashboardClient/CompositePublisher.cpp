@@ -0,0 +1,114 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "CompositePublisher.hpp"
+
+#include <easylogging++.h>
+
+namespace Umati {
+namespace Dashboard {
+CompositePublisher::Sink_t::Sink_t(std::string name, std::shared_ptr<IPublisher> pSink, std::size_t queueSize)
+  : name(std::move(name)), pSink(std::move(pSink)), queue(queueSize) {}
+
+CompositePublisher::CompositePublisher(std::chrono::milliseconds shutdownTimeout) : m_shutdownTimeout(shutdownTimeout) {}
+
+CompositePublisher::~CompositePublisher() {
+  for (auto &pSink : m_sinks) {
+    pSink->queue.Close();
+  }
+  auto deadline = std::chrono::steady_clock::now() + m_shutdownTimeout;
+  for (auto &pSink : m_sinks) {
+    if (pSink->finished.wait_until(deadline) == std::future_status::ready) {
+      pSink->thread.join();
+    } else {
+      LOG(WARNING) << "Sink " << pSink->name << " is blocked, " << pSink->queue.GetStatistics().depth << " queued messages are not sent";
+      pSink->thread.detach();
+    }
+  }
+}
+
+void CompositePublisher::AddSink(std::string name, std::shared_ptr<IPublisher> pSink, std::size_t queueSize) {
+  auto pSinkData = std::make_shared<Sink_t>(std::move(name), std::move(pSink), queueSize);
+  auto pFinished = std::make_shared<std::promise<void>>();
+  pSinkData->finished = pFinished->get_future();
+  // The thread shares the sink, it might outlive the composite if the sink blocks
+  pSinkData->thread = std::thread([pSinkData, pFinished]() {
+    sendLoop(*pSinkData);
+    pFinished->set_value();
+  });
+  m_sinks.push_back(std::move(pSinkData));
+}
+
+void CompositePublisher::Publish(std::string channel, std::string message) { Publish(std::move(channel), std::move(message), PublishOptions()); }
+
+void CompositePublisher::Publish(std::string channel, std::string message, const PublishOptions &options) {
+  if (m_sinks.empty()) {
+    return;
+  }
+  for (std::size_t i = 0; i + 1 < m_sinks.size(); ++i) {
+    m_sinks[i]->queue.Push(channel, message, options);
+  }
+  m_sinks.back()->queue.Push(std::move(channel), std::move(message), options);
+}
+
+bool CompositePublisher::TakeDropped(const std::string &channel) {
+  bool dropped = false;
+  for (auto &pSink : m_sinks) {
+    // Every sink is asked, so each one forgets the channel
+    dropped = pSink->queue.TakeDropped(channel) | dropped;
+    dropped = pSink->pSink->TakeDropped(channel) | dropped;
+  }
+  return dropped;
+}
+
+std::uint64_t CompositePublisher::DroppedMessages() {
+  std::uint64_t dropped = 0;
+  for (auto &pSink : m_sinks) {
+    dropped += pSink->queue.DroppedMessages() + pSink->pSink->DroppedMessages();
+  }
+  return dropped;
+}
+
+std::uint64_t CompositePublisher::ConnectGeneration() {
+  std::uint64_t generation = 0;
+  for (auto &pSink : m_sinks) {
+    generation += pSink->pSink->ConnectGeneration();
+  }
+  return generation;
+}
+
+std::vector<std::pair<std::string, PublishQueue::Statistics_t>> CompositePublisher::GetStatistics(bool reset) {
+  std::vector<std::pair<std::string, PublishQueue::Statistics_t>> statistics;
+  for (auto &pSink : m_sinks) {
+    statistics.emplace_back(pSink->name, pSink->queue.GetStatistics(reset));
+  }
+  return statistics;
+}
+
+void CompositePublisher::sendLoop(Sink_t &sink) {
+  auto lastStatistics = std::chrono::steady_clock::now();
+  PublishQueue::Message_t message;
+  while (sink.queue.Pop(message)) {
+    try {
+      sink.pSink->Publish(std::move(message.channel), std::move(message.message), message.options);
+    } catch (const std::exception &ex) {
+      LOG(ERROR) << "Sink " << sink.name << " failed to publish: " << ex.what();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastStatistics >= std::chrono::minutes(1)) {
+      lastStatistics = now;
+      auto statistics = sink.queue.GetStatistics(true);
+      LOG(INFO) << "Sink " << sink.name << ": depth " << statistics.depth << " (max " << statistics.maxDepth << "), " << statistics.popped
+                << " sent, " << statistics.coalesced << " coalesced, " << statistics.dropped << " dropped (" << statistics.droppedNotRetained
+                << " not retained), latency avg "
+                << statistics.averageLatency.count() << " us (max " << statistics.maxLatency.count() << " us)";
+    }
+  }
+}
+}  // namespace Dashboard
+}  // namespace Umati
@@ -0,0 +1,73 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IPublisher.hpp"
+#include "PublishQueue.hpp"
+
+namespace Umati {
+namespace Dashboard {
+/**
+ * Forwards every message to several publishers (sinks).
+ *
+ * Each sink has its own bounded queue and thread, so a slow or blocked sink only drops its own messages
+ * instead of delaying the others. Also used for a single sink without an own queue, e.g. a file.
+ */
+class CompositePublisher : public IPublisher {
+ public:
+  /// shutdownTimeout bounds the time the destructor waits for the sinks to send their queued messages
+  explicit CompositePublisher(std::chrono::milliseconds shutdownTimeout = std::chrono::seconds(5));
+
+  /// Threads of sinks that are still blocked after the shutdown timeout are detached, they keep their sink alive
+  ~CompositePublisher() override;
+
+  /// Not thread safe, all sinks have to be added before the first message is published
+  void AddSink(std::string name, std::shared_ptr<IPublisher> pSink, std::size_t queueSize);
+
+  void Publish(std::string channel, std::string message) override;
+
+  void Publish(std::string channel, std::string message, const PublishOptions &options) override;
+
+  /// True if the message was dropped by any sink
+  bool TakeDropped(const std::string &channel) override;
+
+  /// Sum over all sinks
+  std::uint64_t DroppedMessages() override;
+
+  /// Sum over all sinks, so it changes if any of them connected again
+  std::uint64_t ConnectGeneration() override;
+
+  /// Queue statistics per sink name
+  std::vector<std::pair<std::string, PublishQueue::Statistics_t>> GetStatistics(bool reset = false);
+
+ private:
+  struct Sink_t {
+    Sink_t(std::string name, std::shared_ptr<IPublisher> pSink, std::size_t queueSize);
+
+    std::string name;
+    std::shared_ptr<IPublisher> pSink;
+    PublishQueue queue;
+    std::thread thread;
+    /// Ready when the thread left sendLoop
+    std::future<void> finished;
+  };
+
+  static void sendLoop(Sink_t &sink);
+
+  const std::chrono::milliseconds m_shutdownTimeout;
+  std::vector<std::shared_ptr<Sink_t>> m_sinks;
+};
+}  // namespace Dashboard
+}  // namespace Umati
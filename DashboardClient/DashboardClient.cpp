@@ -13,6 +13,11 @@
 #include <easylogging++.h>
 #include <Exceptions/OpcUaException.hpp>
 #include "Converter/ModelToJson.hpp"
+#include <JsonMergePatch.hpp>
+#include <IdEncode.hpp>
+#include <Iso8601.hpp>
+#include <algorithm>
+#include <functional>
 
 namespace Umati
 {
@@ -23,9 +28,26 @@ namespace Umati
 		DashboardClient::DashboardClient(
 			std::shared_ptr<IDashboardDataClient> pDashboardDataClient,
 			std::shared_ptr<IPublisher> pPublisher,
-			std::shared_ptr<OpcUaTypeReader> pTypeReader)
-			: m_pDashboardDataClient(pDashboardDataClient), m_pPublisher(pPublisher), m_pTypeReader(pTypeReader)
+			std::shared_ptr<OpcUaTypeReader> pTypeReader,
+			Util::PublishConfig publishConfig,
+			std::shared_ptr<SparkplugNode> pSparkplugNode,
+			std::shared_ptr<UadpWriterGroup> pUadpWriterGroup)
+			: m_pDashboardDataClient(pDashboardDataClient), m_pPublisher(pPublisher), m_pTypeReader(pTypeReader),
+			  m_publishConfig(publishConfig),
+			  m_pSparkplugNode(std::move(pSparkplugNode)),
+			  m_pUadpWriterGroup(std::move(pUadpWriterGroup)),
+			  m_machineEncoding(Util::PayloadEncodingFromString(publishConfig.Encoding.Machine))
 		{
+			m_machineTopicSuffix = Util::PayloadEncodingTopicSuffix(m_machineEncoding);
+			m_machineOptions.ContentType = Util::PayloadEncodingContentType(m_machineEncoding);
+			m_machineOptions.TopicClass = "machine";
+
+			auto onlineEncoding = Util::PayloadEncodingFromString(publishConfig.Encoding.Online);
+			m_onlineTopicSuffix = Util::PayloadEncodingTopicSuffix(onlineEncoding);
+			m_onlinePayload = Util::EncodePayload(1, onlineEncoding);
+			m_offlinePayload = Util::EncodePayload(0, onlineEncoding);
+			m_onlineOptions.ContentType = Util::PayloadEncodingContentType(onlineEncoding);
+			m_onlineOptions.TopicClass = "online";
 		}
 
 
@@ -37,7 +59,9 @@ namespace Umati
 			const ModelOpcUa::NodeId_t &startNodeId,
 			const std::shared_ptr<ModelOpcUa::StructureNode> &pTypeDefinition,
 			const std::string &channel,
-			const std::string &onlineChannel
+			const std::string &onlineChannel,
+			const std::string &deltaChannel,
+			const std::string &machineId
 			)
 		{
 			try
@@ -46,9 +70,11 @@ namespace Umati
 					startNodeId,
 					pTypeDefinition,
 					channel,
-					onlineChannel);
+					onlineChannel,
+					deltaChannel,
+					machineId);
 				LOG(INFO) << "DataSetStorage prepared for " << channel;
-				subscribeValues(pDataSetStorage->node, pDataSetStorage->values, pDataSetStorage->values_mutex);
+				subscribeValues(pDataSetStorage->node, pDataSetStorage->values, pDataSetStorage->values_mutex, pDataSetStorage->valuesChanged);
 				LOG(INFO) << "Values subscribed for  " << channel;
 				std::lock_guard<std::recursive_mutex> l(m_dataSetMutex);
 				m_dataSets.push_back(pDataSetStorage);
@@ -73,36 +99,169 @@ namespace Umati
 		DashboardClient::prepareDataSetStorage(const ModelOpcUa::NodeId_t &startNodeId,
 											   const std::shared_ptr<ModelOpcUa::StructureNode> &pTypeDefinition,
 											   const std::string &channel,
-											   const std::string &onlineChannel)
+											   const std::string &onlineChannel,
+											   const std::string &deltaChannel,
+											   const std::string &machineId)
 		{
 			auto pDataSetStorage = std::make_shared<DataSetStorage_t>();
 			pDataSetStorage->startNodeId = startNodeId;
 			pDataSetStorage->channel = channel;
 			pDataSetStorage->onlineChannel = onlineChannel;
+			pDataSetStorage->deltaChannel = deltaChannel;
+			pDataSetStorage->options = m_machineOptions;
+			pDataSetStorage->options.CompressionGroup = pTypeDefinition->SpecifiedBrowseName.Name;
+			pDataSetStorage->options.UserProperties.emplace_back("Specification", pTypeDefinition->SpecifiedBrowseName.Name);
 			pDataSetStorage->node = TransformToNodeIds(startNodeId, pTypeDefinition);
+			setupRateGroups(pDataSetStorage, pTypeDefinition->SpecifiedBrowseName.Name);
+			if (m_publishConfig.LeafTopics)
+			{
+				collectLeaves(pDataSetStorage->node, channel, pDataSetStorage->leaves);
+				for (auto &leaf : pDataSetStorage->leaves)
+				{
+					leaf.topic += m_machineTopicSuffix;
+				}
+			}
+			if ((m_pSparkplugNode || m_pUadpWriterGroup) && !machineId.empty())
+			{
+				// The leaves are collected with the path below the machine as topic, e.g. "/Identification/SerialNumber"
+				std::vector<Leaf_t> leaves;
+				collectLeaves(pDataSetStorage->node, std::string(), leaves);
+				if (m_pSparkplugNode)
+				{
+					auto alias = m_pSparkplugNode->AllocateAliases(leaves.size());
+					pDataSetStorage->sparkplugDevice = machineId;
+					for (const auto &leaf : leaves)
+					{
+						SparkplugMetric_t metric;
+						metric.node = leaf.node;
+						metric.name = leaf.topic.substr(1);
+						metric.alias = alias++;
+						pDataSetStorage->sparkplugMetrics.push_back(std::move(metric));
+					}
+				}
+				if (m_pUadpWriterGroup)
+				{
+					// Field indices of delta frames are 16 bit
+					if (leaves.size() > UINT16_MAX)
+					{
+						LOG(WARNING) << "Only the first " << UINT16_MAX << " of " << leaves.size() << " variables of " << channel
+									 << " are published as UADP DataSet";
+						leaves.resize(UINT16_MAX);
+					}
+					pDataSetStorage->uadpWriter = machineId;
+					pDataSetStorage->uadpWriterId = m_pUadpWriterGroup->AllocateDataSetWriterId();
+					pDataSetStorage->uadpMetaData.name = machineId;
+					for (const auto &leaf : leaves)
+					{
+						pDataSetStorage->uadpFields.push_back(UadpField_t{leaf.node, nullptr});
+						Util::Uadp::FieldMetaData_t fieldMetaData;
+						fieldMetaData.name = leaf.topic.substr(1);
+						pDataSetStorage->uadpMetaData.fields.push_back(std::move(fieldMetaData));
+					}
+				}
+			}
 			return pDataSetStorage;
 		}
 
 		void DashboardClient::Publish()
 		{
+			time_t now;
+			time(&now);
+			auto steadyNow = std::chrono::steady_clock::now();
+
 			std::lock_guard<std::recursive_mutex> l(m_dataSetMutex);
+			if (m_offline)
+			{
+				return;
+			}
+			auto connectGeneration = m_pPublisher->ConnectGeneration();
+			bool reconnected = connectGeneration != m_connectGeneration;
+			m_connectGeneration = connectGeneration;
 			for (auto &pDataSetStorage : m_dataSets)
 			{
-				std::string jsonPayload = getJson(pDataSetStorage);
-				if (!jsonPayload.empty() && jsonPayload != "null")
+				if (reconnected && pDataSetStorage->online)
 				{
-					LastMessage_t &lastMessage = m_latestMessages[pDataSetStorage->channel];
-
-					time_t now;
-					time(&now);
+					publishOnline(pDataSetStorage, true, now, true);
+				}
+				if (reconnected && m_pUadpWriterGroup && pDataSetStorage->uadpMetaDataSent)
+				{
+					// Subscribers need the retained metadata, which a restarted broker might have lost, and a key frame to decode the next delta frames
+					m_pUadpWriterGroup->PublishMetaData(*m_pPublisher, pDataSetStorage->uadpWriter, pDataSetStorage->uadpWriterId, pDataSetStorage->uadpMetaData);
+					pDataSetStorage->uadpDeltaFrames = m_pUadpWriterGroup->KeyFrameCount();
+				}
+				bool valuesChanged = pDataSetStorage->valuesChanged.exchange(false);
+				bool mergedGroupsChanged = updateRateGroups(pDataSetStorage, steadyNow);
+				LastMessage_t &lastMessage = m_latestMessages[pDataSetStorage->channel];
+				bool deltaMode = m_publishConfig.DeltaMode && !pDataSetStorage->deltaChannel.empty();
+				if (reconnected && deltaMode)
+				{
+					// A restarted broker lost the retained snapshot and patches of the outage are not buffered, so start with a snapshot
+					lastMessage.document = nlohmann::json();
+				}
+				bool republishLeaves = reconnected && m_publishConfig.LeafTopics;
+				if (republishLeaves)
+				{
+					// Unchanged leaves are skipped, but their retained messages might be lost as well
+					std::unique_lock<decltype(pDataSetStorage->values_mutex)> ul(pDataSetStorage->values_mutex);
+					for (auto &leaf : pDataSetStorage->leaves)
+					{
+						leaf.lastValue = nlohmann::json();
+					}
+				}
+				bool resendDue = (reconnected && deltaMode) || republishLeaves || lastMessage.lastSent == 0 ||
+								 (deltaMode ? difftime(now, lastMessage.lastSent) >= m_publishConfig.SnapshotInterval
+											: difftime(now, lastMessage.lastSent) > 10);
+				if (!valuesChanged && !mergedGroupsChanged && !resendDue)
+				{
+					// Nothing to send, but keep refreshing the online status and rebirth after a reconnect
+					if (pDataSetStorage->online)
+					{
+						publishOnline(pDataSetStorage, true, now);
+					}
+					if (m_pSparkplugNode)
+					{
+						publishSparkplug(pDataSetStorage);
+					}
+					continue;
+				}
 
-					if (jsonPayload != lastMessage.payload || difftime(now, lastMessage.lastSent) > 10)
+				nlohmann::json document = getJson(pDataSetStorage, pDataSetStorage->fastNode);
+				for (const auto &rateGroup : pDataSetStorage->rateGroups)
+				{
+					if (rateGroup.config.Merged && !rateGroup.document.is_null())
+					{
+						mergeDocument(document, rateGroup.document);
+					}
+				}
+				if (!document.is_null())
+				{
+					if (deltaMode)
+					{
+						publishDelta(pDataSetStorage, std::move(document), lastMessage, now);
+					}
+					else
 					{
-						m_pPublisher->Publish(pDataSetStorage->channel, jsonPayload);
-						lastMessage.payload = jsonPayload;
-						lastMessage.lastSent = now;
+						std::string payload = Util::EncodePayload(document, m_machineEncoding, 2);
+						if (payload != lastMessage.payload || difftime(now, lastMessage.lastSent) > 10)
+						{
+							m_pPublisher->Publish(pDataSetStorage->channel + m_machineTopicSuffix, payload, pDataSetStorage->options);
+							lastMessage.payload = payload;
+							lastMessage.lastSent = now;
+						}
 					}
-					m_pPublisher->Publish(pDataSetStorage->onlineChannel, "1");
+					if (m_publishConfig.LeafTopics)
+					{
+						publishLeaves(pDataSetStorage);
+					}
+					if (m_pSparkplugNode)
+					{
+						publishSparkplug(pDataSetStorage);
+					}
+					if (m_pUadpWriterGroup)
+					{
+						publishUadp(pDataSetStorage);
+					}
+					publishOnline(pDataSetStorage, true, now);
 				}
 				else
 				{
@@ -112,6 +271,91 @@ namespace Umati
 			}
 		}
 
+		/**
+		* The online state is retained, so it is only sent when it changes, after a reconnect of the publisher and, if configured,
+		* every StatusRefreshInterval to restore it on a broker that lost its retained messages.
+		*/
+		void DashboardClient::publishOnline(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage, bool online, time_t now, bool republish)
+		{
+			bool refresh = republish || (m_publishConfig.StatusRefreshInterval > 0 &&
+										 difftime(now, pDataSetStorage->onlineSent) >= m_publishConfig.StatusRefreshInterval);
+			if (online == pDataSetStorage->online && !refresh)
+			{
+				return;
+			}
+			m_pPublisher->Publish(pDataSetStorage->onlineChannel + m_onlineTopicSuffix,
+								  online ? m_onlinePayload : m_offlinePayload,
+								  m_onlineOptions);
+			pDataSetStorage->online = online;
+			pDataSetStorage->onlineSent = now;
+		}
+
+		void DashboardClient::PublishOffline()
+		{
+			time_t now;
+			time(&now);
+
+			std::lock_guard<std::recursive_mutex> l(m_dataSetMutex);
+			m_offline = true;
+			for (auto &pDataSetStorage : m_dataSets)
+			{
+				if (pDataSetStorage->online)
+				{
+					publishOnline(pDataSetStorage, false, now);
+				}
+				if (m_pSparkplugNode && pDataSetStorage->sparkplugBirth != 0)
+				{
+					PublishOptions options;
+					options.TopicClass = "sparkplug";
+					m_pSparkplugNode->Publish(*m_pPublisher,
+											  m_pSparkplugNode->DeviceTopic("DDEATH", pDataSetStorage->sparkplugDevice),
+											  Util::SparkplugB::Payload_t(),
+											  options,
+											  pDataSetStorage->sparkplugBirth);
+					pDataSetStorage->sparkplugBirth = 0;
+				}
+				if (m_pUadpWriterGroup && pDataSetStorage->uadpMetaDataSent)
+				{
+					m_pUadpWriterGroup->ClearMetaData(*m_pPublisher, pDataSetStorage->uadpWriter);
+					pDataSetStorage->uadpMetaDataSent = false;
+				}
+			}
+		}
+
+		/**
+		* Sends the full document as retained snapshot every SnapshotInterval, in between only a merge patch
+		* against the previously sent document is published (not retained) on the delta channel.
+		* If a patch was dropped by the publisher, the following ones would miss its changes, so a snapshot is sent instead.
+		*/
+		void DashboardClient::publishDelta(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage,
+										   nlohmann::json document,
+										   LastMessage_t &lastMessage,
+										   time_t now)
+		{
+			bool patchDropped = m_pPublisher->TakeDropped(pDataSetStorage->deltaChannel + m_machineTopicSuffix);
+			if (patchDropped || lastMessage.document.is_null() || difftime(now, lastMessage.lastSent) >= m_publishConfig.SnapshotInterval)
+			{
+				m_pPublisher->Publish(pDataSetStorage->channel + m_machineTopicSuffix,
+									  Util::EncodePayload(document, m_machineEncoding, 2),
+									  pDataSetStorage->options);
+				lastMessage.lastSent = now;
+			}
+			else
+			{
+				nlohmann::json patch = Util::CreateMergePatch(lastMessage.document, document);
+				if (!patch.empty())
+				{
+					PublishOptions options = pDataSetStorage->options;
+					options.Retain = false;
+					options.TopicClass = "delta";
+					m_pPublisher->Publish(pDataSetStorage->deltaChannel + m_machineTopicSuffix,
+										  Util::EncodePayload(patch, m_machineEncoding),
+										  options);
+				}
+			}
+			lastMessage.document = std::move(document);
+		}
+
 		void DashboardClient::Unsubscribe(ModelOpcUa::NodeId_t nodeId){
 
 			std::vector<int32_t> monItemIds;
@@ -137,38 +381,506 @@ namespace Umati
 			
 		}
 
-		std::string DashboardClient::getJson(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage)
+		/**
+		* Assigns the nodes of the machine to the configured rate groups. A path selects exactly one node, a type
+		* every matching node that is not below another match. Each node is only assigned to the first group.
+		*/
+		void DashboardClient::setupRateGroups(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage, const std::string &specification)
+		{
+			pDataSetStorage->fastNode = pDataSetStorage->node;
+			std::set<std::shared_ptr<const ModelOpcUa::Node>> groupedNodes;
+			for (const auto &rateGroupConfig : m_publishConfig.RateGroups)
+			{
+				if (!rateGroupConfig.Specification.empty() && rateGroupConfig.Specification != specification)
+				{
+					continue;
+				}
+				RateGroup_t rateGroup;
+				rateGroup.config = rateGroupConfig;
+				rateGroup.channel = pDataSetStorage->channel + "/$group/" + Util::IdEncode(rateGroupConfig.Name);
+
+				auto addNode = [&](std::vector<std::string> path, const std::shared_ptr<const ModelOpcUa::Node> &pNode) {
+					if (groupedNodes.insert(pNode).second)
+					{
+						rateGroup.nodes.push_back(RateGroupNode_t{std::move(path), pNode});
+					}
+				};
+
+				for (const auto &path : rateGroupConfig.Paths)
+				{
+					std::vector<std::string> documentPath;
+					std::shared_ptr<const ModelOpcUa::Node> pNode = pDataSetStorage->node;
+					std::size_t begin = 0;
+					while (pNode && begin <= path.size())
+					{
+						auto end = std::min(path.find('/', begin), path.size());
+						auto browseName = path.substr(begin, end - begin);
+						begin = end + 1;
+
+						auto pSimpleNode = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(pNode);
+						pNode = nullptr;
+						if (!pSimpleNode)
+						{
+							break;
+						}
+						for (const auto &pChild : pSimpleNode->ChildNodes)
+						{
+							if (pChild->SpecifiedBrowseName.Name == browseName)
+							{
+								appendDocumentPath(pSimpleNode, pChild, documentPath);
+								pNode = pChild;
+								break;
+							}
+						}
+					}
+					if (pNode)
+					{
+						addNode(documentPath, pNode);
+					}
+				}
+
+				if (!rateGroupConfig.Types.empty())
+				{
+					std::function<void(const std::shared_ptr<const ModelOpcUa::SimpleNode> &, const std::vector<std::string> &)> findTypes =
+						[&](const std::shared_ptr<const ModelOpcUa::SimpleNode> &pSimpleNode, const std::vector<std::string> &parentPath) {
+							for (const auto &pChild : pSimpleNode->ChildNodes)
+							{
+								auto pSimpleChild = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(pChild);
+								if (!pSimpleChild)
+								{
+									continue;
+								}
+								std::vector<std::string> documentPath = parentPath;
+								appendDocumentPath(pSimpleNode, pChild, documentPath);
+								bool matches = std::any_of(rateGroupConfig.Types.begin(), rateGroupConfig.Types.end(),
+														   [&](const ModelOpcUa::NodeId_t &type) {
+															   return type == pSimpleChild->SpecifiedTypeNodeId || type == pSimpleChild->TypeNodeId;
+														   });
+								if (matches)
+								{
+									addNode(documentPath, pChild);
+								}
+								else
+								{
+									findTypes(pSimpleChild, documentPath);
+								}
+							}
+						};
+					findTypes(pDataSetStorage->node, std::vector<std::string>());
+				}
+
+				if (!rateGroup.nodes.empty())
+				{
+					LOG(INFO) << "Rate group " << rateGroupConfig.Name << " contains " << rateGroup.nodes.size() << " nodes of " << pDataSetStorage->channel;
+					pDataSetStorage->rateGroups.push_back(std::move(rateGroup));
+				}
+			}
+
+			if (!groupedNodes.empty())
+			{
+				pDataSetStorage->fastNode = pruneNodes(pDataSetStorage->node, groupedNodes, pDataSetStorage->prunedCopies);
+			}
+		}
+
+		/// Mirrors ModelToJson, the children of a BaseDataVariable are nested in "properties"
+		void DashboardClient::appendDocumentPath(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pParent,
+												 const std::shared_ptr<const ModelOpcUa::Node> &pChild,
+												 std::vector<std::string> &documentPath)
+		{
+			if (pParent->ofBaseDataVariableType)
+			{
+				documentPath.emplace_back("properties");
+			}
+			documentPath.push_back(pChild->SpecifiedBrowseName.Name);
+		}
+
+		std::shared_ptr<const ModelOpcUa::Node> DashboardClient::pruneNodes(
+			const std::shared_ptr<const ModelOpcUa::Node> &pNode,
+			const std::set<std::shared_ptr<const ModelOpcUa::Node>> &removedNodes,
+			std::map<std::shared_ptr<const ModelOpcUa::Node>, std::shared_ptr<const ModelOpcUa::Node>> &copies)
+		{
+			auto pSimpleNode = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(pNode);
+			if (!pSimpleNode)
+			{
+				return pNode;
+			}
+			bool changed = false;
+			std::list<std::shared_ptr<const ModelOpcUa::Node>> childNodes;
+			for (const auto &pChild : pSimpleNode->ChildNodes)
+			{
+				if (removedNodes.count(pChild) != 0)
+				{
+					changed = true;
+					continue;
+				}
+				auto pPrunedChild = pruneNodes(pChild, removedNodes, copies);
+				changed = changed || pPrunedChild != pChild;
+				childNodes.push_back(pPrunedChild);
+			}
+			if (!changed)
+			{
+				return pNode;
+			}
+			// Values are stored for the original node, findValue looks it up through copies
+			auto pCopy = std::make_shared<ModelOpcUa::SimpleNode>(pSimpleNode->NodeId, pSimpleNode->TypeNodeId, *pSimpleNode, childNodes);
+			pCopy->ofBaseDataVariableType = pSimpleNode->ofBaseDataVariableType;
+			copies.emplace(pCopy, pNode);
+			return pCopy;
+		}
+
+		bool DashboardClient::updateRateGroups(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage, std::chrono::steady_clock::time_point now)
+		{
+			bool mergedGroupsChanged = false;
+			for (auto &rateGroup : pDataSetStorage->rateGroups)
+			{
+				if (now < rateGroup.nextUpdate)
+				{
+					continue;
+				}
+				rateGroup.nextUpdate = now + std::chrono::milliseconds(rateGroup.config.Interval);
+
+				nlohmann::json document;
+				for (const auto &rateGroupNode : rateGroup.nodes)
+				{
+					nlohmann::json json = getJson(pDataSetStorage, rateGroupNode.node);
+					if (json.is_null())
+					{
+						continue;
+					}
+					nlohmann::json *pTarget = &document;
+					for (const auto &browseName : rateGroupNode.path)
+					{
+						pTarget = &(*pTarget)[browseName];
+					}
+					*pTarget = std::move(json);
+				}
+				if (rateGroup.config.Merged && document != rateGroup.document)
+				{
+					mergedGroupsChanged = true;
+				}
+				rateGroup.document = std::move(document);
+
+				if (!rateGroup.config.Merged && !rateGroup.document.is_null())
+				{
+					std::string payload = Util::EncodePayload(rateGroup.document, m_machineEncoding, 2);
+					if (payload != rateGroup.payload)
+					{
+						PublishOptions options = pDataSetStorage->options;
+						options.TopicClass = "group";
+						m_pPublisher->Publish(rateGroup.channel + m_machineTopicSuffix, payload, options);
+						rateGroup.payload = std::move(payload);
+					}
+				}
+			}
+			return mergedGroupsChanged;
+		}
+
+		/// Recursively adds the fields of source to target, other values of target are replaced
+		void DashboardClient::mergeDocument(nlohmann::json &target, const nlohmann::json &source)
+		{
+			if (source.is_object() && source.contains("properties") && !target.is_object() && !target.is_null())
+			{
+				// A BaseDataVariable whose children all belong to rate groups is serialized as bare value
+				target = nlohmann::json{{"value", std::move(target)}};
+			}
+			if (!target.is_object() || !source.is_object())
+			{
+				target = source;
+				return;
+			}
+			for (auto it = source.begin(); it != source.end(); ++it)
+			{
+				mergeDocument(target[it.key()], it.value());
+			}
+		}
+
+		nlohmann::json DashboardClient::getJson(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage,
+												const std::shared_ptr<const ModelOpcUa::Node> &pNode)
 		{
 			auto getValueCallback = [pDataSetStorage](
 										const std::shared_ptr<const ModelOpcUa::Node> &pNode) -> nlohmann::json {
 				std::unique_lock<decltype(pDataSetStorage->values_mutex)> ul(pDataSetStorage->values_mutex);
-				auto it = pDataSetStorage->values.find(pNode);
-				if (it == pDataSetStorage->values.end()) {
-					LOG(DEBUG) << "Couldn't write value for " << pNode->SpecifiedBrowseName.Name << " | " << pNode->SpecifiedTypeNodeId.Uri << ";" << pNode->SpecifiedTypeNodeId.Id << "Try to search it with NodeId!";
-					// In case we don't wnt to remove the duplicate pointers with FIX_1, we can simply check the
-					// Identity of the node via its node Id.
-					auto pSimpleNode = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(pNode);
-					if(pSimpleNode) {
-						LOG(DEBUG) << pSimpleNode->NodeId << "\n";
-						auto values = pDataSetStorage->values;
-						for(auto it1 : values) {
-							auto pSimpleNode1 = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(it1.first);
-								if(pSimpleNode1->NodeId == pSimpleNode->NodeId) {
-									// DEBUG_BEGIN in case we want to see the different pointer addresses.
-									LOG(DEBUG) << pSimpleNode.get() << "\n";
-									LOG(DEBUG) << pSimpleNode1.get() << "\n";
-									LOG(DEBUG) << pNode->SpecifiedBrowseName.Name << " " << "found!";
-									return it1.second;
-								}
-						}
-					}
-					LOG(DEBUG) << pNode->SpecifiedBrowseName.Name << " " << " not found!";
+				const NodeValue_t *pValue = findValue(pDataSetStorage, pNode);
+				if (!pValue) {
 					return nullptr;
 				}
-				return it->second;
+				return pValue->value;
 			};
 
-			return Converter::ModelToJson(pDataSetStorage->node, getValueCallback).getJson().dump(2);
+			return Converter::ModelToJson(pNode, getValueCallback).getJson();
+		}
+
+		const DashboardClient::NodeValue_t *DashboardClient::findValue(
+			const std::shared_ptr<DataSetStorage_t> &pDataSetStorage,
+			const std::shared_ptr<const ModelOpcUa::Node> &pNode)
+		{
+			auto it = pDataSetStorage->values.find(pNode);
+			if (it != pDataSetStorage->values.end()) {
+				return &it->second;
+			}
+			auto itCopy = pDataSetStorage->prunedCopies.find(pNode);
+			if (itCopy != pDataSetStorage->prunedCopies.end()) {
+				it = pDataSetStorage->values.find(itCopy->second);
+				return it != pDataSetStorage->values.end() ? &it->second : nullptr;
+			}
+			LOG(DEBUG) << "Couldn't write value for " << pNode->SpecifiedBrowseName.Name << " | " << pNode->SpecifiedTypeNodeId.Uri << ";" << pNode->SpecifiedTypeNodeId.Id << "Try to search it with NodeId!";
+			// In case we don't wnt to remove the duplicate pointers with FIX_1, we can simply check the
+			// Identity of the node via its node Id.
+			auto pSimpleNode = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(pNode);
+			if(pSimpleNode) {
+				LOG(DEBUG) << pSimpleNode->NodeId << "\n";
+				for(const auto &it1 : pDataSetStorage->values) {
+					auto pSimpleNode1 = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(it1.first);
+						if(pSimpleNode1 && pSimpleNode1->NodeId == pSimpleNode->NodeId) {
+							// DEBUG_BEGIN in case we want to see the different pointer addresses.
+							LOG(DEBUG) << pSimpleNode.get() << "\n";
+							LOG(DEBUG) << pSimpleNode1.get() << "\n";
+							LOG(DEBUG) << pNode->SpecifiedBrowseName.Name << " " << "found!";
+							return &it1.second;
+						}
+				}
+			}
+			LOG(DEBUG) << pNode->SpecifiedBrowseName.Name << " " << " not found!";
+			return nullptr;
+		}
+
+		/**
+		* Mirrors the structure of ModelToJson, every level of the JSON document becomes a level of the topic.
+		*/
+		void DashboardClient::collectLeaves(const std::shared_ptr<const ModelOpcUa::Node> &pNode,
+											const std::string &topic,
+											std::vector<Leaf_t> &leaves)
+		{
+			switch (pNode->ModellingRule)
+			{
+			case ModelOpcUa::Mandatory:
+			case ModelOpcUa::Optional:
+			{
+				auto pSimpleNode = std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(pNode);
+				if (!pSimpleNode)
+				{
+					return;
+				}
+				if (isMandatoryOrOptionalVariable(pSimpleNode))
+				{
+					leaves.push_back(Leaf_t{pNode, topic, nullptr});
+				}
+				for (const auto &pChild : pSimpleNode->ChildNodes)
+				{
+					collectLeaves(pChild, topic + "/" + Util::IdEncode(pChild->SpecifiedBrowseName.Name), leaves);
+				}
+				break;
+			}
+			case ModelOpcUa::MandatoryPlaceholder:
+			case ModelOpcUa::OptionalPlaceholder:
+			{
+				auto pPlaceholderNode = std::dynamic_pointer_cast<const ModelOpcUa::PlaceholderNode>(pNode);
+				if (!pPlaceholderNode)
+				{
+					return;
+				}
+				for (const auto &placeholderElement : pPlaceholderNode->getInstances())
+				{
+					collectLeaves(placeholderElement.pNode, topic + "/" + Util::IdEncode(placeholderElement.BrowseName.Name), leaves);
+				}
+				break;
+			}
+			default:
+				break;
+			}
+		}
+
+		void DashboardClient::publishLeaves(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage)
+		{
+			std::vector<std::pair<std::string, std::string>> messages;
+			{
+				std::unique_lock<decltype(pDataSetStorage->values_mutex)> ul(pDataSetStorage->values_mutex);
+				for (auto &leaf : pDataSetStorage->leaves)
+				{
+					const NodeValue_t *pValue = findValue(pDataSetStorage, leaf.node);
+					if (!pValue || pValue->value == leaf.lastValue)
+					{
+						continue;
+					}
+					leaf.lastValue = pValue->value;
+					nlohmann::json payload;
+					payload["value"] = pValue->value;
+					payload["sourceTimestamp"] = Util::ToIso8601(pValue->sourceTimestamp);
+					messages.emplace_back(leaf.topic, Util::EncodePayload(payload, m_machineEncoding));
+				}
+			}
+			PublishOptions options = m_machineOptions;
+			options.TopicClass = "leaf";
+			for (auto &message : messages)
+			{
+				m_pPublisher->Publish(std::move(message.first), std::move(message.second), options);
+			}
+		}
+
+		/**
+		* Metrics are sent with their alias only, the names and data types are declared once in the DBIRTH.
+		* A value that does not match the declared data type, e.g. a value that was null at the birth, triggers a new DBIRTH.
+		*/
+		void DashboardClient::publishSparkplug(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage)
+		{
+			auto birthGeneration = m_pSparkplugNode->BirthGeneration();
+			if (pDataSetStorage->sparkplugDevice.empty() || birthGeneration == 0)
+			{
+				// Devices are born after the NBIRTH of the node
+				return;
+			}
+			bool birth = pDataSetStorage->sparkplugBirth != birthGeneration;
+			Util::SparkplugB::Payload_t payload;
+			// Values contained in the payload, they become the lastValue once it is published
+			std::vector<std::pair<SparkplugMetric_t *, nlohmann::json>> sentValues;
+			{
+				std::unique_lock<decltype(pDataSetStorage->values_mutex)> ul(pDataSetStorage->values_mutex);
+				for (bool complete = false; !complete;)
+				{
+					complete = true;
+					payload.metrics.clear();
+					sentValues.clear();
+					for (auto &metric : pDataSetStorage->sparkplugMetrics)
+					{
+						const NodeValue_t *pValue = findValue(pDataSetStorage, metric.node);
+						const nlohmann::json value = pValue ? pValue->value : nlohmann::json();
+						if (!birth && value == metric.lastValue)
+						{
+							continue;
+						}
+						Util::SparkplugB::Metric_t sparkplugMetric;
+						sparkplugMetric.alias = metric.alias;
+						if (pValue)
+						{
+							sparkplugMetric.timestamp = static_cast<std::uint64_t>(
+								std::chrono::duration_cast<std::chrono::milliseconds>(pValue->sourceTimestamp.time_since_epoch()).count());
+						}
+						if (birth)
+						{
+							sparkplugMetric.name = metric.name;
+							if (!value.is_null())
+							{
+								metric.dataType = Util::SparkplugB::DataTypeOf(value);
+							}
+						}
+						sparkplugMetric.dataType = metric.dataType;
+						if (!Util::SparkplugB::SetValue(sparkplugMetric, value))
+						{
+							birth = true;
+							complete = false;
+							break;
+						}
+						payload.metrics.push_back(std::move(sparkplugMetric));
+						sentValues.emplace_back(&metric, value);
+					}
+				}
+				if (!birth && payload.metrics.empty())
+				{
+					return;
+				}
+			}
+
+			PublishOptions options = m_machineOptions;
+			options.ContentType.clear();
+			options.TopicClass = "sparkplug";
+			const auto messageType = birth ? "DBIRTH" : "DDATA";
+			if (!m_pSparkplugNode->Publish(*m_pPublisher,
+										   m_pSparkplugNode->DeviceTopic(messageType, pDataSetStorage->sparkplugDevice),
+										   std::move(payload),
+										   options,
+										   birthGeneration))
+			{
+				// The node was born again in the meantime
+				pDataSetStorage->sparkplugBirth = 0;
+				return;
+			}
+			pDataSetStorage->sparkplugBirth = birthGeneration;
+			for (auto &sentValue : sentValues)
+			{
+				sentValue.first->lastValue = std::move(sentValue.second);
+			}
+		}
+
+		/**
+		* The field types are taken from the values at the first publish, fields without value are declared as BaseDataType.
+		* A field whose value changes its type is declared as BaseDataType in a new version of the metadata, followed by a key frame.
+		*/
+		void DashboardClient::publishUadp(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage)
+		{
+			if (pDataSetStorage->uadpWriter.empty())
+			{
+				return;
+			}
+			auto &metaData = pDataSetStorage->uadpMetaData;
+			bool metaDataChanged = !pDataSetStorage->uadpMetaDataSent;
+			// Consumers can not apply delta frames after a dropped one
+			bool frameDropped = m_pPublisher->TakeDropped(m_pUadpWriterGroup->DataTopic(pDataSetStorage->uadpWriter));
+			bool keyFrame = frameDropped || metaDataChanged || pDataSetStorage->uadpDeltaFrames + 1 >= m_pUadpWriterGroup->KeyFrameCount();
+			Util::Uadp::DataSetMessage_t message;
+			{
+				std::unique_lock<decltype(pDataSetStorage->values_mutex)> ul(pDataSetStorage->values_mutex);
+				std::vector<const NodeValue_t *> values;
+				values.reserve(pDataSetStorage->uadpFields.size());
+				for (std::size_t i = 0; i < pDataSetStorage->uadpFields.size(); ++i)
+				{
+					const NodeValue_t *pValue = findValue(pDataSetStorage, pDataSetStorage->uadpFields[i].node);
+					values.push_back(pValue);
+					if (!pValue || pValue->value.is_null())
+					{
+						continue;
+					}
+					auto &fieldMetaData = metaData.fields[i];
+					if (!pDataSetStorage->uadpMetaDataSent)
+					{
+						fieldMetaData.builtInType = Util::Uadp::BuiltInTypeOf(pValue->value);
+					}
+					else if (!Util::Uadp::Fits(fieldMetaData.builtInType, pValue->value))
+					{
+						fieldMetaData.builtInType = Util::Uadp::BuiltInType_t::Variant;
+						metaDataChanged = true;
+						keyFrame = true;
+					}
+				}
+				for (std::size_t i = 0; i < pDataSetStorage->uadpFields.size(); ++i)
+				{
+					auto &field = pDataSetStorage->uadpFields[i];
+					const NodeValue_t *pValue = values[i];
+					nlohmann::json value = pValue ? pValue->value : nlohmann::json();
+					if (!keyFrame && value == field.lastValue)
+					{
+						continue;
+					}
+					Util::Uadp::Field_t uadpField;
+					uadpField.index = static_cast<std::uint16_t>(i);
+					uadpField.builtInType = metaData.fields[i].builtInType;
+					if (pValue)
+					{
+						uadpField.sourceTimestamp = pValue->sourceTimestamp;
+					}
+					field.lastValue = value;
+					uadpField.value = std::move(value);
+					message.fields.push_back(std::move(uadpField));
+				}
+			}
+			if (!keyFrame && message.fields.empty())
+			{
+				return;
+			}
+
+			if (metaDataChanged)
+			{
+				// Every change of the metadata breaks the decoding of older DataSetMessages, so both versions change
+				metaData.configurationVersion.major = Util::Uadp::VersionTime(metaData.configurationVersion.major);
+				metaData.configurationVersion.minor = metaData.configurationVersion.major;
+				m_pUadpWriterGroup->PublishMetaData(*m_pPublisher, pDataSetStorage->uadpWriter, pDataSetStorage->uadpWriterId, metaData);
+				pDataSetStorage->uadpMetaDataSent = true;
+			}
+			message.type = keyFrame ? Util::Uadp::DataSetMessageType_t::KeyFrame : Util::Uadp::DataSetMessageType_t::DeltaFrame;
+			message.sequenceNumber = pDataSetStorage->uadpSequenceNumber++;
+			message.timestamp = std::chrono::system_clock::now();
+			message.configurationVersion = metaData.configurationVersion;
+			m_pUadpWriterGroup->PublishDataSetMessage(*m_pPublisher, pDataSetStorage->uadpWriter, pDataSetStorage->uadpWriterId, message);
+			pDataSetStorage->uadpDeltaFrames = keyFrame ? 0 : pDataSetStorage->uadpDeltaFrames + 1;
 		}
 
 		std::shared_ptr<const ModelOpcUa::SimpleNode> DashboardClient::TransformToNodeIds(
@@ -379,11 +1091,10 @@ namespace Umati
 						LOG(INFO) << "Updated TypeDefinition of " << browseResult.BrowseName.Name << " to " << browseResult.TypeDefinition 
 								  << " because the node implements an interface";				
 				}
-				auto possibleType = m_pTypeReader->m_typeMap->find(browseResult.TypeDefinition);  // use subtype
-				if (possibleType != m_pTypeReader->m_typeMap->end())
+				auto sharedPossibleType = m_pTypeReader->findTypeDefinition(browseResult.TypeDefinition);  // use subtype
+				if (sharedPossibleType != nullptr)
 				{
 					// LOG(INFO) << "Found type for " << typeName;
-					auto sharedPossibleType = possibleType->second;
 					ModelOpcUa::PlaceholderElement plElement;
 					plElement.BrowseName = browseResult.BrowseName;
 					plElement.pNode = TransformToNodeIds(browseResult.NodeId, sharedPossibleType);
@@ -402,23 +1113,25 @@ namespace Umati
 
 		void DashboardClient::subscribeValues(
 			const std::shared_ptr<const ModelOpcUa::SimpleNode> pNode,
-			std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-			std::mutex &valueMap_mutex)
+			ValueMap_t &valueMap,
+			std::mutex &valueMap_mutex,
+			std::atomic_bool &valuesChanged)
 		{
 			// LOG(INFO) << "subscribeValues "   << pNode->NodeId.Uri << ";" << pNode->NodeId.Id;
 
 			// Only Mandatory/Optional variables
 			if (isMandatoryOrOptionalVariable(pNode))
 			{	
-				subscribeValue(pNode, valueMap, valueMap_mutex);
+				subscribeValue(pNode, valueMap, valueMap_mutex, valuesChanged);
 				
 			}
-			handleSubscribeChildNodes(pNode, valueMap, valueMap_mutex);
+			handleSubscribeChildNodes(pNode, valueMap, valueMap_mutex, valuesChanged);
 		}
 
 		void DashboardClient::handleSubscribeChildNodes(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode,
-														std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-														std::mutex &valueMap_mutex)
+														ValueMap_t &valueMap,
+														std::mutex &valueMap_mutex,
+														std::atomic_bool &valuesChanged)
 		{
 			// LOG(INFO) << "handleSubscribeChildNodes "   << pNode->NodeId.Uri << ";" << pNode->NodeId.Id;
 			if (pNode->ChildNodes.size() == 0)
@@ -432,13 +1145,13 @@ namespace Umati
 				case ModelOpcUa::Mandatory:
 				case ModelOpcUa::Optional:
 				{
-					handleSubscribeChildNode(pChildNode, valueMap, valueMap_mutex);
+					handleSubscribeChildNode(pChildNode, valueMap, valueMap_mutex, valuesChanged);
 					break;
 				}
 				case ModelOpcUa::MandatoryPlaceholder:
 				case ModelOpcUa::OptionalPlaceholder:
 				{
-					handleSubscribePlaceholderChildNode(pChildNode, valueMap, valueMap_mutex);
+					handleSubscribePlaceholderChildNode(pChildNode, valueMap, valueMap_mutex, valuesChanged);
 					break;
 				}
 				default:
@@ -451,8 +1164,9 @@ namespace Umati
 		}
 
 		void DashboardClient::handleSubscribeChildNode(const std::shared_ptr<const ModelOpcUa::Node> &pChildNode,
-													   std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-													   std::mutex &valueMap_mutex)
+													   ValueMap_t &valueMap,
+													   std::mutex &valueMap_mutex,
+													   std::atomic_bool &valuesChanged)
 		{
 			// LOG(INFO) << "handleSubscribeChildNode " <<  pChildNode->SpecifiedBrowseName.Uri << ";" <<  pChildNode->SpecifiedBrowseName.Name;
 
@@ -463,13 +1177,14 @@ namespace Umati
 				return;
 			}
 			// recursive call
-			subscribeValues(pSimpleChild, valueMap, valueMap_mutex);
+			subscribeValues(pSimpleChild, valueMap, valueMap_mutex, valuesChanged);
 		}
 
 		void
 		DashboardClient::handleSubscribePlaceholderChildNode(const std::shared_ptr<const ModelOpcUa::Node> &pChildNode,
-															 std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-															 std::mutex &valueMap_mutex)
+															 ValueMap_t &valueMap,
+															 std::mutex &valueMap_mutex,
+															 std::atomic_bool &valuesChanged)
 		{
 			// LOG(INFO) << "handleSubscribePlaceholderChildNode " << pChildNode->SpecifiedBrowseName.Uri << ";" << pChildNode->SpecifiedBrowseName.Name;
 			auto pPlaceholderChild = std::dynamic_pointer_cast<const ModelOpcUa::PlaceholderNode>(pChildNode);
@@ -484,13 +1199,14 @@ namespace Umati
 			for (const auto &pPlaceholderElement : placeholderElements)
 			{
 				// recursive call
-				subscribeValues(pPlaceholderElement.pNode, valueMap, valueMap_mutex);
+				subscribeValues(pPlaceholderElement.pNode, valueMap, valueMap_mutex, valuesChanged);
 			}
 		}
 
 		void DashboardClient::subscribeValue(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode,
-											 std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-											 std::mutex &valueMap_mutex
+											 ValueMap_t &valueMap,
+											 std::mutex &valueMap_mutex,
+											 std::atomic_bool &valuesChanged
 											 )
 		{ /**
                                              * Creates a lambda function which gets pNode as a copy and valueMap as a reference from this function,
@@ -499,9 +1215,10 @@ namespace Umati
                                              */
 			// LOG(INFO) << "SubscribeValue " << pNode->SpecifiedBrowseName.Uri << ";" << pNode->SpecifiedBrowseName.Name << " | " << pNode->NodeId.Uri << ";" << pNode->NodeId.Id;
 			
-			auto callback = [pNode, &valueMap, &valueMap_mutex](nlohmann::json value) {
-					std::unique_lock<std::remove_reference<decltype(valueMap_mutex)>::type>(valueMap_mutex);
-					valueMap[pNode] = value;
+			auto callback = [pNode, &valueMap, &valueMap_mutex, &valuesChanged](nlohmann::json value, std::chrono::system_clock::time_point sourceTimestamp) {
+					std::unique_lock<std::remove_reference<decltype(valueMap_mutex)>::type> ul(valueMap_mutex);
+					valueMap[pNode] = NodeValue_t{value, sourceTimestamp};
+					valuesChanged = true;
 			};
 			try
 			{
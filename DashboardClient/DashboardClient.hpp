@@ -12,10 +12,17 @@
 #include "IDashboardDataClient.hpp"
 #include "OpcUaTypeReader.hpp"
 #include "IPublisher.hpp"
+#include "SparkplugNode.hpp"
+#include "UadpWriterGroup.hpp"
+#include <Configuration.hpp>
+#include <PayloadEncoding.hpp>
 #include <ModelOpcUa/ModelInstance.hpp>
 #include <map>
 #include <set>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <vector>
 namespace Umati {
 
 	namespace Dashboard {
@@ -30,9 +37,9 @@ namespace Umati {
 		* - While the IDashboardDataClient instance acts as a source and IPublisher as the sink.
 		* - DashboardClient is initialized by DashboardMachineObserver when a machine was found. 
 		* - DashboardMachineObserver calls addDataSet to integrate the machine into the 
-		*   system. Besides, DashboardMachineObserver forwards the Publish() function to the 
-		*   DashboardOpcUaClient which contains a thread calling the fowarded Publish() method
-		*   every second. DashboardClient itself then resolves topics and payloads and forwards this
+		*   system. Besides, DashboardMachineObserver schedules the Publish() function with the
+		*   configured interval of the machine, the due calls are made from the loop of
+		*   DashboardOpcUaClient. DashboardClient itself then resolves topics and payloads and forwards this
 		*   to the IPublisher.
 		* All further functions are protected and used internally 
 		*/
@@ -40,36 +47,167 @@ namespace Umati {
 		public:
 			DashboardClient(std::shared_ptr<IDashboardDataClient> pDashboardDataClient,
 							std::shared_ptr<IPublisher> pPublisher,
-							std::shared_ptr<OpcUaTypeReader> pTypeReader);
+							std::shared_ptr<OpcUaTypeReader> pTypeReader,
+							Util::PublishConfig publishConfig,
+							std::shared_ptr<SparkplugNode> pSparkplugNode = nullptr,
+							std::shared_ptr<UadpWriterGroup> pUadpWriterGroup = nullptr);
 
+			/// deltaChannel receives merge patches of channel if the DeltaMode is enabled, might be empty.
+			/// machineId is the Sparkplug B device id and the UADP DataSetWriter name of the dataset, if these are enabled.
 			void addDataSet(
 					const ModelOpcUa::NodeId_t &startNodeId,
 					const std::shared_ptr<ModelOpcUa::StructureNode> &pTypeDefinition,
 					const std::string &channel,
-					const std::string &onlineChannel);
+					const std::string &onlineChannel,
+					const std::string &deltaChannel = std::string(),
+					const std::string &machineId = std::string());
 
 			void Publish();
 
 			void Unsubscribe(ModelOpcUa::NodeId_t nodeId);
 
+			/// Publishes the retained offline marker for every dataset that was reported online, later calls of Publish are ignored
+			void PublishOffline();
 
 		protected:
 
 			struct LastMessage_t {
 				std::string payload;
-				time_t lastSent;
+				time_t lastSent = 0;
+				/// Document the next merge patch is based on, only used in DeltaMode
+				nlohmann::json document;
+			};
+
+			struct NodeValue_t {
+				nlohmann::json value;
+				std::chrono::system_clock::time_point sourceTimestamp;
+			};
+
+			typedef std::map<std::shared_ptr<const ModelOpcUa::Node>, NodeValue_t> ValueMap_t;
+
+			/// A subscribed variable published on its own topic in LeafTopics mode
+			struct Leaf_t {
+				std::shared_ptr<const ModelOpcUa::Node> node;
+				/// Precomputed from the BrowseNames below the machine topic
+				std::string topic;
+				nlohmann::json lastValue;
+			};
+
+			/// A subscribed variable as metric of the Sparkplug B device
+			struct SparkplugMetric_t {
+				std::shared_ptr<const ModelOpcUa::Node> node;
+				/// BrowseName path below the machine, levels separated by '/'
+				std::string name;
+				std::uint64_t alias;
+				/// Declared in the last DBIRTH, a value of another type requires a new DBIRTH
+				Util::SparkplugB::DataType_t dataType = Util::SparkplugB::DataType_t::String;
+				nlohmann::json lastValue;
+			};
+
+			/// A subscribed variable as field of the UADP DataSet, name and type are kept in the metadata
+			struct UadpField_t {
+				std::shared_ptr<const ModelOpcUa::Node> node;
+				nlohmann::json lastValue;
+			};
+
+			/// Node of a rate group and its path in the machine document
+			struct RateGroupNode_t {
+				std::vector<std::string> path;
+				std::shared_ptr<const ModelOpcUa::Node> node;
+			};
+
+			struct RateGroup_t {
+				Util::RateGroupConfig config;
+				/// Topic of the group, only used if the group is not merged
+				std::string channel;
+				std::vector<RateGroupNode_t> nodes;
+				std::chrono::steady_clock::time_point nextUpdate;
+				/// Last serialized document of the group, merged into the machine document
+				nlohmann::json document;
+				std::string payload;
 			};
 
 			struct DataSetStorage_t {
 				ModelOpcUa::NodeId_t startNodeId;
 				std::string channel;
 				std::string onlineChannel;
+				std::string deltaChannel;
+				/// Options of the machine document, compressed with a dictionary per companion specification
+				PublishOptions options;
 				std::shared_ptr<const ModelOpcUa::SimpleNode> node;
+				/// node without the nodes of the rate groups, serialized on every publish
+				std::shared_ptr<const ModelOpcUa::Node> fastNode;
+				std::vector<RateGroup_t> rateGroups;
+				/// Nodes of fastNode copied by pruneNodes and the node they replace, values are stored for the latter
+				std::map<std::shared_ptr<const ModelOpcUa::Node>, std::shared_ptr<const ModelOpcUa::Node>> prunedCopies;
 				std::mutex values_mutex;
-				std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> values;
+				ValueMap_t values;
+				/// Set by the subscriptions, the document is only rebuilt if a value changed or it has to be resent
+				std::atomic_bool valuesChanged{true};
+				std::vector<Leaf_t> leaves;
+				/// Empty if the dataset is not published as Sparkplug B device
+				std::string sparkplugDevice;
+				std::vector<SparkplugMetric_t> sparkplugMetrics;
+				/// SparkplugNode::BirthGeneration of the last DBIRTH, 0 if the device is not born
+				std::uint64_t sparkplugBirth = 0;
+				/// Empty if the dataset is not published as UADP DataSetWriter
+				std::string uadpWriter;
+				std::uint16_t uadpWriterId = 0;
+				std::vector<UadpField_t> uadpFields;
+				Util::Uadp::DataSetMetaData_t uadpMetaData;
+				bool uadpMetaDataSent = false;
+				std::uint16_t uadpSequenceNumber = 0;
+				/// Delta frames since the last key frame
+				std::uint32_t uadpDeltaFrames = 0;
+				/// Online state last published on onlineChannel
+				bool online = false;
+				time_t onlineSent = 0;
 			};
 
-			static std::string getJson(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage);
+			static nlohmann::json getJson(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage,
+										  const std::shared_ptr<const ModelOpcUa::Node> &pNode);
+
+			void setupRateGroups(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage, const std::string &specification);
+
+			static void appendDocumentPath(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pParent,
+										   const std::shared_ptr<const ModelOpcUa::Node> &pChild,
+										   std::vector<std::string> &documentPath);
+
+			/// Returns pNode without the nodes in removedNodes, only the nodes on the way to them are copied and added to copies
+			static std::shared_ptr<const ModelOpcUa::Node> pruneNodes(
+				const std::shared_ptr<const ModelOpcUa::Node> &pNode,
+				const std::set<std::shared_ptr<const ModelOpcUa::Node>> &removedNodes,
+				std::map<std::shared_ptr<const ModelOpcUa::Node>, std::shared_ptr<const ModelOpcUa::Node>> &copies);
+
+			/// Serializes the due rate groups and publishes the ones with an own topic, if they changed.
+			/// Returns true if the document of a merged group changed.
+			bool updateRateGroups(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage, std::chrono::steady_clock::time_point now);
+
+			static void mergeDocument(nlohmann::json &target, const nlohmann::json &source);
+
+			/// Expects values_mutex of pDataSetStorage to be locked
+			static const NodeValue_t *findValue(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage,
+												const std::shared_ptr<const ModelOpcUa::Node> &pNode);
+
+			void collectLeaves(const std::shared_ptr<const ModelOpcUa::Node> &pNode,
+									  const std::string &topic,
+									  std::vector<Leaf_t> &leaves);
+
+			void publishLeaves(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage);
+
+			/// Only publishes changes, unless republish is set or the StatusRefreshInterval elapsed
+			void publishOnline(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage, bool online, time_t now, bool republish = false);
+
+			/// DBIRTH with all metrics if the device is not born in the current generation of the node, otherwise DDATA with the changed ones
+			void publishSparkplug(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage);
+
+			/// Metadata if the field types changed, then a key frame or a delta frame with the changed fields
+			void publishUadp(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage);
+
+			void publishDelta(const std::shared_ptr<DataSetStorage_t> &pDataSetStorage,
+							  nlohmann::json document,
+							  LastMessage_t &lastMessage,
+							  time_t now);
 
 			std::shared_ptr<const ModelOpcUa::SimpleNode> TransformToNodeIds(
 					ModelOpcUa::NodeId_t startNode,
@@ -82,37 +220,59 @@ namespace Umati {
 
 			void subscribeValues(
 					const std::shared_ptr<const ModelOpcUa::SimpleNode> pNode,
-					std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-					std::mutex &valueMap_mutex
+					ValueMap_t &valueMap,
+					std::mutex &valueMap_mutex,
+					std::atomic_bool &valuesChanged
 			);
 
 			std::vector<std::shared_ptr<Dashboard::IDashboardDataClient::ValueSubscriptionHandle>> m_subscribedValues;
 			std::shared_ptr<IDashboardDataClient> m_pDashboardDataClient;
 			std::shared_ptr<IPublisher> m_pPublisher;
 			std::shared_ptr<OpcUaTypeReader> m_pTypeReader;
+			Util::PublishConfig m_publishConfig;
+			/// Null if Sparkplug B is disabled
+			std::shared_ptr<SparkplugNode> m_pSparkplugNode;
+			/// Null if UADP is disabled
+			std::shared_ptr<UadpWriterGroup> m_pUadpWriterGroup;
+			/// Resolved from m_publishConfig.Encoding
+			Util::PayloadEncoding_t m_machineEncoding;
+			std::string m_machineTopicSuffix;
+			PublishOptions m_machineOptions;
+			std::string m_onlineTopicSuffix;
+			std::string m_onlinePayload;
+			std::string m_offlinePayload;
+			PublishOptions m_onlineOptions;
 
 			std::set<ModelOpcUa::NodeId_t> browsedNodes;
 			std::recursive_mutex m_dataSetMutex;
+			/// Set by PublishOffline, guarded by m_dataSetMutex
+			bool m_offline = false;
+			/// IPublisher::ConnectGeneration of the last Publish, guarded by m_dataSetMutex
+			std::uint64_t m_connectGeneration = 0;
 			std::list<std::shared_ptr<DataSetStorage_t>> m_dataSets;
 			std::map<std::string, LastMessage_t> m_latestMessages;
 
 			bool isMandatoryOrOptionalVariable(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode);
 
 			void handleSubscribeChildNodes(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode,
-										   std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-										   std::mutex &valueMap_mutex);
+										   ValueMap_t &valueMap,
+										   std::mutex &valueMap_mutex,
+										   std::atomic_bool &valuesChanged);
 
 			void handleSubscribePlaceholderChildNode(const std::shared_ptr<const ModelOpcUa::Node> &pChildNode,
-													 std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-													 std::mutex &valueMap_mutex);
+													 ValueMap_t &valueMap,
+													 std::mutex &valueMap_mutex,
+													 std::atomic_bool &valuesChanged);
 
 			void subscribeValue(const std::shared_ptr<const ModelOpcUa::SimpleNode> &pNode,
-								std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-								std::mutex &valueMap_mutex);
+								ValueMap_t &valueMap,
+								std::mutex &valueMap_mutex,
+								std::atomic_bool &valuesChanged);
 
 			void handleSubscribeChildNode(const std::shared_ptr<const ModelOpcUa::Node> &pChildNode,
-										  std::map<std::shared_ptr<const ModelOpcUa::Node>, nlohmann::json> &valueMap,
-										  std::mutex &valueMap_mutex);
+										  ValueMap_t &valueMap,
+										  std::mutex &valueMap_mutex,
+										  std::atomic_bool &valuesChanged);
 
 			void preparePlaceholderNodesTypeId(
 					const std::shared_ptr<const ModelOpcUa::StructurePlaceholderNode> &pStructurePlaceholder,
@@ -122,7 +282,9 @@ namespace Umati {
 			std::shared_ptr<DataSetStorage_t> prepareDataSetStorage(const ModelOpcUa::NodeId_t &startNodeId,
 																	const std::shared_ptr<ModelOpcUa::StructureNode> &pTypeDefinition,
 																	const std::string &channel,
-																	const std::string &onlineChannel);
+																	const std::string &onlineChannel,
+																	const std::string &deltaChannel,
+																	const std::string &machineId);
 
 			bool OptionalAndMandatoryTransformToNodeId(const ModelOpcUa::NodeId_t &startNode,
 													   std::list<std::shared_ptr<const ModelOpcUa::Node>> &foundChildNodes,
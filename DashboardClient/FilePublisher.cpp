@@ -0,0 +1,323 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "FilePublisher.hpp"
+
+#include <Iso8601.hpp>
+#include <easylogging++.h>
+
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Umati {
+namespace Dashboard {
+namespace {
+const char Magic[8] = {'U', 'M', 'A', 'T', 'I', 'R', 'E', 'C'};
+const std::uint8_t FlagRetain = 1;
+
+int openFileDescriptor(const std::string &path) {
+#ifdef _WIN32
+  return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+  return open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+}
+
+long writeFileDescriptor(int fd, const char *data, std::size_t size) {
+#ifdef _WIN32
+  return _write(fd, data, static_cast<unsigned int>(size));
+#else
+  return ::write(fd, data, size);
+#endif
+}
+
+void syncFileDescriptor(int fd) {
+#ifdef _WIN32
+  _commit(fd);
+#else
+  fsync(fd);
+#endif
+}
+
+void closeFileDescriptor(int fd) {
+#ifdef _WIN32
+  _close(fd);
+#else
+  ::close(fd);
+#endif
+}
+
+void appendLittleEndian(std::string &target, std::uint64_t value, std::size_t bytes) {
+  for (std::size_t i = 0; i < bytes; ++i) {
+    target.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+std::string base64(const std::string &data) {
+  static const char Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string encoded;
+  encoded.reserve((data.size() + 2) / 3 * 4);
+  std::size_t i = 0;
+  for (; i + 2 < data.size(); i += 3) {
+    std::uint32_t block = (static_cast<std::uint8_t>(data[i]) << 16) | (static_cast<std::uint8_t>(data[i + 1]) << 8) | static_cast<std::uint8_t>(data[i + 2]);
+    encoded.push_back(Alphabet[(block >> 18) & 0x3F]);
+    encoded.push_back(Alphabet[(block >> 12) & 0x3F]);
+    encoded.push_back(Alphabet[(block >> 6) & 0x3F]);
+    encoded.push_back(Alphabet[block & 0x3F]);
+  }
+  if (i < data.size()) {
+    std::uint32_t block = static_cast<std::uint8_t>(data[i]) << 16;
+    if (i + 1 < data.size()) {
+      block |= static_cast<std::uint8_t>(data[i + 1]) << 8;
+    }
+    encoded.push_back(Alphabet[(block >> 18) & 0x3F]);
+    encoded.push_back(Alphabet[(block >> 12) & 0x3F]);
+    encoded.push_back(i + 1 < data.size() ? Alphabet[(block >> 6) & 0x3F] : '=');
+    encoded.push_back('=');
+  }
+  return encoded;
+}
+
+std::string currentRunId() {
+  std::time_t time = std::time(nullptr);
+  std::tm utc{};
+#ifdef _WIN32
+  gmtime_s(&utc, &time);
+#else
+  gmtime_r(&time, &utc);
+#endif
+  std::stringstream ss;
+  ss << std::put_time(&utc, "%Y%m%dT%H%M%SZ");
+  return ss.str();
+}
+}  // namespace
+
+FilePublisher::FilePublisher(const Util::FileSinkConfig &config)
+  : m_config(config), m_binary(config.Format == "binary"), m_runId(currentRunId()) {
+  m_buffer.reserve(m_config.BufferSize);
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    openFile();
+  }
+  m_syncThread = std::thread(&FilePublisher::syncLoop, this);
+}
+
+FilePublisher::~FilePublisher() {
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    m_stopped = true;
+  }
+  m_cv.notify_all();
+  m_syncThread.join();
+  writeOut(true, true);
+}
+
+void FilePublisher::Publish(std::string channel, std::string message) { Publish(std::move(channel), std::move(message), PublishOptions()); }
+
+void FilePublisher::Publish(std::string channel, std::string message, const PublishOptions &options) {
+  std::string record = formatRecord(channel, message, options.Retain);
+
+  const std::uint64_t headerSize = m_binary ? sizeof(Magic) : 0;
+
+  bool write = false;
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    // A record larger than MaxFileSize still gets a file of its own
+    if (m_fd >= 0 && m_fileSize > headerSize && m_fileSize + record.size() > m_config.MaxFileSize) {
+      retireFile();
+    }
+    if (m_fd < 0) {
+      try {
+        openFile();
+      } catch (const std::exception &ex) {
+        LOG(ERROR) << "File sink dropped a message: " << ex.what();
+        return;
+      }
+    }
+    m_buffer.append(record);
+    m_fileSize += record.size();
+    m_dirty = true;
+    ++m_statistics.records;
+    m_statistics.bytes += record.size();
+    write = !m_retired.empty() || m_buffer.size() >= m_config.BufferSize;
+  }
+  if (write) {
+    writeOut(false, false);
+  }
+}
+
+void FilePublisher::Flush() { writeOut(true, false); }
+
+FilePublisher::Statistics_t FilePublisher::GetStatistics() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  return m_statistics;
+}
+
+std::vector<std::string> FilePublisher::GetFiles() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  return std::vector<std::string>(m_files.begin(), m_files.end());
+}
+
+std::string FilePublisher::formatRecord(const std::string &channel, const std::string &message, bool retain) const {
+  auto now = std::chrono::system_clock::now();
+  std::string record;
+  if (m_binary) {
+    record.reserve(17 + channel.size() + message.size());
+    appendLittleEndian(record, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count()), 8);
+    record.push_back(static_cast<char>(retain ? FlagRetain : 0));
+    appendLittleEndian(record, channel.size(), 4);
+    appendLittleEndian(record, message.size(), 4);
+    record.append(channel);
+    record.append(message);
+    return record;
+  }
+
+  record.reserve(64 + channel.size() + message.size());
+  record.append("{\"timestamp\":\"").append(Util::ToIso8601(now)).append("\",\"topic\":");
+  record.append(nlohmann::json(channel).dump());
+  record.append(retain ? ",\"retain\":true," : ",\"retain\":false,");
+  try {
+    record.append("\"payload\":" + nlohmann::json(message).dump());
+  } catch (const nlohmann::json::type_error &) {
+    // Payloads that are no valid UTF-8
+    record.append("\"payloadBase64\":\"" + base64(message) + "\"");
+  }
+  record.append("}\n");
+  return record;
+}
+
+void FilePublisher::openFile() {
+  std::stringstream ss;
+  ss << m_config.Directory << "/" << m_config.Prefix << "-" << m_runId << "-" << std::setw(6) << std::setfill('0') << ++m_fileIndex
+     << (m_binary ? ".bin" : ".ndjson");
+  std::string path = ss.str();
+  m_fd = openFileDescriptor(path);
+  if (m_fd < 0) {
+    throw std::runtime_error("Could not open " + path);
+  }
+  m_fileSize = 0;
+  ++m_statistics.files;
+  if (m_binary) {
+    m_buffer.append(Magic, sizeof(Magic));
+    m_fileSize = sizeof(Magic);
+  }
+
+  m_files.push_back(path);
+  while (m_config.MaxFiles != 0 && m_files.size() > m_config.MaxFiles) {
+    std::remove(m_files.front().c_str());
+    m_files.pop_front();
+  }
+}
+
+void FilePublisher::retireFile() {
+  Segment_t segment;
+  segment.fd = m_fd;
+  segment.path = m_files.back();
+  segment.data.swap(m_buffer);
+  segment.sync = m_dirty;
+  segment.close = true;
+  m_retired.push_back(std::move(segment));
+  m_buffer.reserve(m_config.BufferSize);
+  m_fd = -1;
+  m_dirty = false;
+}
+
+void FilePublisher::writeOut(bool syncFile, bool closeFile) {
+  std::lock_guard<std::mutex> fileLock(m_fileMutex);
+  std::vector<Segment_t> segments;
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    segments.swap(m_retired);
+    if (m_fd >= 0) {
+      Segment_t current;
+      current.fd = m_fd;
+      current.path = m_files.back();
+      current.data.swap(m_buffer);
+      current.sync = (syncFile || closeFile) && m_dirty;
+      current.close = closeFile;
+      segments.push_back(std::move(current));
+      m_buffer.reserve(m_config.BufferSize);
+      if (syncFile || closeFile) {
+        m_dirty = false;
+      }
+      if (closeFile) {
+        m_fd = -1;
+      }
+    }
+  }
+
+  // Neither the writes nor fsync hold m_mutex, so Publish only waits for them once the buffer is full
+  std::uint64_t writes = 0;
+  std::uint64_t syncs = 0;
+  for (auto &segment : segments) {
+    std::size_t written = 0;
+    while (written < segment.data.size()) {
+      auto result = writeFileDescriptor(segment.fd, segment.data.data() + written, segment.data.size() - written);
+      if (result <= 0) {
+        LOG(ERROR) << "File sink could not write " << segment.data.size() - written << " bytes to " << segment.path;
+        break;
+      }
+      written += static_cast<std::size_t>(result);
+      ++writes;
+    }
+    if (segment.sync) {
+      syncFileDescriptor(segment.fd);
+      ++syncs;
+    }
+    if (segment.close) {
+      closeFileDescriptor(segment.fd);
+    }
+  }
+
+  std::lock_guard<std::mutex> l(m_mutex);
+  m_statistics.writes += writes;
+  m_statistics.syncs += syncs;
+}
+
+void FilePublisher::syncLoop() {
+  auto interval = m_config.SyncInterval != 0 ? std::chrono::milliseconds(m_config.SyncInterval) : std::chrono::milliseconds(std::chrono::minutes(1));
+  auto lastStatistics = std::chrono::steady_clock::now();
+  Statistics_t lastTotals;
+
+  std::unique_lock<std::mutex> ul(m_mutex);
+  while (!m_stopped) {
+    m_cv.wait_for(ul, interval);
+    if (m_stopped) {
+      break;
+    }
+    if (m_config.SyncInterval != 0) {
+      ul.unlock();
+      writeOut(true, false);
+      ul.lock();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(now - lastStatistics).count();
+    if (elapsed >= 60) {
+      LOG(INFO) << "File sink: " << (m_statistics.records - lastTotals.records) / elapsed << " messages/s, "
+                << (m_statistics.bytes - lastTotals.bytes) / elapsed / (1024 * 1024) << " MiB/s, " << m_statistics.writes - lastTotals.writes
+                << " writes, " << m_statistics.syncs - lastTotals.syncs << " syncs";
+      lastStatistics = now;
+      lastTotals = m_statistics;
+    }
+  }
+}
+}  // namespace Dashboard
+}  // namespace Umati
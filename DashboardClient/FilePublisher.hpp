@@ -0,0 +1,109 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <Configuration.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IPublisher.hpp"
+
+namespace Umati {
+namespace Dashboard {
+/**
+ * Appends all messages to rotating local files, e.g. for air-gapped installations or to benchmark the client without a broker.
+ *
+ * Records are collected in a buffer and written with a single call once it is full or SyncInterval elapsed,
+ * the file is synced to disk after each interval instead of after each record.
+ *
+ * The "ndjson" format contains one object per line:
+ *   {"timestamp":"2023-06-01T12:00:00.123Z","topic":"...","retain":true,"payload":"..."}
+ * Payloads that are no valid UTF-8, e.g. CBOR or compressed documents, are stored as "payloadBase64" instead.
+ *
+ * The "binary" format starts with the magic "UMATIREC" followed by records of little endian fields:
+ *   int64 milliseconds since epoch, uint8 flags (bit 0: retain), uint32 topic length, uint32 payload length, topic, payload
+ */
+class FilePublisher : public IPublisher {
+ public:
+  struct Statistics_t {
+    std::uint64_t records = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t writes = 0;
+    std::uint64_t syncs = 0;
+    std::uint64_t files = 0;
+  };
+
+  explicit FilePublisher(const Util::FileSinkConfig &config);
+  /// Writes the buffer and syncs the file
+  ~FilePublisher() override;
+
+  FilePublisher(const FilePublisher &) = delete;
+  FilePublisher &operator=(const FilePublisher &) = delete;
+
+  void Publish(std::string channel, std::string message) override;
+
+  void Publish(std::string channel, std::string message, const PublishOptions &options) override;
+
+  /// Writes the buffer and syncs the file
+  void Flush();
+
+  /// Totals since the start
+  Statistics_t GetStatistics();
+
+  /// Paths of the kept files, the last one is currently written
+  std::vector<std::string> GetFiles();
+
+ private:
+  /// Buffered bytes of a file that are not written yet
+  struct Segment_t {
+    int fd = -1;
+    std::string path;
+    std::string data;
+    bool sync = false;
+    bool close = false;
+  };
+
+  std::string formatRecord(const std::string &channel, const std::string &message, bool retain) const;
+  /// Requires m_mutex
+  void openFile();
+  /// Hands the current file and its buffer to the next writeOut, requires m_mutex
+  void retireFile();
+  /// Takes the buffers under m_mutex and writes them outside of it, must not be called with m_mutex
+  void writeOut(bool syncFile, bool closeFile);
+  void syncLoop();
+
+  const Util::FileSinkConfig m_config;
+  const bool m_binary;
+  const std::string m_runId;
+
+  /// Serializes writeOut, so buffers reach the files in the order they were taken
+  std::mutex m_fileMutex;
+  std::mutex m_mutex;
+  std::string m_buffer;
+  /// Rotated files that still have to be written, synced and closed
+  std::vector<Segment_t> m_retired;
+  int m_fd = -1;
+  /// Bytes of the current file including the buffered ones
+  std::uint64_t m_fileSize = 0;
+  std::uint32_t m_fileIndex = 0;
+  std::deque<std::string> m_files;
+  Statistics_t m_statistics;
+  bool m_dirty = false;
+
+  bool m_stopped = false;
+  std::condition_variable m_cv;
+  std::thread m_syncThread;
+};
+}  // namespace Dashboard
+}  // namespace Umati
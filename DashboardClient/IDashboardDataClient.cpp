@@ -8,36 +8,55 @@
 
 #include "IDashboardDataClient.hpp"
 
+#include <map>
+
 namespace Umati {
 	namespace Dashboard {
 		IDashboardDataClient::ValueSubscriptionHandle::~ValueSubscriptionHandle() = default;
 
+		std::vector<std::list<ModelOpcUa::BrowseResult_t>> IDashboardDataClient::BrowseMultiple(
+			const std::vector<ModelOpcUa::NodeId_t> &startNodes,
+			BrowseContext_t browseContext)
+		{
+			std::vector<std::list<ModelOpcUa::BrowseResult_t>> ret;
+			ret.reserve(startNodes.size());
+			for (const auto &startNode : startNodes)
+			{
+				ret.push_back(this->Browse(startNode, browseContext));
+			}
+			return ret;
+		}
+
 		ModelOpcUa::ModellingRule_t IDashboardDataClient::BrowseModellingRule(ModelOpcUa::NodeId_t nodeId)
 		{
-			BrowseContext_t brContext;
+			return BrowseModellingRules({nodeId}).front();
+		}
+
+		std::vector<ModelOpcUa::ModellingRule_t> IDashboardDataClient::BrowseModellingRules(const std::vector<ModelOpcUa::NodeId_t> &nodeIds)
+		{
+			static const std::map<ModelOpcUa::NodeId_t, ModelOpcUa::ModellingRule_t> modellingRules{
+				{NodeId_ModellingRule_Mandatory, ModelOpcUa::Mandatory},
+				{NodeId_ModellingRule_Optional, ModelOpcUa::Optional},
+				{NodeId_ModellingRule_MandatoryPlaceholder, ModelOpcUa::MandatoryPlaceholder},
+				{NodeId_ModellingRule_OptionalPlaceholder, ModelOpcUa::OptionalPlaceholder}};
+			auto brContext = BrowseContext_t::WithReference(NodeId_HasModellingRule);
 			brContext.nodeClassMask = (std::uint32_t) BrowseContext_t::NodeClassMask::OBJECT;
-			auto browseResults = this->Browse(nodeId, brContext);
-			for(auto & browseResult : browseResults)
+			auto browseResults = this->BrowseMultiple(nodeIds, brContext);
+
+			std::vector<ModelOpcUa::ModellingRule_t> ret(nodeIds.size(), ModelOpcUa::ModellingRule_t::Optional);
+			for (std::size_t i = 0; i < browseResults.size() && i < ret.size(); ++i)
 			{
-				///\TODO Use NodeId!
-				if (browseResult.BrowseName.Name == "Mandatory")
-				{
-					return ModelOpcUa::Mandatory;
-				}
-				else if (browseResult.BrowseName.Name == "Optional")
-				{
-					return  ModelOpcUa::Optional;
-				}
-				else if (browseResult.BrowseName.Name == "MandatoryPlaceholder")
-				{
-					return  ModelOpcUa::MandatoryPlaceholder;
-				}
-				else if (browseResult.BrowseName.Name == "OptionalPlaceholder")
+				for (const auto &browseResult : browseResults[i])
 				{
-					return  ModelOpcUa::OptionalPlaceholder;
+					auto it = modellingRules.find(browseResult.NodeId);
+					if (it != modellingRules.end())
+					{
+						ret[i] = it->second;
+						break;
+					}
 				}
 			}
-			return ModelOpcUa::ModellingRule_t::Optional;
+			return ret;
 		}
 	}
 }
\ No newline at end of file
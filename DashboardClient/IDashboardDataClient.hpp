@@ -11,6 +11,9 @@
 #include <nlohmann/json.hpp>
 #include <ModelOpcUa/ModelDefinition.hpp>
 #include <functional>
+#include <chrono>
+#include <list>
+#include <vector>
 #include "NodeIdsWellKnown.hpp"
 
 namespace Umati
@@ -25,7 +28,8 @@ namespace Umati
         class IDashboardDataClient
         {
         public:
-            typedef std::function<void(nlohmann::json value)> newValueCallbackFunction_t;
+            /// sourceTimestamp falls back to the server timestamp or the time of reception if the server sends none
+            typedef std::function<void(nlohmann::json value, std::chrono::system_clock::time_point sourceTimestamp)> newValueCallbackFunction_t;
 
             virtual ~IDashboardDataClient() = default;
 
@@ -121,6 +125,16 @@ namespace Umati
                     return ret;
                 }
 
+                inline static BrowseContext_t SupertypeOf() {
+                    BrowseContext_t ret;
+                    ret.referenceTypeId = NodeId_HasSubtype;
+                    ret.browseDirection = BrowseDirection::BACKWARD;
+                    ret.nodeClassMask =
+                        (std::uint32_t)NodeClassMask::OBJECT_TYPE |
+                        (std::uint32_t)NodeClassMask::VARIABLE_TYPE;
+                    return ret;
+                }
+
                 inline static BrowseContext_t WithReference(
                     ModelOpcUa::NodeId_t referenceTypeId)
                 {
@@ -157,6 +171,13 @@ namespace Umati
                 ModelOpcUa::NodeId_t startNode,
                 BrowseContext_t browseContext) = 0;
 
+            /// Browses several nodes with the same context, the result at index i belongs to startNodes[i].
+            /// Clients should send as few requests as possible, the default implementation browses each node separately.
+            virtual std::vector<std::list<ModelOpcUa::BrowseResult_t>>
+            BrowseMultiple(
+                const std::vector<ModelOpcUa::NodeId_t> &startNodes,
+                BrowseContext_t browseContext);
+
             virtual bool
             isSameOrSubtype(
                 const ModelOpcUa::NodeId_t &expectedType,
@@ -190,6 +211,9 @@ namespace Umati
 
             ModelOpcUa::ModellingRule_t BrowseModellingRule(ModelOpcUa::NodeId_t nodeId);
 
+            /// Modelling rules of several nodes with a single BrowseMultiple, Optional if a node has none of the known modelling rules
+            std::vector<ModelOpcUa::ModellingRule_t> BrowseModellingRules(const std::vector<ModelOpcUa::NodeId_t> &nodeIds);
+
             virtual ModelOpcUa::NodeId_t TranslateBrowsePathToNodeId(
                 ModelOpcUa::NodeId_t startNode,
                 ModelOpcUa::QualifiedName_t browseName) = 0;
@@ -7,13 +7,56 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace Umati {
 	namespace Dashboard {
+		/// Additional information about a single message, publishers ignore what they can not express.
+		struct PublishOptions {
+			/// Keep the message as last known value for new subscribers
+			bool Retain = true;
+			/// MIME type of the payload, empty if unknown
+			std::string ContentType;
+			/// Large payloads of the same group share a trained compression dictionary, empty for none
+			std::string CompressionGroup;
+			/// Kind of topic for statistics, e.g. machine, delta, leaf, list or online
+			std::string TopicClass;
+			/// False for payloads with a fixed format, e.g. Sparkplug B, that consumers can not decompress
+			bool Compressible = true;
+			/// Part of a numbered sequence, e.g. Sparkplug B, that breaks if a single message is lost.
+			/// Such messages are not evicted by a full queue in favor of others and never stored for a later replay.
+			bool Sequenced = false;
+			/// Metadata sent along with the message, e.g. as MQTT v5 user properties
+			std::vector<std::pair<std::string, std::string>> UserProperties;
+		};
+
 		class IPublisher {
 		public:
+			virtual ~IPublisher() = default;
+
 			virtual void Publish(std::string channel, std::string message) = 0;
+
+			virtual void Publish(std::string channel, std::string message, const PublishOptions & /*options*/) {
+				Publish(std::move(channel), std::move(message));
+			}
+
+			/// Returns true once if a not retained message of channel was dropped since the last call, the full state has to be sent again
+			virtual bool TakeDropped(const std::string & /*channel*/) {
+				return false;
+			}
+
+			/// Number of messages dropped since the start, e.g. because a queue was full
+			virtual std::uint64_t DroppedMessages() {
+				return 0;
+			}
+
+			/// Changes with each connect to a broker, retained messages have to be published again then, as the broker might have lost them
+			virtual std::uint64_t ConnectGeneration() {
+				return 0;
+			}
 		};
 	}
 }
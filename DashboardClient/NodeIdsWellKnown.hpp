@@ -18,6 +18,13 @@ namespace Umati
         const ModelOpcUa::NodeId_t NodeId_HasTypeDefinition = {ns0Uri, "i=40"};
         const ModelOpcUa::NodeId_t NodeId_HasInterface = {ns0Uri, "i=17603"};
         const ModelOpcUa::NodeId_t NodeId_Organizes = {ns0Uri, "i=35"};
+        const ModelOpcUa::NodeId_t NodeId_HasProperty = {ns0Uri, "i=46"};
+        const ModelOpcUa::NodeId_t NodeId_HasSubtype = {ns0Uri, "i=45"};
+        const ModelOpcUa::NodeId_t NodeId_HasModellingRule = {ns0Uri, "i=37"};
+        const ModelOpcUa::NodeId_t NodeId_ModellingRule_Mandatory = {ns0Uri, "i=78"};
+        const ModelOpcUa::NodeId_t NodeId_ModellingRule_Optional = {ns0Uri, "i=80"};
+        const ModelOpcUa::NodeId_t NodeId_ModellingRule_OptionalPlaceholder = {ns0Uri, "i=11508"};
+        const ModelOpcUa::NodeId_t NodeId_ModellingRule_MandatoryPlaceholder = {ns0Uri, "i=11510"};
         const ModelOpcUa::NodeId_t NodeId_BaseVariableType = {ns0Uri, "i=63"};
         const ModelOpcUa::NodeId_t NodeId_BaseDataType {ns0Uri, "i=24"};
         const ModelOpcUa::NodeId_t NodeId_Structure {ns0Uri, "i=22"};
@@ -30,6 +37,7 @@ namespace Umati
         const ModelOpcUa::NodeId_t NodeId_Folder = {ns0Uri, "i=61"};
         const ModelOpcUa::NodeId_t NodeId_UndefinedType = {ns0Uri, "i=0"};
         const ModelOpcUa::NodeId_t NodeId_MissingType = {"", "i=0"};
+        const ModelOpcUa::NodeId_t NodeId_Server_Namespaces = {ns0Uri, "i=11715"};
         const std::string nsUriMachinery = "http://opcfoundation.org/UA/Machinery/";
         const ModelOpcUa::NodeId_t NodeId_MachinesFolder = {nsUriMachinery, "i=1001"};
         const ModelOpcUa::NodeId_t NodeId_Machinery_MachineIdentificationType = {nsUriMachinery, "i=1012"};
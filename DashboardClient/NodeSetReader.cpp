@@ -0,0 +1,281 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "NodeSetReader.hpp"
+
+#include <tinyxml2.h>
+
+#include <cstring>
+#include <stdexcept>
+
+#include "NodeIdsWellKnown.hpp"
+
+namespace Umati {
+namespace Dashboard {
+namespace {
+const ModelOpcUa::NodeId_t NodeId_References = {ns0Uri, "i=31"};
+
+/// Reference types of namespace 0 with their supertype, used if no file defines them
+const std::map<std::string, std::pair<std::string, std::string>> &ns0ReferenceTypes() {
+  static const std::map<std::string, std::pair<std::string, std::string>> referenceTypes{
+    {"HierarchicalReferences", {"i=33", "i=31"}},
+    {"NonHierarchicalReferences", {"i=32", "i=31"}},
+    {"HasChild", {"i=34", "i=33"}},
+    {"Organizes", {"i=35", "i=33"}},
+    {"HasEventSource", {"i=36", "i=33"}},
+    {"HasModellingRule", {"i=37", "i=32"}},
+    {"HasEncoding", {"i=38", "i=32"}},
+    {"HasDescription", {"i=39", "i=32"}},
+    {"HasTypeDefinition", {"i=40", "i=32"}},
+    {"GeneratesEvent", {"i=41", "i=32"}},
+    {"Aggregates", {"i=44", "i=34"}},
+    {"HasSubtype", {"i=45", "i=34"}},
+    {"HasProperty", {"i=46", "i=44"}},
+    {"HasComponent", {"i=47", "i=44"}},
+    {"HasNotifier", {"i=48", "i=36"}},
+    {"HasOrderedComponent", {"i=49", "i=47"}},
+    {"HasInterface", {"i=17603", "i=32"}},
+    {"HasAddIn", {"i=17604", "i=44"}}};
+  return referenceTypes;
+}
+
+struct FileContext_t {
+  /// Index in the file to namespace URI, index 0 is namespace 0
+  std::vector<std::string> NamespaceUris{ns0Uri};
+  std::map<std::string, std::string> Aliases;
+};
+
+std::string trim(const char *text) {
+  std::string ret = text == nullptr ? std::string() : std::string(text);
+  auto begin = ret.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) {
+    return std::string();
+  }
+  return ret.substr(begin, ret.find_last_not_of(" \t\r\n") - begin + 1);
+}
+
+ModelOpcUa::NodeId_t parseNodeId(const std::string &text, const FileContext_t &context) {
+  if (text.compare(0, 4, "nsu=") == 0) {
+    auto separator = text.find(';');
+    if (separator == std::string::npos) {
+      throw std::runtime_error("Invalid NodeId " + text);
+    }
+    return ModelOpcUa::NodeId_t{text.substr(4, separator - 4), text.substr(separator + 1)};
+  }
+  if (text.compare(0, 3, "ns=") == 0) {
+    auto separator = text.find(';');
+    std::size_t namespaceIndex = 0;
+    try {
+      namespaceIndex = std::stoul(text.substr(3, separator - 3));
+    } catch (const std::exception &) {
+      throw std::runtime_error("Invalid NodeId " + text);
+    }
+    if (separator == std::string::npos || namespaceIndex >= context.NamespaceUris.size()) {
+      throw std::runtime_error("Invalid NodeId " + text);
+    }
+    return ModelOpcUa::NodeId_t{context.NamespaceUris[namespaceIndex], text.substr(separator + 1)};
+  }
+  return ModelOpcUa::NodeId_t{ns0Uri, text};
+}
+
+ModelOpcUa::NodeId_t parseReferenceType(const std::string &text, const FileContext_t &context) {
+  auto alias = context.Aliases.find(text);
+  if (alias != context.Aliases.end()) {
+    return parseNodeId(alias->second, context);
+  }
+  auto referenceType = ns0ReferenceTypes().find(text);
+  if (referenceType != ns0ReferenceTypes().end()) {
+    return ModelOpcUa::NodeId_t{ns0Uri, referenceType->second.first};
+  }
+  return parseNodeId(text, context);
+}
+
+ModelOpcUa::QualifiedName_t parseBrowseName(const std::string &text, const FileContext_t &context) {
+  auto separator = text.find(':');
+  if (separator == std::string::npos || separator == 0 || text.find_first_not_of("0123456789") != separator) {
+    return ModelOpcUa::QualifiedName_t{ns0Uri, text};
+  }
+  std::size_t namespaceIndex = std::stoul(text.substr(0, separator));
+  if (namespaceIndex >= context.NamespaceUris.size()) {
+    throw std::runtime_error("Invalid BrowseName " + text);
+  }
+  return ModelOpcUa::QualifiedName_t{context.NamespaceUris[namespaceIndex], text.substr(separator + 1)};
+}
+
+const char *attribute(const tinyxml2::XMLElement *element, const char *name) {
+  const char *value = element->Attribute(name);
+  return value == nullptr ? "" : value;
+}
+}  // namespace
+
+void NodeSetReader::Load(const std::string &path) {
+  static const std::map<std::string, ModelOpcUa::NodeClass_t> nodeClasses{
+    {"UAObject", ModelOpcUa::Object},
+    {"UAVariable", ModelOpcUa::Variable},
+    {"UAObjectType", ModelOpcUa::ObjectType},
+    {"UAVariableType", ModelOpcUa::VariableType}};
+
+  tinyxml2::XMLDocument document;
+  if (document.LoadFile(path.c_str()) != tinyxml2::XML_SUCCESS) {
+    throw std::runtime_error("Could not read NodeSet " + path + ": " + document.ErrorStr());
+  }
+  const tinyxml2::XMLElement *nodeSet = document.RootElement();
+  if (nodeSet == nullptr || std::strcmp(nodeSet->Name(), "UANodeSet") != 0) {
+    throw std::runtime_error(path + " is not a NodeSet2 file");
+  }
+
+  FileContext_t context;
+  if (auto namespaceUris = nodeSet->FirstChildElement("NamespaceUris")) {
+    for (auto uri = namespaceUris->FirstChildElement("Uri"); uri != nullptr; uri = uri->NextSiblingElement("Uri")) {
+      context.NamespaceUris.push_back(trim(uri->GetText()));
+    }
+  }
+  if (auto aliases = nodeSet->FirstChildElement("Aliases")) {
+    for (auto alias = aliases->FirstChildElement("Alias"); alias != nullptr; alias = alias->NextSiblingElement("Alias")) {
+      context.Aliases[attribute(alias, "Alias")] = trim(alias->GetText());
+    }
+  }
+  if (auto models = nodeSet->FirstChildElement("Models")) {
+    for (auto model = models->FirstChildElement("Model"); model != nullptr; model = model->NextSiblingElement("Model")) {
+      m_models.push_back(Model_t{attribute(model, "ModelUri"), attribute(model, "Version"), attribute(model, "PublicationDate")});
+    }
+  }
+
+  for (auto element = nodeSet->FirstChildElement(); element != nullptr; element = element->NextSiblingElement()) {
+    const std::string elementName = element->Name();
+    if (elementName.compare(0, 2, "UA") != 0) {
+      continue;
+    }
+    auto nodeId = parseNodeId(trim(element->Attribute("NodeId")), context);
+    auto nodeClass = nodeClasses.find(elementName);
+    if (nodeClass != nodeClasses.end()) {
+      m_nodes[nodeId] = Node_t{nodeClass->second, parseBrowseName(attribute(element, "BrowseName"), context)};
+    }
+
+    auto references = element->FirstChildElement("References");
+    if (references == nullptr) {
+      continue;
+    }
+    for (auto reference = references->FirstChildElement("Reference"); reference != nullptr; reference = reference->NextSiblingElement("Reference")) {
+      auto referenceType = parseReferenceType(attribute(reference, "ReferenceType"), context);
+      auto other = parseNodeId(trim(reference->GetText()), context);
+      const bool isForward = std::strcmp(attribute(reference, "IsForward"), "false") != 0;
+      const auto &source = isForward ? nodeId : other;
+      const auto &target = isForward ? other : nodeId;
+      if (elementName == "UAReferenceType" && referenceType == NodeId_HasSubtype && !isForward) {
+        m_referenceSuperTypes[nodeId] = other;
+      }
+      if (m_knownReferences.insert(std::make_tuple(source, referenceType, target)).second) {
+        m_references[source].push_back(Reference_t{referenceType, target});
+      }
+    }
+  }
+}
+
+void NodeSetReader::RemoveNamespace(const std::string &namespaceUri) {
+  for (auto it = m_nodes.begin(); it != m_nodes.end();) {
+    it = it->first.Uri == namespaceUri ? m_nodes.erase(it) : std::next(it);
+  }
+  for (auto it = m_references.begin(); it != m_references.end();) {
+    it = it->first.Uri == namespaceUri ? m_references.erase(it) : std::next(it);
+  }
+  for (auto it = m_knownReferences.begin(); it != m_knownReferences.end();) {
+    it = std::get<0>(*it).Uri == namespaceUri ? m_knownReferences.erase(it) : std::next(it);
+  }
+  for (auto it = m_models.begin(); it != m_models.end();) {
+    it = it->ModelUri == namespaceUri ? m_models.erase(it) : std::next(it);
+  }
+}
+
+bool NodeSetReader::IsType(const ModelOpcUa::NodeId_t &nodeId) const {
+  auto node = m_nodes.find(nodeId);
+  return node != m_nodes.end() && (node->second.NodeClass == ModelOpcUa::ObjectType || node->second.NodeClass == ModelOpcUa::VariableType);
+}
+
+std::list<ModelOpcUa::BrowseResult_t> NodeSetReader::Browse(
+  const ModelOpcUa::NodeId_t &nodeId, const ModelOpcUa::NodeId_t &referenceTypeId, std::uint32_t nodeClassMask) const {
+  std::list<ModelOpcUa::BrowseResult_t> ret;
+  auto references = m_references.find(nodeId);
+  if (references == m_references.end()) {
+    return ret;
+  }
+  for (const auto &reference : references->second) {
+    auto targetNode = m_nodes.find(reference.Target);
+    if (targetNode == m_nodes.end() || (nodeClassMask != 0 && (nodeClassMask & targetNode->second.NodeClass) == 0) ||
+        !isSubtypeOf(reference.ReferenceType, referenceTypeId)) {
+      continue;
+    }
+    ModelOpcUa::BrowseResult_t browseResult;
+    browseResult.NodeClass = targetNode->second.NodeClass;
+    browseResult.NodeId = reference.Target;
+    browseResult.TypeDefinition = target(reference.Target, NodeId_HasTypeDefinition);
+    if (browseResult.TypeDefinition.isNull()) {
+      browseResult.TypeDefinition = NodeId_UndefinedType;
+    }
+    browseResult.ReferenceTypeId = reference.ReferenceType;
+    browseResult.BrowseName = targetNode->second.BrowseName;
+    ret.push_back(browseResult);
+  }
+  return ret;
+}
+
+ModelOpcUa::ModellingRule_t NodeSetReader::ModellingRule(const ModelOpcUa::NodeId_t &nodeId) const {
+  static const std::map<ModelOpcUa::NodeId_t, ModelOpcUa::ModellingRule_t> modellingRules{
+    {NodeId_ModellingRule_Mandatory, ModelOpcUa::Mandatory},
+    {NodeId_ModellingRule_Optional, ModelOpcUa::Optional},
+    {NodeId_ModellingRule_MandatoryPlaceholder, ModelOpcUa::MandatoryPlaceholder},
+    {NodeId_ModellingRule_OptionalPlaceholder, ModelOpcUa::OptionalPlaceholder}};
+  auto modellingRule = modellingRules.find(target(nodeId, NodeId_HasModellingRule));
+  return modellingRule == modellingRules.end() ? ModelOpcUa::Optional : modellingRule->second;
+}
+
+bool NodeSetReader::isSubtypeOf(const ModelOpcUa::NodeId_t &referenceType, const ModelOpcUa::NodeId_t &superType) const {
+  auto current = referenceType;
+  // Bounded, in case a file contains a cycle
+  for (std::size_t depth = 0; depth < 32; ++depth) {
+    if (current == superType) {
+      return true;
+    }
+    if (current == NodeId_References) {
+      return false;
+    }
+    auto parent = m_referenceSuperTypes.find(current);
+    if (parent != m_referenceSuperTypes.end()) {
+      current = parent->second;
+      continue;
+    }
+    if (current.Uri != ns0Uri) {
+      return false;
+    }
+    bool found = false;
+    for (const auto &ns0ReferenceType : ns0ReferenceTypes()) {
+      if (ns0ReferenceType.second.first == current.Id) {
+        current = ModelOpcUa::NodeId_t{ns0Uri, ns0ReferenceType.second.second};
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      return false;
+    }
+  }
+  return false;
+}
+
+ModelOpcUa::NodeId_t NodeSetReader::target(const ModelOpcUa::NodeId_t &nodeId, const ModelOpcUa::NodeId_t &referenceType) const {
+  auto references = m_references.find(nodeId);
+  if (references != m_references.end()) {
+    for (const auto &reference : references->second) {
+      if (reference.ReferenceType == referenceType) {
+        return reference.Target;
+      }
+    }
+  }
+  return ModelOpcUa::NodeId_t();
+}
+}  // namespace Dashboard
+}  // namespace Umati
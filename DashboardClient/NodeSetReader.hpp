@@ -0,0 +1,79 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <ModelOpcUa/ModelDefinition.hpp>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace Umati {
+namespace Dashboard {
+/**
+ * Objects, variables and their types from NodeSet2 XML files, answers the browse requests OpcUaTypeReader otherwise sends to the server.
+ *
+ * References are collected from both of their ends, so a reference only declared on a node of another file is found as well.
+ */
+class NodeSetReader {
+ public:
+  struct Model_t {
+    std::string ModelUri;
+    std::string Version;
+    std::string PublicationDate;
+  };
+
+  /// Adds the nodes of a file, throws std::runtime_error if it can not be read
+  void Load(const std::string &path);
+
+  const std::vector<Model_t> &Models() const { return m_models; }
+
+  /// Removes all nodes of the namespace, e.g. if the server uses another version of it
+  void RemoveNamespace(const std::string &namespaceUri);
+
+  /// True if the node is an object, variable, object type or variable type of a loaded file
+  bool Contains(const ModelOpcUa::NodeId_t &nodeId) const { return m_nodes.count(nodeId) != 0; }
+
+  bool IsType(const ModelOpcUa::NodeId_t &nodeId) const;
+
+  /// Forward references of referenceTypeId or its subtypes to nodes matching the mask of IDashboardDataClient::BrowseContext_t::NodeClassMask
+  std::list<ModelOpcUa::BrowseResult_t> Browse(
+    const ModelOpcUa::NodeId_t &nodeId, const ModelOpcUa::NodeId_t &referenceTypeId, std::uint32_t nodeClassMask) const;
+
+  /// Optional if the node has none of the known modelling rules, like IDashboardDataClient::BrowseModellingRules
+  ModelOpcUa::ModellingRule_t ModellingRule(const ModelOpcUa::NodeId_t &nodeId) const;
+
+ private:
+  struct Node_t {
+    ModelOpcUa::NodeClass_t NodeClass;
+    ModelOpcUa::QualifiedName_t BrowseName;
+  };
+
+  struct Reference_t {
+    ModelOpcUa::NodeId_t ReferenceType;
+    ModelOpcUa::NodeId_t Target;
+  };
+
+  bool isSubtypeOf(const ModelOpcUa::NodeId_t &referenceType, const ModelOpcUa::NodeId_t &superType) const;
+  /// Target of the first forward reference of this type, a null NodeId if there is none
+  ModelOpcUa::NodeId_t target(const ModelOpcUa::NodeId_t &nodeId, const ModelOpcUa::NodeId_t &referenceType) const;
+
+  std::vector<Model_t> m_models;
+  std::map<ModelOpcUa::NodeId_t, Node_t> m_nodes;
+  /// Forward references by source node, in the order of the files
+  std::map<ModelOpcUa::NodeId_t, std::vector<Reference_t>> m_references;
+  /// Source, reference type and target of all entries in m_references
+  std::set<std::tuple<ModelOpcUa::NodeId_t, ModelOpcUa::NodeId_t, ModelOpcUa::NodeId_t>> m_knownReferences;
+  /// Supertype of each reference type defined in a file or in namespace 0
+  std::map<ModelOpcUa::NodeId_t, ModelOpcUa::NodeId_t> m_referenceSuperTypes;
+};
+}  // namespace Dashboard
+}  // namespace Umati
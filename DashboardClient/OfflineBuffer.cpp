@@ -0,0 +1,387 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "OfflineBuffer.hpp"
+
+#include <easylogging++.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Umati {
+namespace Dashboard {
+namespace {
+const char Magic[8] = {'U', 'M', 'A', 'T', 'I', 'S', 'F', 'B'};
+const std::uint32_t Version = 2;
+/// The ring starts after the header
+const std::uint64_t DataOffset = 64;
+const std::uint64_t MinCapacity = 4096;
+const std::uint32_t FlagRetain = 1;
+const std::uint32_t FlagSuperseded = 2;
+
+void appendString(std::string &buffer, const std::string &value) {
+  std::uint32_t length = static_cast<std::uint32_t>(value.size());
+  buffer.append(reinterpret_cast<const char *>(&length), sizeof(length));
+  buffer.append(value);
+}
+
+bool readString(const char *&pos, const char *end, std::string &value) {
+  std::uint32_t length;
+  if (static_cast<std::size_t>(end - pos) < sizeof(length)) {
+    return false;
+  }
+  std::memcpy(&length, pos, sizeof(length));
+  pos += sizeof(length);
+  if (static_cast<std::size_t>(end - pos) < length) {
+    return false;
+  }
+  value.assign(pos, length);
+  pos += length;
+  return true;
+}
+}  // namespace
+
+struct OfflineBuffer::Header_t {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t reserved;
+  std::uint64_t capacity;
+  /// Offset the next record is written to
+  std::uint64_t head;
+  /// Offset of the oldest record
+  std::uint64_t tail;
+  std::uint64_t count;
+  std::uint64_t nextSequence;
+};
+
+/// Followed by channel, options and message, a size of 0 marks the unused end of the ring
+struct OfflineBuffer::RecordHeader_t {
+  std::uint32_t size;
+  std::uint32_t channelLength;
+  std::uint32_t messageLength;
+  std::uint32_t flags;
+  /// ContentType and UserProperties as length prefixed strings
+  std::uint32_t optionsLength;
+  std::uint32_t reserved;
+  std::int64_t timestamp;
+  std::uint64_t sequence;
+};
+
+class OfflineBuffer::MappedFile {
+ public:
+  MappedFile(const std::string &path, std::uint64_t size) : m_size(size) {
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+      throw std::runtime_error("Could not open " + path);
+    }
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(m_file, &fileSize) && static_cast<std::uint64_t>(fileSize.QuadPart) > size) {
+      // A buffer with a different capacity is reinitialized anyway
+      fileSize.QuadPart = static_cast<LONGLONG>(size);
+      SetFilePointerEx(m_file, fileSize, nullptr, FILE_BEGIN);
+      SetEndOfFile(m_file);
+    }
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+    if (m_mapping == nullptr) {
+      CloseHandle(m_file);
+      throw std::runtime_error("Could not map " + path);
+    }
+    m_data = MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(size));
+    if (m_data == nullptr) {
+      CloseHandle(m_mapping);
+      CloseHandle(m_file);
+      throw std::runtime_error("Could not map " + path);
+    }
+#else
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_fd < 0) {
+      throw std::runtime_error("Could not open " + path);
+    }
+    struct stat fileStat;
+    if (fstat(m_fd, &fileStat) != 0 || (static_cast<std::uint64_t>(fileStat.st_size) != size && ftruncate(m_fd, static_cast<off_t>(size)) != 0)) {
+      close(m_fd);
+      throw std::runtime_error("Could not resize " + path);
+    }
+    m_data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (m_data == MAP_FAILED) {
+      close(m_fd);
+      throw std::runtime_error("Could not map " + path);
+    }
+#endif
+  }
+
+  ~MappedFile() {
+#ifdef _WIN32
+    FlushViewOfFile(m_data, 0);
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+#else
+    msync(m_data, m_size, MS_SYNC);
+    munmap(m_data, m_size);
+    close(m_fd);
+#endif
+  }
+
+  char *Data() { return static_cast<char *>(m_data); }
+
+ private:
+  std::uint64_t m_size;
+  void *m_data = nullptr;
+#ifdef _WIN32
+  HANDLE m_file = INVALID_HANDLE_VALUE;
+  HANDLE m_mapping = nullptr;
+#else
+  int m_fd = -1;
+#endif
+};
+
+OfflineBuffer::OfflineBuffer(const std::string &path, std::uint64_t capacity, bool history) : m_history(history) {
+  static_assert(sizeof(Header_t) <= DataOffset, "Header must fit in front of the ring");
+  static_assert(sizeof(RecordHeader_t) % 8 == 0, "Records must stay 8 byte aligned");
+  capacity = std::max(capacity / 8 * 8, MinCapacity);
+  m_file.reset(new MappedFile(path, DataOffset + capacity));
+  m_header = reinterpret_cast<Header_t *>(m_file->Data());
+  m_data = m_file->Data() + DataOffset;
+
+  bool valid = std::memcmp(m_header->magic, Magic, sizeof(Magic)) == 0 && m_header->version == Version && m_header->capacity == capacity &&
+               m_header->head <= capacity && m_header->tail <= capacity && m_header->head % 8 == 0 && m_header->tail % 8 == 0;
+  if (!valid) {
+    std::memset(m_file->Data(), 0, DataOffset);
+    std::memcpy(m_header->magic, Magic, sizeof(Magic));
+    m_header->version = Version;
+    m_header->capacity = capacity;
+    m_header->nextSequence = 1;
+    return;
+  }
+  rebuildIndex();
+  if (m_header->count > 0) {
+    LOG(INFO) << "Offline buffer " << path << " contains " << m_header->count << " messages from a previous run";
+  }
+}
+
+OfflineBuffer::~OfflineBuffer() = default;
+
+std::uint64_t OfflineBuffer::recordSize(std::size_t channelLength, std::size_t optionsLength, std::size_t messageLength) {
+  return (sizeof(RecordHeader_t) + channelLength + optionsLength + messageLength + 7) / 8 * 8;
+}
+
+void OfflineBuffer::encodeOptions(const PublishOptions &options) {
+  m_options.clear();
+  if (options.ContentType.empty() && options.UserProperties.empty()) {
+    return;
+  }
+  appendString(m_options, options.ContentType);
+  for (const auto &userProperty : options.UserProperties) {
+    appendString(m_options, userProperty.first);
+    appendString(m_options, userProperty.second);
+  }
+}
+
+OfflineBuffer::RecordHeader_t *OfflineBuffer::recordAt(std::uint64_t offset) { return reinterpret_cast<RecordHeader_t *>(m_data + offset); }
+
+void OfflineBuffer::normalizeTail() {
+  if (m_header->tail == m_header->capacity || recordAt(m_header->tail)->size == 0) {
+    m_header->tail = 0;
+  }
+}
+
+void OfflineBuffer::evictOldest() {
+  normalizeTail();
+  auto pRecord = recordAt(m_header->tail);
+  if ((pRecord->flags & FlagSuperseded) == 0) {
+    if (!m_history && (pRecord->flags & FlagRetain) != 0) {
+      m_key.assign(reinterpret_cast<const char *>(pRecord + 1), pRecord->channelLength);
+      m_latest.erase(m_key);
+    }
+    ++m_statistics.dropped;
+  }
+  m_header->tail += pRecord->size;
+  --m_header->count;
+}
+
+void OfflineBuffer::rebuildIndex() {
+  const auto capacity = m_header->capacity;
+  auto offset = m_header->tail;
+  for (std::uint64_t i = 0; i < m_header->count; ++i) {
+    if (offset == capacity || recordAt(offset)->size == 0) {
+      offset = 0;
+    }
+    auto pRecord = recordAt(offset);
+    if (pRecord->size < sizeof(RecordHeader_t) || offset + pRecord->size > capacity ||
+        recordSize(pRecord->channelLength, pRecord->optionsLength, pRecord->messageLength) != pRecord->size) {
+      LOG(WARNING) << "Offline buffer is corrupted, discarding its content";
+      m_latest.clear();
+      m_header->count = 0;
+      m_header->head = m_header->tail = 0;
+      return;
+    }
+    if (!m_history && (pRecord->flags & FlagRetain) != 0 && (pRecord->flags & FlagSuperseded) == 0) {
+      std::string channel(reinterpret_cast<const char *>(pRecord + 1), pRecord->channelLength);
+      auto it = m_latest.find(channel);
+      if (it != m_latest.end()) {
+        recordAt(it->second)->flags |= FlagSuperseded;
+        it->second = offset;
+      } else {
+        m_latest.emplace(std::move(channel), offset);
+      }
+    }
+    offset += pRecord->size;
+  }
+}
+
+bool OfflineBuffer::Append(const std::string &channel, const std::string &message, bool retain) {
+  PublishOptions options;
+  options.Retain = retain;
+  return Append(channel, message, options);
+}
+
+bool OfflineBuffer::Append(const std::string &channel, const std::string &message, const PublishOptions &options) {
+  const bool retain = options.Retain;
+  if (!retain && !m_history) {
+    return false;
+  }
+  std::lock_guard<std::mutex> l(m_mutex);
+  auto &header = *m_header;
+  encodeOptions(options);
+  const auto size = recordSize(channel.size(), m_options.size(), message.size());
+  if (size > header.capacity) {
+    ++m_statistics.dropped;
+    return false;
+  }
+
+  // Make room for a contiguous record at head, either at the end of the ring or in front of tail
+  while (true) {
+    if (header.count == 0) {
+      header.head = header.tail = 0;
+    }
+    if (header.count == 0 || header.head > header.tail) {
+      if (header.capacity - header.head >= size) {
+        break;
+      }
+      if (header.head < header.capacity) {
+        recordAt(header.head)->size = 0;
+      }
+      header.head = 0;
+      continue;
+    }
+    if (header.tail - header.head >= size) {
+      break;
+    }
+    evictOldest();
+  }
+
+  const auto offset = header.head;
+  auto pRecord = recordAt(offset);
+  pRecord->size = static_cast<std::uint32_t>(size);
+  pRecord->channelLength = static_cast<std::uint32_t>(channel.size());
+  pRecord->messageLength = static_cast<std::uint32_t>(message.size());
+  pRecord->flags = retain ? FlagRetain : 0;
+  pRecord->optionsLength = static_cast<std::uint32_t>(m_options.size());
+  pRecord->reserved = 0;
+  pRecord->timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  pRecord->sequence = header.nextSequence++;
+  auto pContent = reinterpret_cast<char *>(pRecord + 1);
+  std::memcpy(pContent, channel.data(), channel.size());
+  std::memcpy(pContent + channel.size(), m_options.data(), m_options.size());
+  std::memcpy(pContent + channel.size() + m_options.size(), message.data(), message.size());
+  header.head += size;
+  ++header.count;
+  ++m_statistics.stored;
+
+  if (!m_history) {
+    auto it = m_latest.find(channel);
+    if (it != m_latest.end()) {
+      recordAt(it->second)->flags |= FlagSuperseded;
+      ++m_statistics.superseded;
+      it->second = offset;
+    } else {
+      m_latest.emplace(channel, offset);
+    }
+  }
+  return true;
+}
+
+bool OfflineBuffer::Empty() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  return m_header->count == 0;
+}
+
+bool OfflineBuffer::Peek(Record_t &record) {
+  std::lock_guard<std::mutex> l(m_mutex);
+  while (m_header->count > 0) {
+    normalizeTail();
+    auto pRecord = recordAt(m_header->tail);
+    if ((pRecord->flags & FlagSuperseded) != 0) {
+      m_header->tail += pRecord->size;
+      --m_header->count;
+      continue;
+    }
+    auto pContent = reinterpret_cast<const char *>(pRecord + 1);
+    record.channel.assign(pContent, pRecord->channelLength);
+    record.message.assign(pContent + pRecord->channelLength + pRecord->optionsLength, pRecord->messageLength);
+    record.options = PublishOptions();
+    record.options.Retain = (pRecord->flags & FlagRetain) != 0;
+    if (pRecord->optionsLength > 0) {
+      const char *pos = pContent + pRecord->channelLength;
+      const char *end = pos + pRecord->optionsLength;
+      readString(pos, end, record.options.ContentType);
+      std::pair<std::string, std::string> userProperty;
+      while (readString(pos, end, userProperty.first) && readString(pos, end, userProperty.second)) {
+        record.options.UserProperties.push_back(userProperty);
+      }
+    }
+    record.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(pRecord->timestamp));
+    record.sequence = pRecord->sequence;
+    return true;
+  }
+  return false;
+}
+
+void OfflineBuffer::Pop(std::uint64_t sequence) {
+  std::lock_guard<std::mutex> l(m_mutex);
+  if (m_header->count == 0) {
+    return;
+  }
+  normalizeTail();
+  auto pRecord = recordAt(m_header->tail);
+  if (pRecord->sequence != sequence) {
+    return;
+  }
+  if (!m_history && (pRecord->flags & FlagRetain) != 0 && (pRecord->flags & FlagSuperseded) == 0) {
+    m_key.assign(reinterpret_cast<const char *>(pRecord + 1), pRecord->channelLength);
+    m_latest.erase(m_key);
+  }
+  m_header->tail += pRecord->size;
+  --m_header->count;
+}
+
+OfflineBuffer::Statistics_t OfflineBuffer::GetStatistics() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  Statistics_t statistics = m_statistics;
+  statistics.records = m_header->count;
+  if (m_header->count > 0) {
+    statistics.usedBytes =
+      m_header->head > m_header->tail ? m_header->head - m_header->tail : m_header->capacity - m_header->tail + m_header->head;
+  }
+  return statistics;
+}
+}  // namespace Dashboard
+}  // namespace Umati
@@ -0,0 +1,100 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "IPublisher.hpp"
+
+namespace Umati {
+namespace Dashboard {
+/**
+ * Size bounded ring of outgoing messages in a memory mapped file, used while the broker is not reachable.
+ *
+ * Messages are written directly into the mapping, so the buffer survives a restart of the process.
+ * If the ring is full, the oldest messages are overwritten.
+ * Without history, only the latest retained message per channel is replayed, older ones are marked as superseded
+ * and not retained messages are not stored at all. With history, all messages are replayed in the order they were added.
+ */
+class OfflineBuffer {
+ public:
+  struct Record_t {
+    std::string channel;
+    std::string message;
+    /// Retain, ContentType and UserProperties as appended, the message is stored as sent (e.g. compressed)
+    PublishOptions options;
+    std::chrono::system_clock::time_point timestamp;
+    /// Identifies the record for Pop
+    std::uint64_t sequence = 0;
+  };
+
+  struct Statistics_t {
+    std::uint64_t records = 0;
+    std::uint64_t usedBytes = 0;
+    std::uint64_t stored = 0;
+    /// Overwritten because the ring was full or the message did not fit at all
+    std::uint64_t dropped = 0;
+    std::uint64_t superseded = 0;
+  };
+
+  /// Opens or creates path, existing content is kept if it is a valid buffer with the same capacity
+  OfflineBuffer(const std::string &path, std::uint64_t capacity, bool history);
+  ~OfflineBuffer();
+
+  OfflineBuffer(const OfflineBuffer &) = delete;
+  OfflineBuffer &operator=(const OfflineBuffer &) = delete;
+
+  /// Returns false if the message was not stored
+  bool Append(const std::string &channel, const std::string &message, const PublishOptions &options);
+
+  bool Append(const std::string &channel, const std::string &message, bool retain);
+
+  bool Empty();
+
+  /// Copies the oldest record, that is not superseded, into record. Reuses the capacity of the strings in record.
+  bool Peek(Record_t &record);
+
+  /// Removes the oldest record if it is still the one returned by Peek
+  void Pop(std::uint64_t sequence);
+
+  Statistics_t GetStatistics();
+
+ private:
+  struct Header_t;
+  struct RecordHeader_t;
+  class MappedFile;
+
+  static std::uint64_t recordSize(std::size_t channelLength, std::size_t optionsLength, std::size_t messageLength);
+  /// Serializes the stored fields of options into m_options
+  void encodeOptions(const PublishOptions &options);
+  RecordHeader_t *recordAt(std::uint64_t offset);
+  /// Skips a wrap marker at the tail
+  void normalizeTail();
+  void evictOldest();
+  void rebuildIndex();
+
+  const bool m_history;
+  std::mutex m_mutex;
+  std::unique_ptr<MappedFile> m_file;
+  Header_t *m_header = nullptr;
+  char *m_data = nullptr;
+  /// Offset of the latest retained record per channel, only without history
+  std::unordered_map<std::string, std::uint64_t> m_latest;
+  /// Reused to look up channels in m_latest without an allocation per message
+  std::string m_key;
+  /// Reused to serialize the options of a record
+  std::string m_options;
+  Statistics_t m_statistics;
+};
+}  // namespace Dashboard
+}  // namespace Umati
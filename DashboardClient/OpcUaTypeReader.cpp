@@ -8,8 +8,15 @@
  */
 
 #include "OpcUaTypeReader.hpp"
+#include "NodeSetReader.hpp"
+#include "TypeCache.hpp"
+#include "TypeModelSharing.hpp"
 #include <easylogging++.h>
+#include <algorithm>
+#include <functional>
 #include <regex>
+#include <set>
+#include <unordered_set>
 #include <Exceptions/OpcUaException.hpp>
 
  namespace Umati
@@ -20,9 +27,15 @@
         OpcUaTypeReader::OpcUaTypeReader(
             std::shared_ptr<IDashboardDataClient> pIClient,
             std::vector<std::string> expectedObjectTypeNamespaces,
-            std::vector<Umati::Util::NamespaceInformation> namespaceInformations)
+            std::vector<Umati::Util::NamespaceInformation> namespaceInformations,
+            std::string typeCacheFile,
+            std::vector<std::string> nodeSetFiles,
+            bool lazyTypes)
             : m_expectedObjectTypeNamespaces(std::move(expectedObjectTypeNamespaces)),
-              m_pClient(pIClient)
+              m_pClient(pIClient),
+              m_typeCacheFile(std::move(typeCacheFile)),
+              m_nodeSetFiles(std::move(nodeSetFiles)),
+              m_lazyTypes(lazyTypes)
         {
             for (auto const &el: namespaceInformations) {
                 m_availableObjectTypeNamespaces[el.Namespace] = el;
@@ -48,6 +61,47 @@
 
         void OpcUaTypeReader::readTypes()
         {
+            std::string typeCacheKey;
+            nlohmann::json namespaceMetadata = nlohmann::json::object();
+            bool useTypeCache = !m_typeCacheFile.empty();
+            if (!m_typeCacheFile.empty() || !m_nodeSetFiles.empty())
+            {
+                if (!readNamespaceMetadata(namespaceMetadata) && useTypeCache)
+                {
+                    // Changed versions on the server would go unnoticed with a key of the URIs only
+                    LOG(WARNING) << "The type cache is neither loaded nor stored, as the NamespaceMetadata could not be read";
+                    useTypeCache = false;
+                }
+            }
+            if (m_lazyTypes)
+            {
+                if (!m_typeCacheFile.empty())
+                {
+                    LOG(INFO) << "The type cache is not used, types are read on their first use";
+                }
+                loadNodeSets(namespaceMetadata);
+                m_relevantTypes.clear();
+                m_unresolvableTypes.clear();
+                m_mergedChildren.clear();
+                m_lazyBiDirTypeMap = std::make_shared<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
+                // Without relevant types browseTypes skips all subtypes, only the roots and their own children are browsed
+                browseObjectOrVariableTypeAndFillBidirectionalTypeMap(NodeId_BaseVariableType, m_lazyBiDirTypeMap, true);
+                browseObjectOrVariableTypeAndFillBidirectionalTypeMap(NodeId_BaseObjectType, m_lazyBiDirTypeMap, false);
+                updateObjectTypeNames();
+                return;
+            }
+            if (useTypeCache)
+            {
+                typeCacheKey = getTypeCacheKey(namespaceMetadata);
+                if (TypeCache::Load(m_typeCacheFile, typeCacheKey, *m_typeMap, *m_nameToId))
+                {
+                    LOG(INFO) << "Loaded " << m_typeMap->size() << " types from " << m_typeCacheFile;
+                    shareTypeModel();
+                    updateObjectTypeNames();
+                    return;
+                }
+            }
+
             std::vector<std::string> notFoundObjectTypeNamespaces;
             auto bidirectionalTypeMap =
                 std::make_shared<
@@ -55,12 +109,18 @@
                         ModelOpcUa::NodeId_t,
                         std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
             initialize(notFoundObjectTypeNamespaces);
+            loadNodeSets(namespaceMetadata);
+            m_relevantTypes.clear();
+            browseRelevantTypes({NodeId_BaseVariableType, NodeId_BaseObjectType});
+            LOG(INFO) << "Found " << m_relevantTypes.size() << " types of the ObjectTypeNamespaces and their supertypes";
             LOG(INFO) << "Browsing variable types.";
             browseObjectOrVariableTypeAndFillBidirectionalTypeMap(NodeId_BaseVariableType, bidirectionalTypeMap, true);
             LOG(INFO) << "Browsing variable types finished, continuing browsing object types";
 
             browseObjectOrVariableTypeAndFillBidirectionalTypeMap(NodeId_BaseObjectType, bidirectionalTypeMap, false);
             LOG(INFO) << "Browsing object types finished";
+            m_relevantTypes.clear();
+            m_pNodeSet.reset();
 
             auto namespaces = m_pClient->Namespaces();
             for (std::size_t iNamespace = 0; iNamespace < namespaces.size(); ++iNamespace)
@@ -79,6 +139,7 @@
                     namespaceURI,
                     bidirectionalTypeMap);
             }
+            m_mergedChildren.clear();
 
             for (auto &notFoundObjectTypeNamespace : notFoundObjectTypeNamespaces)
             {
@@ -87,8 +148,291 @@
 
             // printTypeMapYaml();
             updateTypeMap();
+            shareTypeModel();
             updateObjectTypeNames();
+
+            if (useTypeCache)
+            {
+                try
+                {
+                    TypeCache::Store(m_typeCacheFile, typeCacheKey, *m_typeMap, *m_nameToId);
+                    LOG(INFO) << "Stored " << m_typeMap->size() << " types in " << m_typeCacheFile;
+                }
+                catch (const std::runtime_error &ex)
+                {
+                    LOG(WARNING) << "Could not store the type cache: " << ex.what();
+                }
+            }
+        }
+
+        /**
+        * The type model depends on the namespace array of the server, the versions of the namespaces, the configured ObjectTypeNamespaces
+        * and the NodeSet files. A namespace without NamespaceMetadata on the server is only identified by its URI.
+        */
+        std::string OpcUaTypeReader::getTypeCacheKey(const nlohmann::json &namespaceMetadata)
+        {
+            nlohmann::json key;
+            key["ObjectTypeNamespaces"] = m_expectedObjectTypeNamespaces;
+            key["Namespaces"] = m_pClient->Namespaces();
+            key["NamespaceMetadata"] = namespaceMetadata;
+            key["NodeSetFiles"] = m_nodeSetFiles;
+            return key.dump();
+        }
+
+        bool OpcUaTypeReader::readNamespaceMetadata(nlohmann::json &namespaceMetadata)
+        {
+            static const std::set<std::string> metadataProperties{"NamespaceUri", "NamespaceVersion", "NamespacePublicationDate"};
+            namespaceMetadata = nlohmann::json::object();
+            try
+            {
+                for (const auto &namespaceObject : m_pClient->Browse(NodeId_Server_Namespaces, IDashboardDataClient::BrowseContext_t::HasComponent()))
+                {
+                    std::list<ModelOpcUa::NodeId_t> propertyIds;
+                    std::vector<std::string> propertyNames;
+                    for (const auto &property : m_pClient->Browse(namespaceObject.NodeId, IDashboardDataClient::BrowseContext_t::WithReference(NodeId_HasProperty)))
+                    {
+                        if (metadataProperties.count(property.BrowseName.Name) != 0)
+                        {
+                            propertyIds.push_back(property.NodeId);
+                            propertyNames.push_back(property.BrowseName.Name);
+                        }
+                    }
+                    if (propertyIds.empty())
+                    {
+                        continue;
+                    }
+                    auto values = m_pClient->ReadeNodeValues(propertyIds);
+                    nlohmann::json metadata;
+                    for (std::size_t i = 0; i < values.size() && i < propertyNames.size(); ++i)
+                    {
+                        metadata[propertyNames[i]] = values[i];
+                    }
+                    namespaceMetadata[namespaceObject.BrowseName.Name] = metadata;
+                }
+            }
+            catch (const Exceptions::UmatiException &ex)
+            {
+                LOG(WARNING) << "Could not read the NamespaceMetadata, NodeSet files are used without comparing their versions: " << ex.what();
+                namespaceMetadata = nlohmann::json::object();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+        * A model is only used if the server has its namespace in the same version, if the server does not provide a NamespaceVersion
+        * the file is trusted. Types of namespaces without a usable file are browsed from the server, as subtypes of the types
+        * from the files as well.
+        */
+        void OpcUaTypeReader::loadNodeSets(const nlohmann::json &namespaceMetadata)
+        {
+            m_pNodeSet.reset();
+            m_browseSubtypesFromServer = false;
+            if (m_nodeSetFiles.empty())
+            {
+                return;
+            }
+            auto pNodeSet = std::make_shared<NodeSetReader>();
+            for (const auto &nodeSetFile : m_nodeSetFiles)
+            {
+                try
+                {
+                    pNodeSet->Load(nodeSetFile);
+                }
+                catch (const std::runtime_error &ex)
+                {
+                    LOG(WARNING) << ex.what() << ", its types are browsed from the server";
+                }
+            }
+
+            auto namespaces = m_pClient->Namespaces();
+            std::set<std::string> nodeSetNamespaces;
+            bool modelRemoved = false;
+            auto models = pNodeSet->Models();
+            for (const auto &model : models)
+            {
+                if (std::find(namespaces.begin(), namespaces.end(), model.ModelUri) == namespaces.end())
+                {
+                    LOG(INFO) << "Server does not use " << model.ModelUri << ", ignoring its NodeSet";
+                    pNodeSet->RemoveNamespace(model.ModelUri);
+                    modelRemoved = true;
+                    continue;
+                }
+                std::string serverVersion;
+                for (const auto &metadata : namespaceMetadata.items())
+                {
+                    if ((metadata.key() == model.ModelUri || metadata.value().value("NamespaceUri", nlohmann::json()) == model.ModelUri) &&
+                        metadata.value().value("NamespaceVersion", nlohmann::json()).is_string())
+                    {
+                        serverVersion = metadata.value()["NamespaceVersion"].get<std::string>();
+                    }
+                }
+                if (!serverVersion.empty() && serverVersion != model.Version)
+                {
+                    LOG(WARNING) << "Server uses version " << serverVersion << " of " << model.ModelUri << ", the NodeSet has version "
+                                 << model.Version << ", browsing its types from the server";
+                    pNodeSet->RemoveNamespace(model.ModelUri);
+                    modelRemoved = true;
+                    continue;
+                }
+                nodeSetNamespaces.insert(model.ModelUri);
+            }
+
+            // Types of a namespace without a usable file can be subtypes of types from the files, e.g. of BaseObjectType from
+            // Opc.Ua.NodeSet2.xml, and are only found by merging the subtypes of the server. Namespace 0 can not subtype other namespaces.
+            for (const auto &namespaceUri : namespaces)
+            {
+                if (!namespaceUri.empty() && namespaceUri != ns0Uri && nodeSetNamespaces.count(namespaceUri) == 0)
+                {
+                    LOG(INFO) << "No usable NodeSet for " << namespaceUri << ", browsing its types from the server";
+                    m_browseSubtypesFromServer = true;
+                }
+            }
+            if (modelRemoved)
+            {
+                m_browseSubtypesFromServer = true;
+            }
+            LOG(INFO) << "Using the NodeSets of " << nodeSetNamespaces.size() << " namespaces";
+            m_pNodeSet = pNodeSet;
         }
+
+        std::vector<std::list<ModelOpcUa::BrowseResult_t>> OpcUaTypeReader::browseMultiple(
+            const std::vector<ModelOpcUa::NodeId_t> &startNodes,
+            const IDashboardDataClient::BrowseContext_t &browseContext)
+        {
+            std::vector<std::list<ModelOpcUa::BrowseResult_t>> ret(startNodes.size());
+            std::vector<ModelOpcUa::NodeId_t> serverNodes;
+            std::vector<std::size_t> serverIndices;
+            // Types of a NodeSet might have subtypes in a namespace only the server knows
+            std::vector<ModelOpcUa::NodeId_t> serverSubtypeNodes;
+            std::vector<std::size_t> serverSubtypeIndices;
+            for (std::size_t i = 0; i < startNodes.size(); ++i)
+            {
+                if (m_pNodeSet && m_pNodeSet->Contains(startNodes[i]))
+                {
+                    ret[i] = m_pNodeSet->Browse(startNodes[i], browseContext.referenceTypeId, browseContext.nodeClassMask);
+                    if (m_browseSubtypesFromServer && m_pNodeSet->IsType(startNodes[i]))
+                    {
+                        serverSubtypeNodes.push_back(startNodes[i]);
+                        serverSubtypeIndices.push_back(i);
+                    }
+                }
+                else
+                {
+                    serverNodes.push_back(startNodes[i]);
+                    serverIndices.push_back(i);
+                }
+            }
+
+            if (!serverNodes.empty())
+            {
+                auto serverResults = m_pClient->BrowseMultiple(serverNodes, browseContext);
+                for (std::size_t i = 0; i < serverResults.size() && i < serverIndices.size(); ++i)
+                {
+                    ret[serverIndices[i]] = std::move(serverResults[i]);
+                }
+            }
+            if (!serverSubtypeNodes.empty())
+            {
+                auto subtypeContext = IDashboardDataClient::BrowseContext_t::WithReference(NodeId_HasSubtype);
+                subtypeContext.nodeClassMask = browseContext.nodeClassMask;
+                auto serverResults = m_pClient->BrowseMultiple(serverSubtypeNodes, subtypeContext);
+                for (std::size_t i = 0; i < serverResults.size() && i < serverSubtypeIndices.size(); ++i)
+                {
+                    for (auto &subtype : serverResults[i])
+                    {
+                        if (!m_pNodeSet->Contains(subtype.NodeId))
+                        {
+                            ret[serverSubtypeIndices[i]].push_back(std::move(subtype));
+                        }
+                    }
+                }
+            }
+            return ret;
+        }
+
+        std::vector<ModelOpcUa::ModellingRule_t> OpcUaTypeReader::browseModellingRules(const std::vector<ModelOpcUa::NodeId_t> &nodeIds)
+        {
+            std::vector<ModelOpcUa::ModellingRule_t> ret(nodeIds.size(), ModelOpcUa::ModellingRule_t::Optional);
+            std::vector<ModelOpcUa::NodeId_t> serverNodes;
+            std::vector<std::size_t> serverIndices;
+            for (std::size_t i = 0; i < nodeIds.size(); ++i)
+            {
+                if (m_pNodeSet && m_pNodeSet->Contains(nodeIds[i]))
+                {
+                    ret[i] = m_pNodeSet->ModellingRule(nodeIds[i]);
+                }
+                else
+                {
+                    serverNodes.push_back(nodeIds[i]);
+                    serverIndices.push_back(i);
+                }
+            }
+            if (!serverNodes.empty())
+            {
+                auto serverModellingRules = m_pClient->BrowseModellingRules(serverNodes);
+                for (std::size_t i = 0; i < serverModellingRules.size() && i < serverIndices.size(); ++i)
+                {
+                    ret[serverIndices[i]] = serverModellingRules[i];
+                }
+            }
+            return ret;
+        }
+
+        /**
+        * Only types of the expected ObjectTypeNamespaces are added to the type map, all other types are only needed for the
+        * instance declarations they pass on to these. The subtype hierarchy alone is much smaller than the hierarchy with all
+        * instance declarations, so it is browsed first and browseTypes skips every subtree without a relevant type.
+        * Each level of the hierarchy is browsed with a single BrowseMultiple.
+        */
+        void OpcUaTypeReader::browseRelevantTypes(const std::vector<ModelOpcUa::NodeId_t> &rootTypes)
+        {
+            auto browseContext = IDashboardDataClient::BrowseContext_t::WithReference(NodeId_HasSubtype);
+            browseContext.nodeClassMask =
+                (std::uint32_t)IDashboardDataClient::BrowseContext_t::NodeClassMask::OBJECT_TYPE |
+                (std::uint32_t)IDashboardDataClient::BrowseContext_t::NodeClassMask::VARIABLE_TYPE;
+            std::map<ModelOpcUa::NodeId_t, ModelOpcUa::NodeId_t> supertypes;
+            std::vector<ModelOpcUa::NodeId_t> expectedTypes;
+            std::vector<ModelOpcUa::NodeId_t> frontier = rootTypes;
+            while (!frontier.empty())
+            {
+                auto subtypes = browseMultiple(frontier, browseContext);
+                std::vector<ModelOpcUa::NodeId_t> nextFrontier;
+                for (std::size_t i = 0; i < frontier.size(); ++i)
+                {
+                    for (const auto &subtype : subtypes[i])
+                    {
+                        if (!supertypes.insert(std::make_pair(subtype.NodeId, frontier[i])).second)
+                        {
+                            continue;
+                        }
+                        if (std::find(m_expectedObjectTypeNamespaces.begin(), m_expectedObjectTypeNamespaces.end(), subtype.NodeId.Uri) !=
+                            m_expectedObjectTypeNamespaces.end())
+                        {
+                            expectedTypes.push_back(subtype.NodeId);
+                        }
+                        nextFrontier.push_back(subtype.NodeId);
+                    }
+                }
+                frontier.swap(nextFrontier);
+            }
+
+            for (const auto &expectedType : expectedTypes)
+            {
+                // Stop at the first supertype already added by another type
+                auto typeNodeId = expectedType;
+                while (m_relevantTypes.insert(typeNodeId).second)
+                {
+                    auto supertype = supertypes.find(typeNodeId);
+                    if (supertype == supertypes.end())
+                    {
+                        break;
+                    }
+                    typeNodeId = supertype->second;
+                }
+            }
+        }
+
         void OpcUaTypeReader::updateObjectTypeNames() {
             m_expectedObjectTypeNames.clear();
             for (const auto &el: m_identificationTypeOfTypeDefinition) {
@@ -96,6 +440,18 @@
                 std::shared_ptr<ModelOpcUa::StructureNode> node;
                 try
                 {
+                    if (m_lazyTypes)
+                    {
+                        // Only the name, the type is read when the first machine of it is found
+                        auto typeName = m_pClient->readNodeBrowseName(typeNodeId);
+                        std::string uriPrefix = typeNodeId.Uri + ";";
+                        if (typeName.compare(0, uriPrefix.size(), uriPrefix) == 0)
+                        {
+                            typeName.erase(0, uriPrefix.size());
+                        }
+                        m_expectedObjectTypeNames.push_back(typeName);
+                        continue;
+                    }
                     node = typeDefinitionToStructureNode(typeNodeId);
                     m_expectedObjectTypeNames.push_back(node->SpecifiedBrowseName.Name);
                 }
@@ -127,40 +483,55 @@
         {
             for (auto mapIterator = m_typeMap->begin(); mapIterator != m_typeMap->end(); mapIterator++)
             {
-                for (auto childIterator = mapIterator->second->SpecifiedChildNodes->begin();
-                     childIterator != mapIterator->second->SpecifiedChildNodes->end(); childIterator++)
+                updateType(mapIterator->second);
+            }
+        }
+
+        void OpcUaTypeReader::updateType(const std::shared_ptr<ModelOpcUa::StructureNode> &type)
+        {
+            for (auto childIterator = type->SpecifiedChildNodes->begin();
+                 childIterator != type->SpecifiedChildNodes->end(); childIterator++)
+            {
+                try
                 {
-                    try
-                    {
-                        auto childTypeNodeId = childIterator->get()->SpecifiedTypeNodeId;
-                        if (childTypeNodeId == Dashboard::NodeId_Folder) {
-                            for (auto childOfChildIterator = childIterator->get()->SpecifiedChildNodes->begin(); 
-                                childOfChildIterator != childIterator->get()->SpecifiedChildNodes->end(); childOfChildIterator++) {
-                                    auto childOfChild = childOfChildIterator->get()->SpecifiedTypeNodeId;
-                                    auto childType = m_typeMap->find(childOfChild);
-                                    if (childType != m_typeMap->end())
-                                    {
-                                        childOfChildIterator->get()->SpecifiedChildNodes = childType->second->SpecifiedChildNodes;
-                                        childOfChildIterator->get()->ofBaseDataVariableType = childType->second->ofBaseDataVariableType;
-                                    }
-                            } 
-                            continue;
-                        }
-                        auto childType = m_typeMap->find(childTypeNodeId);
-                        if (childType != m_typeMap->end())
-                        {
-                            childIterator->get()->SpecifiedChildNodes = childType->second->SpecifiedChildNodes;
-                            childIterator->get()->ofBaseDataVariableType = childType->second->ofBaseDataVariableType;
-                        }
+                    auto childTypeNodeId = childIterator->get()->SpecifiedTypeNodeId;
+                    if (childTypeNodeId == Dashboard::NodeId_Folder) {
+                        for (auto childOfChildIterator = childIterator->get()->SpecifiedChildNodes->begin(); 
+                            childOfChildIterator != childIterator->get()->SpecifiedChildNodes->end(); childOfChildIterator++) {
+                                auto childOfChild = childOfChildIterator->get()->SpecifiedTypeNodeId;
+                                auto childType = m_typeMap->find(childOfChild);
+                                if (childType != m_typeMap->end())
+                                {
+                                    childOfChildIterator->get()->SpecifiedChildNodes = childType->second->SpecifiedChildNodes;
+                                    childOfChildIterator->get()->ofBaseDataVariableType = childType->second->ofBaseDataVariableType;
+                                }
+                        } 
+                        continue;
                     }
-                    catch (std::exception &ex)
+                    auto childType = m_typeMap->find(childTypeNodeId);
+                    if (childType != m_typeMap->end())
                     {
-                        LOG(WARNING) << "Unable to update type due to " << ex.what();
+                        childIterator->get()->SpecifiedChildNodes = childType->second->SpecifiedChildNodes;
+                        childIterator->get()->ofBaseDataVariableType = childType->second->ofBaseDataVariableType;
                     }
                 }
+                catch (std::exception &ex)
+                {
+                    LOG(WARNING) << "Unable to update type due to " << ex.what();
+                }
             }
         }
 
+        void OpcUaTypeReader::shareTypeModel()
+        {
+            auto before = TypeModelSharing::Measure(*m_typeMap);
+            TypeModelSharing::Share(*m_typeMap);
+            auto after = TypeModelSharing::Measure(*m_typeMap);
+            LOG(INFO) << "Type model: " << before.Nodes << " nodes and " << before.ChildLists << " child lists (~"
+                      << before.Bytes / 1024 << " KiB), after sharing identical definitions " << after.Nodes << " nodes and "
+                      << after.ChildLists << " child lists (~" << after.Bytes / 1024 << " KiB)";
+        }
+
         void OpcUaTypeReader::browseObjectOrVariableTypeAndFillBidirectionalTypeMap(
             const ModelOpcUa::NodeId_t &startNodeId,
             OpcUaTypeReader::BiDirTypeMap_t bidirectionalTypeMap,
@@ -199,93 +570,122 @@
                 {
                     continue;
                 }
-                // go to highest parent and then down the ladder to add / update attributes;
-                // create a list of pointers till parent is null
-                // go backwards and add / update child nodes till the end
-                std::shared_ptr<std::list<std::shared_ptr<ModelOpcUa::StructureBiNode>>>
-                    bloodline = std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
-                std::shared_ptr<ModelOpcUa::StructureBiNode> currentGeneration = typeIterator.second;
-                while (nullptr != currentGeneration)
-                {
-                    bloodline->emplace_back(currentGeneration);
-                    currentGeneration = currentGeneration->parent.lock();
-                }
-                std::string typeName = bloodline->front()->structureNode->SpecifiedBrowseName.Uri + ";" +
-                                       bloodline->front()->structureNode->SpecifiedBrowseName.Name;
-                ModelOpcUa::StructureNode node = bloodline->front()->structureNode.operator*();
-                node.ofBaseDataVariableType = bloodline->front()->ofBaseDataVariableType;
-                std::stringstream bloodlineStringStream;
-
-                for (auto bloodlineIterator = bloodline->rbegin();
-                     bloodlineIterator != bloodline->rend();
-                     ++bloodlineIterator)
-                {
-                    auto ancestor = *bloodlineIterator;
-                    bloodlineStringStream << "->" << static_cast<std::string>(ancestor->structureNode->SpecifiedBrowseName);
-
-                    // Ancestor is a SuperType of the analysed node (var node)
-                    // Iterate over the children of the ancestor (var ancestor)
-                    // (var currentChild) is a child of the ancestor
-                    // Example: (var node) = ProductionProgramStateMachineType (ns=MachineTool;i=15)
-                    //          (var ancestor.1) = ProductionStateMachineType (ns=MachineTool;i=24)
-                    //          (var ancestor.2) = FiniteStateMachineType (ns=0;i=2771)
-                    for (auto &currentChild : *ancestor->SpecifiedBiChildNodes)
+                addToTypeMap(typeIterator.first, typeIterator.second);
+            }
+        }
+
+        std::shared_ptr<ModelOpcUa::StructureNode> OpcUaTypeReader::addToTypeMap(
+            const ModelOpcUa::NodeId_t &typeNodeId,
+            const std::shared_ptr<ModelOpcUa::StructureBiNode> &type)
+        {
+            ModelOpcUa::StructureNode node = type->structureNode.operator*();
+            node.ofBaseDataVariableType = type->ofBaseDataVariableType;
+            node.SpecifiedChildNodes = mergedChildren(type).Children;
+            std::pair<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureNode>> newType(typeNodeId, std::make_shared<ModelOpcUa::StructureNode>(node));
+            return m_typeMap->insert(newType).first->second;
+        }
+
+        const OpcUaTypeReader::MergedChildren_t &OpcUaTypeReader::mergedChildren(const std::shared_ptr<ModelOpcUa::StructureBiNode> &type)
+        {
+            // Supertypes without merged children yet, starting with the type itself
+            std::vector<std::shared_ptr<ModelOpcUa::StructureBiNode>> bloodline;
+            const MergedChildren_t *pSuperTypeChildren = nullptr;
+            for (auto currentGeneration = type; currentGeneration != nullptr; currentGeneration = currentGeneration->parent.lock())
+            {
+                auto it = m_mergedChildren.find(currentGeneration.get());
+                if (it != m_mergedChildren.end())
+                {
+                    pSuperTypeChildren = &it->second;
+                    break;
+                }
+                bloodline.push_back(currentGeneration);
+            }
+
+            for (auto bloodlineIterator = bloodline.rbegin(); bloodlineIterator != bloodline.rend(); ++bloodlineIterator)
+            {
+                MergedChildren_t merged;
+                merged.Children = std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>>();
+                if (pSuperTypeChildren != nullptr)
+                {
+                    merged.ByBrowseName.reserve(pSuperTypeChildren->Children->size());
+                    for (const auto &child : *pSuperTypeChildren->Children)
                     {
-                        if (currentChild->isType)
-                        {
-                            continue;
-                        }
-                        auto structureNode = currentChild->toStructureNode();
+                        merged.Children->emplace_back(child);
+                        merged.ByBrowseName.emplace(child->SpecifiedBrowseName, std::prev(merged.Children->end()));
+                    }
+                }
+                mergeChildren(merged, **bloodlineIterator);
+                pSuperTypeChildren = &(m_mergedChildren[bloodlineIterator->get()] = std::move(merged));
+            }
+            return *pSuperTypeChildren;
+        }
 
-                        // Lookup if ancestor's child currentChild is child of the node.
-                        auto findIterator = std::find_if(node.SpecifiedChildNodes->begin(), node.SpecifiedChildNodes->end(), [&](const auto &el) {
-                            return el == structureNode || el->SpecifiedBrowseName == structureNode->SpecifiedBrowseName;
-                        });
+        /**
+        * The children of the supertypes are already in merged, a child of the subtype with the same BrowseName
+        * only replaces an optional one, otherwise its children are added to the existing child.
+        * Example: ProductionStateMachineType (ns=MachineTool;i=24) and its supertype FiniteStateMachineType (ns=0;i=2771) both
+        * contain a CurrentState, only the one of FiniteStateMachineType contains the node "Number", which is added.
+        * The existing child is copied before, see copyChild.
+        */
+        void OpcUaTypeReader::mergeChildren(OpcUaTypeReader::MergedChildren_t &merged, ModelOpcUa::StructureBiNode &ancestor)
+        {
+            for (auto &currentChild : *ancestor.SpecifiedBiChildNodes)
+            {
+                if (currentChild->isType)
+                {
+                    continue;
+                }
+                auto structureNode = currentChild->toStructureNode();
+                auto findIterator = merged.ByBrowseName.find(structureNode->SpecifiedBrowseName);
+                if (findIterator == merged.ByBrowseName.end())
+                {
+                    merged.Children->emplace_back(structureNode);
+                    merged.ByBrowseName.emplace(structureNode->SpecifiedBrowseName, std::prev(merged.Children->end()));
+                    continue;
+                }
 
-                        /// \todo Check if a merge is required here!
-                        // Ancestor's child currentChild is child of the node.
-                        // (var findIterator) contains the child of the node.
-                        if (findIterator != node.SpecifiedChildNodes->end())
-                        {
-                            // (var structureNodeChildren) contains children of the child of the ancestor, which is also contained in the node.
-                            auto structureNodeChildren = structureNode->SpecifiedChildNodes;
-
-                            // Iterate over children of the child of the ancestor.
-                            // If there are children which are contained in ancestor->child and not in node->child, add them to node->child
-                            // Example: Ancestor FiniteStateMachineType is an ancestor of ProductionStateMachineType, both contain a node CurrentState
-                            // ProductionStateMachineType->CurrentState does not contain the node "Number", but FiniteStateMachineType->CurrentState->Number does exist
-                            // Thus, we add node "Number" to SpecifiedChildNodes of ProductionStateMachineType->CurrentState.
-                            for (auto &childOfChild : *structureNodeChildren) {
-                                auto findIt = std::find_if(findIterator->get()->SpecifiedChildNodes->begin(), findIterator->get()->SpecifiedChildNodes->end(), [&](const auto &el) {
-                                    return el == childOfChild || childOfChild->SpecifiedBrowseName == el->SpecifiedBrowseName;
-                                });
-
-                                if (findIt == findIterator->get()->SpecifiedChildNodes->end()) {
-                                    findIterator->get()->SpecifiedChildNodes->emplace_back(childOfChild);
-                                }
-                            }
-                            // Check if original child is optional, if so, override
-                            if ((*findIterator)->ModellingRule == ModelOpcUa::ModellingRule_t::Optional ||
-                                (*findIterator)->ModellingRule == ModelOpcUa::ModellingRule_t::OptionalPlaceholder)
-                            {
-                                node.SpecifiedChildNodes->erase(findIterator++);
-                                node.SpecifiedChildNodes->emplace_back(structureNode);
-                            }
-                        }
-                        // Node's ancestor's child currentChild is not child of the node.
-                        else
+                /// \todo Check if a merge is required here!
+                auto &existingChild = *findIterator->second;
+                std::unordered_set<ModelOpcUa::QualifiedName_t, BrowseNameHash> existingChildrenOfChild;
+                for (const auto &childOfChild : *existingChild->SpecifiedChildNodes)
+                {
+                    existingChildrenOfChild.insert(childOfChild->SpecifiedBrowseName);
+                }
+                bool copied = false;
+                for (auto &childOfChild : *structureNode->SpecifiedChildNodes)
+                {
+                    if (existingChildrenOfChild.insert(childOfChild->SpecifiedBrowseName).second)
+                    {
+                        if (!copied)
                         {
-                            // Thus, we add it.
-                            node.SpecifiedChildNodes->emplace_back(structureNode);
+                            existingChild = copyChild(existingChild);
+                            copied = true;
                         }
+                        existingChild->SpecifiedChildNodes->emplace_back(childOfChild);
                     }
                 }
-                auto shared = std::make_shared<ModelOpcUa::StructureNode>(node);
-                std::pair<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureNode>> newType(typeIterator.first, shared);
-                m_typeMap->insert(newType);
+                // Check if original child is optional, if so, override
+                if (existingChild->ModellingRule == ModelOpcUa::ModellingRule_t::Optional ||
+                    existingChild->ModellingRule == ModelOpcUa::ModellingRule_t::OptionalPlaceholder)
+                {
+                    merged.Children->erase(findIterator->second);
+                    merged.Children->emplace_back(structureNode);
+                    findIterator->second = std::prev(merged.Children->end());
+                }
             }
         }
 
+        /**
+        * The merged children of a type start as the ones of its supertype, so the child is the same object as in the entry of the
+        * supertype and in lazy mode maybe of types already in the type map. Adding children to it would change these types as well.
+        */
+        std::shared_ptr<ModelOpcUa::StructureNode> OpcUaTypeReader::copyChild(const std::shared_ptr<ModelOpcUa::StructureNode> &child)
+        {
+            auto copy = std::make_shared<ModelOpcUa::StructureNode>(*child);
+            copy->SpecifiedChildNodes = std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>>(*child->SpecifiedChildNodes);
+            return copy;
+        }
+
         std::shared_ptr<ModelOpcUa::StructureBiNode> OpcUaTypeReader::handleBrowseTypeResult(
             OpcUaTypeReader::BiDirTypeMap_t &bidirectionalTypeMap,
             const ModelOpcUa::BrowseResult_t &entry,
@@ -337,33 +737,249 @@
             bool ofBaseDataVariableType)
         {
             auto browseTypeContext = IDashboardDataClient::BrowseContext_t::ObjectAndVariableWithTypes();
-            auto browseResults = m_pClient->Browse(startNodeId, browseTypeContext);
-
-            for (auto &browseResult : browseResults)
+            std::vector<ModelOpcUa::NodeId_t> frontier{startNodeId};
+            std::vector<std::weak_ptr<ModelOpcUa::StructureBiNode>> frontierParents{parent};
+            while (!frontier.empty())
             {
-                ModelOpcUa::ModellingRule_t modellingRule = ModelOpcUa::ModellingRule_t::None;
+                auto browseResultsOfFrontier = browseMultiple(frontier, browseTypeContext);
+                std::vector<ModelOpcUa::NodeId_t> nextFrontier;
+                std::vector<std::weak_ptr<ModelOpcUa::StructureBiNode>> nextFrontierParents;
+                // Pairs of the index in the frontier and a child to add
+                std::vector<std::pair<std::size_t, const ModelOpcUa::BrowseResult_t *>> children;
+                for (std::size_t i = 0; i < frontier.size(); ++i)
+                {
+                    for (const auto &browseResult : browseResultsOfFrontier[i])
+                    {
+                        if ((browseResult.NodeClass == ModelOpcUa::ObjectType || browseResult.NodeClass == ModelOpcUa::VariableType) &&
+                            m_relevantTypes.count(browseResult.NodeId) == 0)
+                        {
+                            continue;
+                        }
+                        children.emplace_back(i, &browseResult);
+                        nextFrontier.push_back(browseResult.NodeId);
+                    }
+                }
+
+                std::vector<ModelOpcUa::ModellingRule_t> modellingRules;
                 try {
-                    modellingRule = m_pClient->BrowseModellingRule(browseResult.NodeId);
+                    modellingRules = browseModellingRules(nextFrontier);
                 } catch (Exceptions::UmatiException &e) {
-                    LOG(ERROR) << "Error browsing modelling rule of " << browseResult.NodeId << ": " << e.what();
+                    LOG(WARNING) << "Error browsing modelling rules of " << nextFrontier.size() << " nodes, retrying node by node: " << e.what();
+                    // Like before the batched browse, only the failing nodes get None
+                    modellingRules.assign(nextFrontier.size(), ModelOpcUa::ModellingRule_t::None);
+                    for (std::size_t i = 0; i < nextFrontier.size(); ++i)
+                    {
+                        try {
+                            modellingRules[i] = browseModellingRules({nextFrontier[i]}).front();
+                        } catch (Exceptions::UmatiException &e) {
+                            LOG(ERROR) << "Error browsing modelling rule of " << static_cast<std::string>(nextFrontier[i]) << ", using None: " << e.what();
+                        }
+                    }
+                }
+
+                // Results are handled in the order of the frontier, so the child lists are the same as with a depth first browse
+                for (std::size_t i = 0; i < children.size(); ++i)
+                {
+                    auto current = handleBrowseTypeResult(bidirectionalTypeMap,
+                                                          *children[i].second, frontierParents[children[i].first],
+                                                          modellingRules[i],
+                                                          ofBaseDataVariableType);
+                    nextFrontierParents.push_back(current);
                 }
-                std::weak_ptr<ModelOpcUa::StructureBiNode> current = handleBrowseTypeResult(bidirectionalTypeMap,
-                                                                                            browseResult, parent,
-                                                                                            modellingRule,
-                                                                                            ofBaseDataVariableType);
-                browseTypes(bidirectionalTypeMap, browseResult.NodeId, current, ofBaseDataVariableType);
+                frontier.swap(nextFrontier);
+                frontierParents.swap(nextFrontierParents);
             }
         }
 
-        std::shared_ptr<ModelOpcUa::StructureNode> OpcUaTypeReader::typeDefinitionToStructureNode(const ModelOpcUa::NodeId_t &typeDefinition) const
+        std::shared_ptr<ModelOpcUa::StructureNode> OpcUaTypeReader::typeDefinitionToStructureNode(const ModelOpcUa::NodeId_t &typeDefinition)
         {
-            auto typePair = m_typeMap->find(typeDefinition);
-			if (typePair == m_typeMap->end())
+            auto pType = findTypeDefinition(typeDefinition);
+			if (pType == nullptr)
 			{
 				LOG(ERROR) << "Unable to find " << static_cast<std::string>(typeDefinition) + " in typeMap";
 				throw Umati::MachineObserver::Exceptions::MachineInvalidException("Type not found");
 			}
-			return typePair->second;
+			return pType;
+        }
+
+        std::shared_ptr<ModelOpcUa::StructureNode> OpcUaTypeReader::findTypeDefinition(const ModelOpcUa::NodeId_t &typeDefinition)
+        {
+            auto typePair = m_typeMap->find(typeDefinition);
+            if (typePair == m_typeMap->end() && m_lazyTypes && m_lazyBiDirTypeMap != nullptr)
+            {
+                resolveTypes({typeDefinition});
+                typePair = m_typeMap->find(typeDefinition);
+            }
+            if (typePair == m_typeMap->end())
+            {
+                return nullptr;
+            }
+            return typePair->second;
+        }
+
+        bool OpcUaTypeReader::isExpectedNamespace(const std::string &namespaceUri) const
+        {
+            return std::find(m_expectedObjectTypeNamespaces.begin(), m_expectedObjectTypeNamespaces.end(), namespaceUri) !=
+                   m_expectedObjectTypeNamespaces.end();
+        }
+
+        /**
+        * Like readTypes only types of the expected ObjectTypeNamespaces are added to the type map. A type is complete once the types of
+        * its children are in the type map as well, so they are resolved in the same call, level by level.
+        */
+        void OpcUaTypeReader::resolveTypes(const std::vector<ModelOpcUa::NodeId_t> &typeDefinitions)
+        {
+            std::vector<ModelOpcUa::NodeId_t> addedTypes;
+            std::set<ModelOpcUa::NodeId_t> queuedTypes;
+            std::vector<ModelOpcUa::NodeId_t> pending;
+            auto enqueue = [&](const ModelOpcUa::NodeId_t &typeDefinition, std::vector<ModelOpcUa::NodeId_t> &queue) {
+                if (isExpectedNamespace(typeDefinition.Uri) && m_typeMap->count(typeDefinition) == 0 &&
+                    m_unresolvableTypes.count(typeDefinition) == 0 && queuedTypes.insert(typeDefinition).second)
+                {
+                    queue.push_back(typeDefinition);
+                }
+            };
+            for (const auto &typeDefinition : typeDefinitions)
+            {
+                enqueue(typeDefinition, pending);
+            }
+
+            while (!pending.empty())
+            {
+                browseTypeChains(pending);
+                std::vector<ModelOpcUa::NodeId_t> nextPending;
+                for (const auto &typeDefinition : pending)
+                {
+                    auto biNode = m_lazyBiDirTypeMap->find(typeDefinition);
+                    if (biNode == m_lazyBiDirTypeMap->end())
+                    {
+                        LOG(WARNING) << "Unable to read type " << typeDefinition;
+                        m_unresolvableTypes.insert(typeDefinition);
+                        continue;
+                    }
+                    auto pType = addToTypeMap(typeDefinition, biNode->second);
+                    addedTypes.push_back(typeDefinition);
+                    for (const auto &child : *pType->SpecifiedChildNodes)
+                    {
+                        enqueue(child->SpecifiedTypeNodeId, nextPending);
+                        if (child->SpecifiedTypeNodeId == NodeId_Folder)
+                        {
+                            for (const auto &childOfChild : *child->SpecifiedChildNodes)
+                            {
+                                enqueue(childOfChild->SpecifiedTypeNodeId, nextPending);
+                            }
+                        }
+                    }
+                }
+                pending.swap(nextPending);
+            }
+
+            if (addedTypes.empty())
+            {
+                return;
+            }
+            std::vector<std::shared_ptr<ModelOpcUa::StructureNode>> addedNodes;
+            for (const auto &typeDefinition : addedTypes)
+            {
+                addedNodes.push_back(m_typeMap->at(typeDefinition));
+                updateType(addedNodes.back());
+            }
+            LOG(INFO) << "Read " << addedTypes.size() << " types for " << typeDefinitions.front() << ", " << m_typeMap->size() << " types in total";
+            m_lazySharing.Share(addedNodes);
+        }
+
+        /**
+        * The supertypes are found with inverse HasSubtype references up to the first one already browsed, then each missing type is
+        * added below its supertype with the same browseTypes as in readTypes. The BrowseResults of the requested types themselves
+        * come from the HasSubtype references of their supertypes.
+        */
+        void OpcUaTypeReader::browseTypeChains(const std::vector<ModelOpcUa::NodeId_t> &typeDefinitions)
+        {
+            std::map<ModelOpcUa::NodeId_t, ModelOpcUa::NodeId_t> supertypes;
+            std::map<ModelOpcUa::NodeId_t, ModelOpcUa::BrowseResult_t> browseResults;
+            std::vector<ModelOpcUa::NodeId_t> frontier;
+            for (const auto &typeDefinition : typeDefinitions)
+            {
+                if (m_lazyBiDirTypeMap->count(typeDefinition) == 0)
+                {
+                    frontier.push_back(typeDefinition);
+                }
+            }
+            std::vector<ModelOpcUa::NodeId_t> requestedTypes = frontier;
+            while (!frontier.empty())
+            {
+                auto supertypesOfFrontier = m_pClient->BrowseMultiple(frontier, IDashboardDataClient::BrowseContext_t::SupertypeOf());
+                std::vector<ModelOpcUa::NodeId_t> nextFrontier;
+                for (std::size_t i = 0; i < frontier.size() && i < supertypesOfFrontier.size(); ++i)
+                {
+                    if (supertypesOfFrontier[i].empty())
+                    {
+                        continue;
+                    }
+                    const auto &supertype = supertypesOfFrontier[i].front();
+                    supertypes[frontier[i]] = supertype.NodeId;
+                    if (m_lazyBiDirTypeMap->count(supertype.NodeId) == 0 && browseResults.insert(std::make_pair(supertype.NodeId, supertype)).second)
+                    {
+                        nextFrontier.push_back(supertype.NodeId);
+                    }
+                }
+                frontier.swap(nextFrontier);
+            }
+
+            std::vector<ModelOpcUa::NodeId_t> supertypesOfRequested;
+            for (const auto &requestedType : requestedTypes)
+            {
+                auto supertype = supertypes.find(requestedType);
+                if (supertype != supertypes.end() && browseResults.count(requestedType) == 0)
+                {
+                    supertypesOfRequested.push_back(supertype->second);
+                }
+            }
+            if (!supertypesOfRequested.empty())
+            {
+                auto browseContext = IDashboardDataClient::BrowseContext_t::WithReference(NodeId_HasSubtype);
+                browseContext.nodeClassMask = IDashboardDataClient::BrowseContext_t::SupertypeOf().nodeClassMask;
+                for (const auto &subtypes : browseMultiple(supertypesOfRequested, browseContext))
+                {
+                    for (const auto &subtype : subtypes)
+                    {
+                        auto supertype = supertypes.find(subtype.NodeId);
+                        if (supertype != supertypes.end())
+                        {
+                            browseResults.insert(std::make_pair(subtype.NodeId, subtype));
+                        }
+                    }
+                }
+            }
+
+            // Supertypes first, a type is browsed once its supertype is in the map
+            std::function<std::shared_ptr<ModelOpcUa::StructureBiNode>(const ModelOpcUa::NodeId_t &)> browseChain =
+                [&](const ModelOpcUa::NodeId_t &typeDefinition) -> std::shared_ptr<ModelOpcUa::StructureBiNode> {
+                auto existing = m_lazyBiDirTypeMap->find(typeDefinition);
+                if (existing != m_lazyBiDirTypeMap->end())
+                {
+                    return existing->second;
+                }
+                auto supertype = supertypes.find(typeDefinition);
+                auto browseResult = browseResults.find(typeDefinition);
+                if (supertype == supertypes.end() || browseResult == browseResults.end())
+                {
+                    return nullptr;
+                }
+                auto parent = browseChain(supertype->second);
+                if (parent == nullptr)
+                {
+                    return nullptr;
+                }
+                auto current = handleBrowseTypeResult(m_lazyBiDirTypeMap, browseResult->second, parent,
+                                                      ModelOpcUa::ModellingRule_t::Optional, parent->ofBaseDataVariableType);
+                browseTypes(m_lazyBiDirTypeMap, typeDefinition, current, parent->ofBaseDataVariableType);
+                return current;
+            };
+            for (const auto &requestedType : requestedTypes)
+            {
+                browseChain(requestedType);
+            }
         }
 
         std::string OpcUaTypeReader::CSNameFromUri(std::string nsUri)
@@ -381,7 +997,7 @@
         }
 
         std::shared_ptr<ModelOpcUa::StructureNode>
-        OpcUaTypeReader::getIdentificationTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition) const
+        OpcUaTypeReader::getIdentificationTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition)
 		{   
 			auto identificationTypeNodeId = getIdentificationTypeNodeId(typeDefinition);            
 			return typeDefinitionToStructureNode(identificationTypeNodeId);
@@ -11,10 +11,13 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <ModelOpcUa/ModelInstance.hpp>
 #include "IDashboardDataClient.hpp"
 #include <Configuration.hpp>
 #include "TypeDictionary/TypeDictionary.hpp"
+#include "TypeModelSharing.hpp"
 #include "../MachineObserver/Exceptions/MachineInvalidException.hpp"
 #include <sstream>
 #include <iostream>
@@ -23,15 +26,22 @@ namespace Umati
 {
     namespace Dashboard
     {
+        class NodeSetReader;
+
         class OpcUaTypeReader
         {
         public:
             OpcUaTypeReader(
                 std::shared_ptr<IDashboardDataClient> pIClient,
-                std::vector<std::string> expectedObjectTypeNamespaces, std::vector<Umati::Util::NamespaceInformation> namespaceInformations);
+                std::vector<std::string> expectedObjectTypeNamespaces, std::vector<Umati::Util::NamespaceInformation> namespaceInformations,
+                std::string typeCacheFile = std::string(),
+                std::vector<std::string> nodeSetFiles = std::vector<std::string>(),
+                bool lazyTypes = false);
 
             ~OpcUaTypeReader();
             void readTypeDictionaries();
+            /// Loads the types from the type cache file if it matches the namespaces of the server, otherwise browses them and updates the file.
+            /// In lazy mode only the root types are browsed, each type is read on its first use.
             void readTypes();
             using NamespaceInformation_t = Util::NamespaceInformation;
 
@@ -45,8 +55,10 @@ namespace Umati
             std::map<ModelOpcUa::NodeId_t, ModelOpcUa::NodeId_t> m_subTypeDefinitionToKnownMachineTypeDefinition;
             std::shared_ptr<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureNode>>> m_typeMap = std::make_shared<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureNode>>>();
             std::shared_ptr<std::map<std::string, ModelOpcUa::NodeId_t>> m_nameToId = std::make_shared<std::map<std::string, ModelOpcUa::NodeId_t>>();
-            std::shared_ptr<ModelOpcUa::StructureNode> typeDefinitionToStructureNode(const ModelOpcUa::NodeId_t &typeDefinition) const;
-            std::shared_ptr<ModelOpcUa::StructureNode> getIdentificationTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition) const;
+            std::shared_ptr<ModelOpcUa::StructureNode> typeDefinitionToStructureNode(const ModelOpcUa::NodeId_t &typeDefinition);
+            /// nullptr if the type is not in the type map, in lazy mode it is read from the server first
+            std::shared_ptr<ModelOpcUa::StructureNode> findTypeDefinition(const ModelOpcUa::NodeId_t &typeDefinition);
+            std::shared_ptr<ModelOpcUa::StructureNode> getIdentificationTypeStructureNode(const ModelOpcUa::NodeId_t &typeDefinition);
             ModelOpcUa::NodeId_t getIdentificationTypeNodeId(const ModelOpcUa::NodeId_t &typeDefinition) const;
         protected:
             /// Map of <TypeName, StructureBiNode>
@@ -55,21 +67,81 @@ namespace Umati
                                              ModelOpcUa::StructureBiNode>>> BiDirTypeMap_t;
             std::shared_ptr<Umati::Dashboard::IDashboardDataClient> m_pClient;
             const ModelOpcUa::NodeId_t m_emptyId = ModelOpcUa::NodeId_t{"", ""};
+            /// Empty if the type cache is disabled
+            std::string m_typeCacheFile;
+            /// Types of the expected ObjectTypeNamespaces and their supertypes, only these are browsed by browseTypes
+            std::set<ModelOpcUa::NodeId_t> m_relevantTypes;
+            /// Types of nodes defined in these files are read from the files instead of the server
+            std::vector<std::string> m_nodeSetFiles;
+            /// Only set while browsing the types
+            std::shared_ptr<NodeSetReader> m_pNodeSet;
+            /// Set if a namespace of the server is not covered by a usable NodeSet file or a model of the files was removed
+            bool m_browseSubtypesFromServer = false;
+            bool m_lazyTypes;
+            /// Lazy mode: all types browsed so far, kept with m_mergedChildren for the subtypes read later
+            BiDirTypeMap_t m_lazyBiDirTypeMap;
+            /// Lazy mode: types the server does not know as object or variable types, not browsed again
+            std::set<ModelOpcUa::NodeId_t> m_unresolvableTypes;
+            /// Lazy mode: types are resolved while the model is walked, so only the new ones are shared
+            TypeModelSharing::IncrementalSharing m_lazySharing;
+            bool isExpectedNamespace(const std::string &namespaceUri) const;
+            std::string getTypeCacheKey(const nlohmann::json &namespaceMetadata);
+            /// NamespaceMetadata objects of Server/Namespaces by their BrowseName, returns false and an empty object if the browse failed
+            bool readNamespaceMetadata(nlohmann::json &namespaceMetadata);
+            void loadNodeSets(const nlohmann::json &namespaceMetadata);
+            /// BrowseMultiple of the client, answered from the NodeSet files for nodes defined in them
+            std::vector<std::list<ModelOpcUa::BrowseResult_t>> browseMultiple(
+                const std::vector<ModelOpcUa::NodeId_t> &startNodes,
+                const IDashboardDataClient::BrowseContext_t &browseContext);
+            std::vector<ModelOpcUa::ModellingRule_t> browseModellingRules(const std::vector<ModelOpcUa::NodeId_t> &nodeIds);
+            /// Browses the subtypes of rootTypes and adds the relevant ones to m_relevantTypes
+            void browseRelevantTypes(const std::vector<ModelOpcUa::NodeId_t> &rootTypes);
             void initialize(std::vector<std::string> &notFoundObjectTypeNamespaces);
             void browseObjectOrVariableTypeAndFillBidirectionalTypeMap(
                 const ModelOpcUa::NodeId_t &startNodeId,
                 BiDirTypeMap_t bidirectionalTypeMap,
                 bool ofBaseDataVariableType);
+            /// Lazy mode: adds the types, the types of their children and so on to the type map
+            void resolveTypes(const std::vector<ModelOpcUa::NodeId_t> &typeDefinitions);
+            /// Lazy mode: browses the types and their supertypes missing in m_lazyBiDirTypeMap
+            void browseTypeChains(const std::vector<ModelOpcUa::NodeId_t> &typeDefinitions);
 
             void printTypeMapYaml();
             void updateObjectTypeNames();
             void updateTypeMap();
+            /// Children of the type refer to the child list of their type
+            void updateType(const std::shared_ptr<ModelOpcUa::StructureNode> &type);
+            /// Shares identical subtrees of the finished type map and logs its size before and after
+            void shareTypeModel();
             void findObjectTypeNamespacesAndCreateTypeMap(
                 const std::string &namespaceURI,
                 BiDirTypeMap_t bidirectionalTypeMap =
                         std::make_shared<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureBiNode>>>());
             void
             setupTypeMap(std::shared_ptr<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureBiNode>>> &bidirectionalTypeMap, std::string namespaceUri);
+            std::shared_ptr<ModelOpcUa::StructureNode> addToTypeMap(
+                const ModelOpcUa::NodeId_t &typeNodeId,
+                const std::shared_ptr<ModelOpcUa::StructureBiNode> &type);
+
+            struct BrowseNameHash
+            {
+                std::size_t operator()(const ModelOpcUa::QualifiedName_t &browseName) const
+                {
+                    return std::hash<std::string>()(browseName.Name) * 31 + std::hash<std::string>()(browseName.Uri);
+                }
+            };
+            /// Children of a type including the ones of its supertypes, indexed by BrowseName
+            struct MergedChildren_t
+            {
+                std::shared_ptr<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>> Children;
+                std::unordered_map<ModelOpcUa::QualifiedName_t, std::list<std::shared_ptr<ModelOpcUa::StructureNode>>::iterator, BrowseNameHash> ByBrowseName;
+            };
+            /// Merged children of each type setupTypeMap visited, so every supertype is merged only once
+            std::map<const ModelOpcUa::StructureBiNode *, MergedChildren_t> m_mergedChildren;
+            const MergedChildren_t &mergedChildren(const std::shared_ptr<ModelOpcUa::StructureBiNode> &type);
+            static void mergeChildren(MergedChildren_t &merged, ModelOpcUa::StructureBiNode &ancestor);
+            /// Copy of the child with its own child list, which can be changed without changing other types
+            static std::shared_ptr<ModelOpcUa::StructureNode> copyChild(const std::shared_ptr<ModelOpcUa::StructureNode> &child);
 
             std::shared_ptr<ModelOpcUa::StructureBiNode> handleBrowseTypeResult(
                 BiDirTypeMap_t &bidirectionalTypeMap,
@@ -78,6 +150,7 @@ namespace Umati
                 bool ofBaseDataVariableType);
 
             /// Browse all Nodes (Object, Variables, ObjectTypes, VariablesTypes) and fill the BiDirectionalTypeMap
+            /// Browses level by level, all nodes of a level are sent together with BrowseMultiple
             void browseTypes(
                 BiDirTypeMap_t bidirectionalTypeMap,
                 const ModelOpcUa::NodeId_t &startNodeId,
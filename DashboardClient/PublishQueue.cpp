@@ -0,0 +1,119 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "PublishQueue.hpp"
+
+#include <algorithm>
+
+namespace Umati {
+namespace Dashboard {
+PublishQueue::PublishQueue(std::size_t capacity) : m_capacity(std::max<std::size_t>(capacity, 1)) {}
+
+void PublishQueue::Push(std::string channel, std::string message, const PublishOptions &options) {
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    ++m_statistics.pushed;
+    if (options.Retain) {
+      auto it = m_retained.find(channel);
+      if (it != m_retained.end()) {
+        it->second->message = std::move(message);
+        it->second->options = options;
+        // Patches queued meanwhile are based on the older state, the new one has to follow them
+        m_queue.splice(m_queue.end(), m_queue, it->second);
+        ++m_statistics.coalesced;
+        return;
+      }
+    }
+
+    if (m_queue.size() >= m_capacity) {
+      // Sequenced messages are only dropped if nothing else is queued
+      auto oldest = std::find_if(m_queue.begin(), m_queue.end(), [](const Message_t &queued) { return !queued.options.Sequenced; });
+      if (oldest == m_queue.end()) {
+        oldest = m_queue.begin();
+        m_droppedSequenced = true;
+      }
+      if (oldest->options.Retain) {
+        m_retained.erase(oldest->channel);
+      } else {
+        ++m_statistics.droppedNotRetained;
+        m_droppedChannels.insert(std::move(oldest->channel));
+      }
+      m_queue.erase(oldest);
+      ++m_statistics.dropped;
+      ++m_totalDropped;
+    }
+
+    m_queue.push_back(Message_t{channel, std::move(message), options, std::chrono::steady_clock::now()});
+    if (options.Retain) {
+      m_retained.emplace(std::move(channel), std::prev(m_queue.end()));
+    }
+    m_statistics.maxDepth = std::max(m_statistics.maxDepth, m_queue.size());
+  }
+  m_cv.notify_one();
+}
+
+bool PublishQueue::Pop(Message_t &message) {
+  std::unique_lock<std::mutex> ul(m_mutex);
+  m_cv.wait(ul, [this]() { return m_closed || !m_queue.empty(); });
+  if (m_queue.empty()) {
+    return false;
+  }
+
+  message = std::move(m_queue.front());
+  if (message.options.Retain) {
+    m_retained.erase(message.channel);
+  }
+  m_queue.pop_front();
+
+  auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - message.enqueued);
+  ++m_statistics.popped;
+  m_totalLatency += latency;
+  m_statistics.maxLatency = std::max(m_statistics.maxLatency, latency);
+  return true;
+}
+
+void PublishQueue::Close() {
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    m_closed = true;
+  }
+  m_cv.notify_all();
+}
+
+PublishQueue::Statistics_t PublishQueue::GetStatistics(bool reset) {
+  std::lock_guard<std::mutex> l(m_mutex);
+  Statistics_t statistics = m_statistics;
+  statistics.depth = m_queue.size();
+  if (statistics.popped > 0) {
+    statistics.averageLatency = m_totalLatency / statistics.popped;
+  }
+  if (reset) {
+    m_statistics = Statistics_t();
+    m_statistics.maxDepth = m_queue.size();
+    m_totalLatency = std::chrono::microseconds(0);
+  }
+  return statistics;
+}
+
+bool PublishQueue::TakeDropped(const std::string &channel) {
+  std::lock_guard<std::mutex> l(m_mutex);
+  return m_droppedChannels.erase(channel) > 0;
+}
+
+bool PublishQueue::TakeDroppedSequenced() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  bool dropped = m_droppedSequenced;
+  m_droppedSequenced = false;
+  return dropped;
+}
+
+std::uint64_t PublishQueue::DroppedMessages() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  return m_totalDropped;
+}
+}  // namespace Dashboard
+}  // namespace Umati
@@ -0,0 +1,96 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "IPublisher.hpp"
+
+namespace Umati {
+namespace Dashboard {
+/**
+ * Bounded queue between the producers of messages (OPC UA loop, MQTT callbacks) and a single sender thread.
+ *
+ * Retained messages describe a state, so a queued retained message is replaced by a newer one for the same channel
+ * and moves to the end of the queue, behind the patches based on the older state. Other messages (e.g. merge patches) are always appended, as each of them
+ * matters. If the queue is full, the oldest message that is not Sequenced is dropped. Push never blocks. The channels
+ * of dropped messages that are not retained are remembered, so the producer can send the full state again (see TakeDropped).
+ */
+class PublishQueue {
+ public:
+  struct Message_t {
+    std::string channel;
+    std::string message;
+    PublishOptions options;
+    /// Time the message first entered the queue, not updated when it is replaced
+    std::chrono::steady_clock::time_point enqueued;
+  };
+
+  struct Statistics_t {
+    std::size_t depth = 0;
+    std::size_t maxDepth = 0;
+    std::uint64_t pushed = 0;
+    /// Pushed messages that replaced a queued message of the same channel
+    std::uint64_t coalesced = 0;
+    std::uint64_t dropped = 0;
+    /// Part of dropped that was not retained, e.g. merge patches
+    std::uint64_t droppedNotRetained = 0;
+    std::uint64_t popped = 0;
+    /// Time the popped messages spent in the queue
+    std::chrono::microseconds averageLatency{0};
+    std::chrono::microseconds maxLatency{0};
+  };
+
+  explicit PublishQueue(std::size_t capacity);
+
+  void Push(std::string channel, std::string message, const PublishOptions &options);
+
+  /// Blocks until a message is available. Returns false if the queue is closed and empty.
+  bool Pop(Message_t &message);
+
+  /// Wakes up Pop, remaining messages can still be popped
+  void Close();
+
+  /// Counters and maxima since the last call with reset = true, depth is the current queue size
+  Statistics_t GetStatistics(bool reset = false);
+
+  /// Returns true once if a not retained message of channel was dropped since the last call
+  bool TakeDropped(const std::string &channel);
+
+  /// Returns true once if a Sequenced message was dropped since the last call, because the queue contained no other
+  bool TakeDroppedSequenced();
+
+  /// Dropped messages since the creation of the queue, not affected by GetStatistics
+  std::uint64_t DroppedMessages();
+
+ private:
+  typedef std::list<Message_t> Queue_t;
+
+  const std::size_t m_capacity;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  Queue_t m_queue;
+  /// Queued retained messages by channel
+  std::unordered_map<std::string, Queue_t::iterator> m_retained;
+  /// Channels of dropped messages that are not retained, until TakeDropped is called for them
+  std::unordered_set<std::string> m_droppedChannels;
+  std::uint64_t m_totalDropped = 0;
+  bool m_droppedSequenced = false;
+  bool m_closed = false;
+  Statistics_t m_statistics;
+  std::chrono::microseconds m_totalLatency{0};
+};
+}  // namespace Dashboard
+}  // namespace Umati
@@ -0,0 +1,122 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "SparkplugNode.hpp"
+
+#include <chrono>
+
+namespace Umati {
+namespace Dashboard {
+namespace {
+const std::string Namespace = "spBv1.0";
+/// Sequence numbers and bdSeq wrap after 255
+const std::uint64_t SequenceModulo = 256;
+
+const std::string RebirthMetric = "Node Control/Rebirth";
+
+std::uint64_t nextBdSeq() {
+  // Shared by all nodes, a new node is created after each reset of the client and its will has to be distinguishable as well
+  static std::atomic<std::uint64_t> bdSeq{0};
+  return bdSeq++ % SequenceModulo;
+}
+
+std::uint64_t nowMilliseconds() {
+  return static_cast<std::uint64_t>(
+    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+Util::SparkplugB::Metric_t bdSeqMetric(std::uint64_t bdSeq) {
+  Util::SparkplugB::Metric_t metric;
+  metric.name = "bdSeq";
+  metric.dataType = Util::SparkplugB::DataType_t::UInt64;
+  metric.longValue = bdSeq;
+  return metric;
+}
+}  // namespace
+
+SparkplugNode::SparkplugNode(std::string groupId, std::string edgeNodeId, bool deathAsWill)
+  : m_groupId(std::move(groupId)), m_edgeNodeId(std::move(edgeNodeId)), m_deathAsWill(deathAsWill) {}
+
+std::string SparkplugNode::NodeTopic(const std::string &messageType) const {
+  return Namespace + "/" + m_groupId + "/" + messageType + "/" + m_edgeNodeId;
+}
+
+std::string SparkplugNode::DeviceTopic(const std::string &messageType, const std::string &deviceId) const {
+  return NodeTopic(messageType) + "/" + deviceId;
+}
+
+std::string SparkplugNode::NextDeathPayload() {
+  m_bdSeq = nextBdSeq();
+  return DeathPayload();
+}
+
+std::string SparkplugNode::DeathPayload() const {
+  Util::SparkplugB::Payload_t payload;
+  payload.timestamp = nowMilliseconds();
+  payload.metrics.push_back(bdSeqMetric(m_bdSeq));
+  return Util::SparkplugB::Encode(payload);
+}
+
+void SparkplugNode::PublishBirth(IPublisher &publisher) {
+  Util::SparkplugB::Payload_t payload;
+  payload.metrics.push_back(bdSeqMetric(m_bdSeq));
+  Util::SparkplugB::Metric_t rebirth;
+  rebirth.name = RebirthMetric;
+  rebirth.dataType = Util::SparkplugB::DataType_t::Boolean;
+  payload.metrics.push_back(rebirth);
+
+  PublishOptions options;
+  options.Retain = false;
+  options.Compressible = false;
+  options.TopicClass = "sparkplug";
+  options.Sequenced = true;
+  std::lock_guard<std::mutex> l(m_mutex);
+  payload.timestamp = nowMilliseconds();
+  payload.seq = 0;
+  m_seq = 1;
+  ++m_birthGeneration;
+  publisher.Publish(NodeTopic("NBIRTH"), Util::SparkplugB::Encode(payload), options);
+}
+
+bool SparkplugNode::HandleCommand(IPublisher &publisher, const std::string &payload) {
+  Util::SparkplugB::Payload_t command;
+  if (!Util::SparkplugB::Decode(payload, command)) {
+    return false;
+  }
+  for (const auto &metric : command.metrics) {
+    if (metric.name == RebirthMetric && metric.dataType == Util::SparkplugB::DataType_t::Boolean && metric.booleanValue) {
+      PublishBirth(publisher);
+      break;
+    }
+  }
+  return true;
+}
+
+std::uint64_t SparkplugNode::AllocateAliases(std::size_t count) {
+  std::lock_guard<std::mutex> l(m_mutex);
+  auto first = m_nextAlias;
+  m_nextAlias += count;
+  return first;
+}
+
+bool SparkplugNode::Publish(
+  IPublisher &publisher, const std::string &topic, Util::SparkplugB::Payload_t payload, PublishOptions options, std::uint64_t birthGeneration) {
+  options.Retain = false;
+  options.Compressible = false;
+  options.Sequenced = true;
+  std::lock_guard<std::mutex> l(m_mutex);
+  if (birthGeneration != m_birthGeneration) {
+    return false;
+  }
+  payload.timestamp = nowMilliseconds();
+  payload.seq = m_seq;
+  m_seq = (m_seq + 1) % SequenceModulo;
+  publisher.Publish(topic, Util::SparkplugB::Encode(payload), options);
+  return true;
+}
+}  // namespace Dashboard
+}  // namespace Umati
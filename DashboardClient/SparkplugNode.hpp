@@ -0,0 +1,75 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <SparkplugB.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "IPublisher.hpp"
+
+namespace Umati {
+namespace Dashboard {
+/**
+ * State of the client as Sparkplug B edge node, shared by the MQTT publisher and all DashboardClients (the devices).
+ *
+ * The sequence number covers all messages of the node, so it is assigned in the order the messages are handed to the publisher.
+ * Metric aliases are unique within the node.
+ */
+class SparkplugNode {
+ public:
+  /// deathAsWill registers the NDEATH as MQTT last will instead of the client offline state
+  SparkplugNode(std::string groupId, std::string edgeNodeId, bool deathAsWill = true);
+
+  /// spBv1.0/<GroupId>/<messageType>/<EdgeNodeId>
+  std::string NodeTopic(const std::string &messageType) const;
+  /// spBv1.0/<GroupId>/<messageType>/<EdgeNodeId>/<deviceId>
+  std::string DeviceTopic(const std::string &messageType, const std::string &deviceId) const;
+
+  /// Whether the NDEATH replaces the client offline state as last will, a connection can only have one
+  bool DeathAsWill() const { return m_deathAsWill; }
+
+  /// Assigns the next bdSeq and returns the NDEATH with it. Call before each CONNECT, the following NBIRTH carries the same bdSeq.
+  std::string NextDeathPayload();
+
+  /// NDEATH with the bdSeq of the current connection, e.g. to publish it on a regular shutdown
+  std::string DeathPayload() const;
+
+  /// Publishes NBIRTH, which restarts the sequence numbers and requires a new DBIRTH of every device.
+  /// Call after each connect and whenever a message of the node was lost.
+  void PublishBirth(IPublisher &publisher);
+
+  /// Handles an NCMD payload, a "Node Control/Rebirth" request publishes NBIRTH. Returns false if the payload is invalid.
+  bool HandleCommand(IPublisher &publisher, const std::string &payload);
+
+  /// Incremented by PublishBirth, a device born in an older generation has to publish DBIRTH again
+  std::uint64_t BirthGeneration() const { return m_birthGeneration; }
+
+  /// Returns the first of count consecutive aliases
+  std::uint64_t AllocateAliases(std::size_t count);
+
+  /// Sets the timestamp and the sequence number of payload and publishes it (not retained, not compressed, sequenced).
+  /// Returns false without publishing if birthGeneration is outdated.
+  bool Publish(IPublisher &publisher, const std::string &topic, Util::SparkplugB::Payload_t payload, PublishOptions options, std::uint64_t birthGeneration);
+
+ private:
+  const std::string m_groupId;
+  const std::string m_edgeNodeId;
+  const bool m_deathAsWill;
+  std::atomic<std::uint64_t> m_bdSeq{0};
+
+  std::mutex m_mutex;
+  std::uint64_t m_seq = 0;
+  /// Changed under m_mutex
+  std::atomic<std::uint64_t> m_birthGeneration{0};
+  std::uint64_t m_nextAlias = 1;
+};
+}  // namespace Dashboard
+}  // namespace Umati
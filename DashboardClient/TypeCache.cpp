@@ -0,0 +1,395 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "TypeCache.hpp"
+
+#include <easylogging++.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Umati {
+namespace Dashboard {
+namespace TypeCache {
+namespace {
+const char Magic[8] = {'U', 'M', 'A', 'T', 'I', 'T', 'Y', 'P'};
+/// Increment on every change of the layout or of the model built by OpcUaTypeReader
+const std::uint32_t FormatVersion = 1;
+/// Child list index of a node without child list
+const std::uint32_t NoList = UINT32_MAX;
+/// Words per record: NodeClass, ModellingRule, ReferenceType (2 strings), SpecifiedTypeNodeId (2), SpecifiedBrowseName (2),
+/// ofBaseDataVariableType, child list
+const std::size_t NodeRecordWords = 10;
+/// NodeId (2 strings), node
+const std::size_t TypeRecordWords = 3;
+/// Name, NodeId (2 strings)
+const std::size_t NameRecordWords = 3;
+
+typedef std::list<std::shared_ptr<ModelOpcUa::StructureNode>> ChildList_t;
+
+/// Read only content of a file, memory mapped where available
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      return;
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_data = reinterpret_cast<const unsigned char *>(m_buffer.data());
+    m_size = m_buffer.size();
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return;
+    }
+    struct stat status;
+    if (fstat(fd, &status) == 0 && status.st_size > 0) {
+      void *mapped = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped != MAP_FAILED) {
+        m_data = static_cast<const unsigned char *>(mapped);
+        m_size = static_cast<std::size_t>(status.st_size);
+      }
+    }
+    close(fd);
+#endif
+  }
+
+  ~MappedFile() {
+#ifndef _WIN32
+    if (m_data != nullptr) {
+      munmap(const_cast<unsigned char *>(m_data), m_size);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool IsOpen() const { return m_data != nullptr; }
+  const unsigned char *Data() const { return m_data; }
+  std::size_t Size() const { return m_size; }
+
+ private:
+#ifdef _WIN32
+  std::string m_buffer;
+#endif
+  const unsigned char *m_data = nullptr;
+  std::size_t m_size = 0;
+};
+
+std::uint32_t wordAt(const unsigned char *words, std::size_t index) {
+  const unsigned char *word = words + 4 * index;
+  return static_cast<std::uint32_t>(word[0]) | static_cast<std::uint32_t>(word[1]) << 8 | static_cast<std::uint32_t>(word[2]) << 16 |
+         static_cast<std::uint32_t>(word[3]) << 24;
+}
+
+void appendWord(std::string &target, std::uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    target.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+/// Sequential access to the file with bounds checks, a damaged file results in a std::runtime_error
+class Reader {
+ public:
+  Reader(const unsigned char *data, std::size_t size) : m_data(data), m_size(size) {}
+
+  const unsigned char *Bytes(std::size_t count) {
+    if (count > m_size - m_position) {
+      throw std::runtime_error("Unexpected end of file");
+    }
+    const unsigned char *bytes = m_data + m_position;
+    m_position += count;
+    return bytes;
+  }
+
+  /// Start of count little endian 32 bit words, read with wordAt
+  const unsigned char *Words(std::size_t count) {
+    if (count > (m_size - m_position) / 4) {
+      throw std::runtime_error("Unexpected end of file");
+    }
+    return Bytes(4 * count);
+  }
+
+  std::uint32_t Word() { return wordAt(Words(1), 0); }
+
+  void Align() { Bytes((4 - m_position % 4) % 4); }
+
+  std::size_t Remaining() const { return m_size - m_position; }
+
+ private:
+  const unsigned char *m_data;
+  std::size_t m_size;
+  std::size_t m_position = 0;
+};
+
+std::uint32_t checkedIndex(std::uint32_t index, std::size_t count) {
+  if (index >= count) {
+    throw std::runtime_error("Index out of range");
+  }
+  return index;
+}
+
+/// Assigns indices to the strings, nodes and child lists of the model
+class ModelIndex {
+ public:
+  std::uint32_t String(const std::string &value) {
+    auto it = m_stringIndices.emplace(value, static_cast<std::uint32_t>(m_strings.size()));
+    if (it.second) {
+      m_strings.push_back(value);
+    }
+    return it.first->second;
+  }
+
+  std::uint32_t Node(const std::shared_ptr<ModelOpcUa::StructureNode> &pNode) {
+    if (!pNode) {
+      throw std::runtime_error("Type model contains an empty node");
+    }
+    auto it = m_nodeIndices.emplace(pNode.get(), static_cast<std::uint32_t>(m_nodes.size()));
+    if (it.second) {
+      m_nodes.push_back(pNode.get());
+    }
+    return it.first->second;
+  }
+
+  /// Indexes the nodes reachable from the nodes indexed so far, breadth first to avoid a deep recursion
+  void IndexChildren() {
+    for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+      const ChildList_t *pChildren = m_nodes[i]->SpecifiedChildNodes.get();
+      if (pChildren == nullptr || !m_listIndices.emplace(pChildren, static_cast<std::uint32_t>(m_lists.size())).second) {
+        continue;
+      }
+      m_lists.push_back(pChildren);
+      for (const auto &pChild : *pChildren) {
+        Node(pChild);
+      }
+    }
+  }
+
+  std::uint32_t List(const ChildList_t *pChildren) const { return pChildren == nullptr ? NoList : m_listIndices.at(pChildren); }
+
+  const std::vector<std::string> &Strings() const { return m_strings; }
+  const std::vector<const ModelOpcUa::StructureNode *> &Nodes() const { return m_nodes; }
+  const std::vector<const ChildList_t *> &Lists() const { return m_lists; }
+
+ private:
+  std::vector<std::string> m_strings;
+  std::unordered_map<std::string, std::uint32_t> m_stringIndices;
+  std::vector<const ModelOpcUa::StructureNode *> m_nodes;
+  std::unordered_map<const ModelOpcUa::StructureNode *, std::uint32_t> m_nodeIndices;
+  std::vector<const ChildList_t *> m_lists;
+  std::unordered_map<const ChildList_t *, std::uint32_t> m_listIndices;
+};
+
+bool isNodeClass(std::uint32_t value) { return value != 0 && value <= ModelOpcUa::View && (value & (value - 1)) == 0; }
+
+void load(const MappedFile &file, const std::string &key, TypeMap_t &typeMap, NameToId_t &nameToId) {
+  Reader reader(file.Data(), file.Size());
+  if (std::memcmp(reader.Bytes(sizeof(Magic)), Magic, sizeof(Magic)) != 0) {
+    throw std::runtime_error("Not a type cache");
+  }
+  if (reader.Word() != FormatVersion) {
+    throw std::runtime_error("Other format version");
+  }
+  std::uint32_t keySize = reader.Word();
+  if (keySize != key.size() || std::memcmp(reader.Bytes(keySize), key.data(), keySize) != 0) {
+    throw std::runtime_error("Written for another server or configuration");
+  }
+  reader.Align();
+
+  const std::uint32_t stringCount = reader.Word();
+  const std::uint32_t nodeCount = reader.Word();
+  const std::uint32_t listCount = reader.Word();
+  const std::uint32_t listEntryCount = reader.Word();
+  const std::uint32_t typeCount = reader.Word();
+  const std::uint32_t nameCount = reader.Word();
+  const unsigned char *stringOffsets = reader.Words(std::size_t(stringCount) + 1);
+  const unsigned char *nodeRecords = reader.Words(std::size_t(nodeCount) * NodeRecordWords);
+  const unsigned char *listOffsets = reader.Words(std::size_t(listCount) + 1);
+  const unsigned char *listEntries = reader.Words(listEntryCount);
+  const unsigned char *typeRecords = reader.Words(std::size_t(typeCount) * TypeRecordWords);
+  const unsigned char *nameRecords = reader.Words(std::size_t(nameCount) * NameRecordWords);
+  const std::size_t stringDataSize = reader.Remaining();
+  const char *stringData = reinterpret_cast<const char *>(reader.Bytes(stringDataSize));
+
+  std::vector<std::string> strings;
+  strings.reserve(stringCount);
+  for (std::uint32_t i = 0; i < stringCount; ++i) {
+    std::uint32_t begin = wordAt(stringOffsets, i);
+    std::uint32_t end = wordAt(stringOffsets, i + 1);
+    if (begin > end || end > stringDataSize) {
+      throw std::runtime_error("Invalid string offset");
+    }
+    strings.emplace_back(stringData + begin, end - begin);
+  }
+  auto string = [&](const unsigned char *record, std::size_t word) -> const std::string & {
+    return strings[checkedIndex(wordAt(record, word), strings.size())];
+  };
+
+  std::vector<std::shared_ptr<ChildList_t>> lists;
+  lists.reserve(listCount);
+  for (std::uint32_t i = 0; i < listCount; ++i) {
+    lists.push_back(std::make_shared<ChildList_t>());
+  }
+
+  std::vector<std::shared_ptr<ModelOpcUa::StructureNode>> nodes;
+  nodes.reserve(nodeCount);
+  for (std::uint32_t i = 0; i < nodeCount; ++i) {
+    const unsigned char *record = nodeRecords + 4 * NodeRecordWords * i;
+    std::uint32_t nodeClass = wordAt(record, 0);
+    std::uint32_t modellingRule = wordAt(record, 1);
+    if (!isNodeClass(nodeClass) || modellingRule > ModelOpcUa::MandatoryPlaceholder) {
+      throw std::runtime_error("Invalid node");
+    }
+    std::uint32_t list = wordAt(record, 9);
+    nodes.push_back(std::make_shared<ModelOpcUa::StructureNode>(static_cast<ModelOpcUa::NodeClass_t>(nodeClass),
+                                                                static_cast<ModelOpcUa::ModellingRule_t>(modellingRule),
+                                                                ModelOpcUa::NodeId_t{string(record, 2), string(record, 3)},
+                                                                ModelOpcUa::NodeId_t{string(record, 4), string(record, 5)},
+                                                                ModelOpcUa::QualifiedName_t{string(record, 6), string(record, 7)},
+                                                                wordAt(record, 8) != 0,
+                                                                list == NoList ? nullptr : lists[checkedIndex(list, lists.size())]));
+  }
+
+  for (std::uint32_t i = 0; i < listCount; ++i) {
+    std::uint32_t begin = wordAt(listOffsets, i);
+    std::uint32_t end = wordAt(listOffsets, i + 1);
+    if (begin > end || end > listEntryCount) {
+      throw std::runtime_error("Invalid list offset");
+    }
+    for (std::uint32_t entry = begin; entry < end; ++entry) {
+      lists[i]->push_back(nodes[checkedIndex(wordAt(listEntries, entry), nodes.size())]);
+    }
+  }
+
+  TypeMap_t loadedTypeMap;
+  for (std::uint32_t i = 0; i < typeCount; ++i) {
+    const unsigned char *record = typeRecords + 4 * TypeRecordWords * i;
+    loadedTypeMap.emplace(ModelOpcUa::NodeId_t{string(record, 0), string(record, 1)}, nodes[checkedIndex(wordAt(record, 2), nodes.size())]);
+  }
+  NameToId_t loadedNameToId;
+  for (std::uint32_t i = 0; i < nameCount; ++i) {
+    const unsigned char *record = nameRecords + 4 * NameRecordWords * i;
+    loadedNameToId.emplace(string(record, 0), ModelOpcUa::NodeId_t{string(record, 1), string(record, 2)});
+  }
+  typeMap = std::move(loadedTypeMap);
+  nameToId = std::move(loadedNameToId);
+}
+}  // namespace
+
+bool Load(const std::string &path, const std::string &key, TypeMap_t &typeMap, NameToId_t &nameToId) {
+  MappedFile file(path);
+  if (!file.IsOpen()) {
+    return false;
+  }
+  try {
+    load(file, key, typeMap, nameToId);
+    return true;
+  } catch (const std::runtime_error &ex) {
+    LOG(INFO) << "Type cache " << path << " not used: " << ex.what();
+    return false;
+  }
+}
+
+void Store(const std::string &path, const std::string &key, const TypeMap_t &typeMap, const NameToId_t &nameToId) {
+  ModelIndex index;
+  std::string typeRecords;
+  for (const auto &type : typeMap) {
+    appendWord(typeRecords, index.String(type.first.Uri));
+    appendWord(typeRecords, index.String(type.first.Id));
+    appendWord(typeRecords, index.Node(type.second));
+  }
+  index.IndexChildren();
+  std::string nameRecords;
+  for (const auto &name : nameToId) {
+    appendWord(nameRecords, index.String(name.first));
+    appendWord(nameRecords, index.String(name.second.Uri));
+    appendWord(nameRecords, index.String(name.second.Id));
+  }
+
+  std::string nodeRecords;
+  for (const auto *pNode : index.Nodes()) {
+    appendWord(nodeRecords, pNode->NodeClass);
+    appendWord(nodeRecords, pNode->ModellingRule);
+    appendWord(nodeRecords, index.String(pNode->ReferenceType.Uri));
+    appendWord(nodeRecords, index.String(pNode->ReferenceType.Id));
+    appendWord(nodeRecords, index.String(pNode->SpecifiedTypeNodeId.Uri));
+    appendWord(nodeRecords, index.String(pNode->SpecifiedTypeNodeId.Id));
+    appendWord(nodeRecords, index.String(pNode->SpecifiedBrowseName.Uri));
+    appendWord(nodeRecords, index.String(pNode->SpecifiedBrowseName.Name));
+    appendWord(nodeRecords, pNode->ofBaseDataVariableType ? 1 : 0);
+    appendWord(nodeRecords, index.List(pNode->SpecifiedChildNodes.get()));
+  }
+  std::string listOffsets;
+  std::string listEntries;
+  std::uint32_t listEntryCount = 0;
+  for (const auto *pChildren : index.Lists()) {
+    appendWord(listOffsets, listEntryCount);
+    for (const auto &pChild : *pChildren) {
+      appendWord(listEntries, index.Node(pChild));
+      ++listEntryCount;
+    }
+  }
+  appendWord(listOffsets, listEntryCount);
+  std::string stringOffsets;
+  std::string stringData;
+  for (const auto &string : index.Strings()) {
+    appendWord(stringOffsets, static_cast<std::uint32_t>(stringData.size()));
+    stringData.append(string);
+  }
+  appendWord(stringOffsets, static_cast<std::uint32_t>(stringData.size()));
+
+  std::string header(Magic, sizeof(Magic));
+  appendWord(header, FormatVersion);
+  appendWord(header, static_cast<std::uint32_t>(key.size()));
+  header.append(key);
+  header.append((4 - header.size() % 4) % 4, '\0');
+  appendWord(header, static_cast<std::uint32_t>(index.Strings().size()));
+  appendWord(header, static_cast<std::uint32_t>(index.Nodes().size()));
+  appendWord(header, static_cast<std::uint32_t>(index.Lists().size()));
+  appendWord(header, listEntryCount);
+  appendWord(header, static_cast<std::uint32_t>(typeMap.size()));
+  appendWord(header, static_cast<std::uint32_t>(nameToId.size()));
+
+  // Written to a temporary file first, so a crash never leaves a truncated cache behind
+  const std::string temporaryPath = path + ".tmp";
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    for (const auto *pPart : {&header, &stringOffsets, &nodeRecords, &listOffsets, &listEntries, &typeRecords, &nameRecords, &stringData}) {
+      file.write(pPart->data(), static_cast<std::streamsize>(pPart->size()));
+    }
+    if (!file.flush()) {
+      std::remove(temporaryPath.c_str());
+      throw std::runtime_error("Could not write " + temporaryPath);
+    }
+  }
+#ifdef _WIN32
+  std::remove(path.c_str());
+#endif
+  if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+    std::remove(temporaryPath.c_str());
+    throw std::runtime_error("Could not replace " + path);
+  }
+}
+}  // namespace TypeCache
+}  // namespace Dashboard
+}  // namespace Umati
@@ -0,0 +1,36 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <ModelOpcUa/ModelDefinition.hpp>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace Umati {
+namespace Dashboard {
+/**
+ * Binary file of the type model built by OpcUaTypeReader, so a restart does not need to browse the type hierarchy again.
+ *
+ * The file consists of fixed size little endian records referring to each other by index (nodes, child lists, strings), it is
+ * memory mapped and converted to the StructureNodes in one pass. Child lists shared by several nodes stay shared.
+ * The file is only used if it was written with the same key, the caller derives it from everything the type model depends on.
+ */
+namespace TypeCache {
+typedef std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureNode>> TypeMap_t;
+typedef std::map<std::string, ModelOpcUa::NodeId_t> NameToId_t;
+
+/// Returns false if the file does not exist, was written for another key or format version or is damaged.
+/// typeMap and nameToId are only changed on success.
+bool Load(const std::string &path, const std::string &key, TypeMap_t &typeMap, NameToId_t &nameToId);
+
+/// Replaces the file atomically, throws std::runtime_error if it can not be written
+void Store(const std::string &path, const std::string &key, const TypeMap_t &typeMap, const NameToId_t &nameToId);
+}  // namespace TypeCache
+}  // namespace Dashboard
+}  // namespace Umati
@@ -0,0 +1,117 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "DataTypeDefinition.hpp"
+
+#include <easylogging++.h>
+
+#include <utility>
+
+#include "../NodeIdsWellKnown.hpp"
+
+namespace Umati {
+namespace TypeDictionary {
+namespace {
+/// Abstract DataTypes of namespace 0, fields of these types are encoded as Variant like in the TypeDictionaries
+const std::set<ModelOpcUa::NodeId_t> &variantDataTypes() {
+  static const std::set<ModelOpcUa::NodeId_t> dataTypes{
+    Dashboard::NodeId_BaseDataType,
+    ModelOpcUa::NodeId_t{Dashboard::ns0Uri, "i=26"},  // Number
+    ModelOpcUa::NodeId_t{Dashboard::ns0Uri, "i=27"},  // Integer
+    ModelOpcUa::NodeId_t{Dashboard::ns0Uri, "i=28"}};  // UInteger
+  return dataTypes;
+}
+}  // namespace
+
+DataTypeDefinitionConverter::DataTypeDefinitionConverter(
+  std::map<ModelOpcUa::NodeId_t, ModelOpcUa::BrowseResult_t> customTypes, std::set<ModelOpcUa::NodeId_t> enumerations, BuiltinTypeName_t builtinTypeName)
+  : m_customTypes(std::move(customTypes)), m_enumerations(std::move(enumerations)), m_builtinTypeName(std::move(builtinTypeName)) {}
+
+std::string DataTypeDefinitionConverter::FieldTypeName(const ModelOpcUa::NodeId_t &dataType, const std::string &targetNamespace) const {
+  if (dataType.Uri == Dashboard::ns0Uri) {
+    if (variantDataTypes().count(dataType) != 0) {
+      return "ua:Variant";
+    }
+    if (dataType == Dashboard::NodeId_Enumeration) {
+      return "opc:Int32";
+    }
+    return m_builtinTypeName(dataType);
+  }
+  auto it = m_customTypes.find(dataType);
+  if (it == m_customTypes.end()) {
+    return std::string();
+  }
+  if (dataType.Uri != targetNamespace) {
+    // Structures of other TypeDictionaries are not resolved by buildCustomDataTypes, enumerations are encoded as Int32
+    return m_enumerations.count(dataType) != 0 ? "opc:Int32" : dataType.Uri + ":" + it->second.BrowseName.Name;
+  }
+  return "tns:" + it->second.BrowseName.Name;
+}
+
+bool DataTypeDefinitionConverter::AddStructuredType(const ModelOpcUa::BrowseResult_t &type, const StructureDefinition_t &definition) {
+  if (definition.StructureType == StructureDefinition_t::StructureType_t::Union) {
+    LOG(INFO) << "Unions are not supported, skipping DataType: " << static_cast<std::string>(type.NodeId);
+    return true;
+  }
+  // Abstract DataTypes without fields can not be encoded
+  if (definition.Fields.empty() || definition.DefaultEncodingId.isNull()) {
+    return true;
+  }
+  StructuredType stype{};
+  stype.Name = type.BrowseName.Name;
+  stype.BaseType = FieldTypeName(definition.BaseDataType, type.NodeId.Uri);
+  stype.NodeId = type.NodeId;
+  stype.BinaryNodeId = definition.DefaultEncodingId;
+  for (const auto &structureField : definition.Fields) {
+    Field field{};
+    field.Name = structureField.Name;
+    field.TypeName = FieldTypeName(structureField.DataType, type.NodeId.Uri);
+    if (field.TypeName.empty()) {
+      LOG(INFO) << "Unable to resolve DataType of field " << field.Name << " of " << type.NodeId.Uri << " " << stype.Name;
+      return false;
+    }
+    if (structureField.ValueRank >= 1) {
+      field.LengthField = "NoOf" + field.Name;
+    }
+    if (definition.StructureType == StructureDefinition_t::StructureType_t::StructureWithOptionalFields && structureField.IsOptional) {
+      // Like the switch bits of the TypeDictionary, they mark the type as optional structure
+      Field switchBit{};
+      switchBit.TypeName = "opc:Bit";
+      switchBit.Name = field.Name + "Specified";
+      switchBit.Length = 1;
+      field.SwitchField = switchBit.Name;
+      stype.Fields.push_back(switchBit);
+    }
+    stype.Fields.push_back(field);
+  }
+  auto &td = m_dictionaries[type.NodeId.Uri];
+  td.TargetNamespace = type.NodeId.Uri;
+  td.StructuredTypes.push_back(stype);
+  return true;
+}
+
+void DataTypeDefinitionConverter::AddEnumeratedType(const ModelOpcUa::BrowseResult_t &type, std::vector<EnumeratedValue> values) {
+  EnumeratedType etype{};
+  etype.Name = type.BrowseName.Name;
+  etype.LengthInBits = 32;
+  etype.NodeId = type.NodeId;
+  etype.EnumeratedValues = std::move(values);
+  auto &td = m_dictionaries[type.NodeId.Uri];
+  td.TargetNamespace = type.NodeId.Uri;
+  td.EnumeratedTypes.push_back(etype);
+}
+
+std::vector<TypeDictionary> DataTypeDefinitionConverter::TakeDictionaries() {
+  std::vector<TypeDictionary> ret;
+  for (auto &dictionary : m_dictionaries) {
+    ret.push_back(std::move(dictionary.second));
+  }
+  m_dictionaries.clear();
+  return ret;
+}
+}  // namespace TypeDictionary
+}  // namespace Umati
@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <ModelOpcUa/ModelDefinition.hpp>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "TypeDictionary.hpp"
+
+namespace Umati {
+namespace TypeDictionary {
+/// Field of a StructureDefinition attribute (OPC UA 1.04), with the NodeIds already resolved to namespace URIs
+struct StructureFieldDefinition_t {
+  std::string Name;
+  ModelOpcUa::NodeId_t DataType;
+  std::int32_t ValueRank = -1;
+  bool IsOptional = false;
+};
+
+struct StructureDefinition_t {
+  enum class StructureType_t { Structure, StructureWithOptionalFields, Union };
+  StructureType_t StructureType = StructureType_t::Structure;
+  ModelOpcUa::NodeId_t BaseDataType;
+  /// Null for abstract DataTypes
+  ModelOpcUa::NodeId_t DefaultEncodingId;
+  std::vector<StructureFieldDefinition_t> Fields;
+};
+
+/**
+ * Converts the DataTypeDefinition attributes of custom DataTypes into the TypeDictionaries the XML parser reads from the server,
+ * so buildCustomDataTypes of the client handles both the same way. Independent of open62541, the client resolves the DataTypes of
+ * namespace 0 with builtinTypeName.
+ */
+class DataTypeDefinitionConverter {
+ public:
+  /// Name of a DataType of namespace 0 in the TypeDictionaries, e.g. "opc:Int32", empty if it has none
+  using BuiltinTypeName_t = std::function<std::string(const ModelOpcUa::NodeId_t &dataType)>;
+
+  /// customTypes are the DataTypes outside namespace 0 that get a TypeDictionary, enumerations all enumerations of the server
+  DataTypeDefinitionConverter(
+    std::map<ModelOpcUa::NodeId_t, ModelOpcUa::BrowseResult_t> customTypes,
+    std::set<ModelOpcUa::NodeId_t> enumerations,
+    BuiltinTypeName_t builtinTypeName);
+
+  /// False if a field has a DataType without a name in the TypeDictionaries. Unions and abstract DataTypes are skipped.
+  bool AddStructuredType(const ModelOpcUa::BrowseResult_t &type, const StructureDefinition_t &definition);
+  void AddEnumeratedType(const ModelOpcUa::BrowseResult_t &type, std::vector<EnumeratedValue> values);
+
+  /// Name of the DataType of a field of a structure in targetNamespace, empty if it can not be resolved
+  std::string FieldTypeName(const ModelOpcUa::NodeId_t &dataType, const std::string &targetNamespace) const;
+
+  /// One TypeDictionary per namespace with the types added so far
+  std::vector<TypeDictionary> TakeDictionaries();
+
+ private:
+  std::map<ModelOpcUa::NodeId_t, ModelOpcUa::BrowseResult_t> m_customTypes;
+  std::set<ModelOpcUa::NodeId_t> m_enumerations;
+  BuiltinTypeName_t m_builtinTypeName;
+  std::map<std::string, TypeDictionary> m_dictionaries;
+};
+}  // namespace TypeDictionary
+}  // namespace Umati
@@ -0,0 +1,223 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "TypeModelSharing.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Umati {
+namespace Dashboard {
+namespace TypeModelSharing {
+namespace {
+typedef std::list<std::shared_ptr<ModelOpcUa::StructureNode>> ChildList_t;
+
+/// Use count, weak count and vtable of the control block std::make_shared puts in front of the object
+const std::size_t ControlBlockSize = 2 * sizeof(long) + sizeof(void *);
+
+void hashCombine(std::size_t &seed, std::size_t value) { seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2); }
+
+std::size_t hashString(const std::string &value) { return std::hash<std::string>()(value); }
+
+/// A node is identified by its own attributes and the identity of its (already shared) child list
+struct NodeHash {
+  std::size_t operator()(const std::shared_ptr<ModelOpcUa::StructureNode> &node) const {
+    std::size_t seed = node->NodeClass;
+    hashCombine(seed, node->ModellingRule);
+    hashCombine(seed, hashString(node->ReferenceType.Uri));
+    hashCombine(seed, hashString(node->ReferenceType.Id));
+    hashCombine(seed, hashString(node->SpecifiedTypeNodeId.Uri));
+    hashCombine(seed, hashString(node->SpecifiedTypeNodeId.Id));
+    hashCombine(seed, hashString(node->SpecifiedBrowseName.Uri));
+    hashCombine(seed, hashString(node->SpecifiedBrowseName.Name));
+    hashCombine(seed, node->ofBaseDataVariableType);
+    hashCombine(seed, std::hash<const ChildList_t *>()(node->SpecifiedChildNodes.get()));
+    return seed;
+  }
+};
+
+struct NodeEqual {
+  bool operator()(const std::shared_ptr<ModelOpcUa::StructureNode> &a, const std::shared_ptr<ModelOpcUa::StructureNode> &b) const {
+    return typeid(*a) == typeid(*b) && a->NodeClass == b->NodeClass && a->ModellingRule == b->ModellingRule &&
+           a->ReferenceType == b->ReferenceType && a->SpecifiedTypeNodeId == b->SpecifiedTypeNodeId &&
+           a->SpecifiedBrowseName == b->SpecifiedBrowseName && a->ofBaseDataVariableType == b->ofBaseDataVariableType &&
+           a->SpecifiedChildNodes == b->SpecifiedChildNodes;
+  }
+};
+
+/// A child list is identified by the identities of its (already shared) nodes
+struct ListHash {
+  std::size_t operator()(const std::shared_ptr<ChildList_t> &list) const {
+    std::size_t seed = list->size();
+    for (const auto &child : *list) {
+      hashCombine(seed, std::hash<const ModelOpcUa::StructureNode *>()(child.get()));
+    }
+    return seed;
+  }
+};
+
+struct ListEqual {
+  bool operator()(const std::shared_ptr<ChildList_t> &a, const std::shared_ptr<ChildList_t> &b) const {
+    return a->size() == b->size() && std::equal(a->begin(), a->end(), b->begin());
+  }
+};
+
+/// Shares the subtrees bottom up, each node and list is visited once
+class Sharing {
+ public:
+  /// The lists of the types are shared by reference and handled by the caller
+  void AddType(const ModelOpcUa::StructureNode &type) { m_typeLists.insert(type.SpecifiedChildNodes.get()); }
+
+  void ShareChildren(ChildList_t &children) {
+    for (auto &child : children) {
+      child = node(child);
+    }
+  }
+
+  /// Forgets the replaced nodes and lists, the remaining ones are returned as they are by later calls
+  void Prune() {
+    for (auto it = m_sharedNodes.begin(); it != m_sharedNodes.end();) {
+      it = it->first == it->second ? std::next(it) : m_sharedNodes.erase(it);
+    }
+    for (auto it = m_sharedLists.begin(); it != m_sharedLists.end();) {
+      it = it->first == it->second ? std::next(it) : m_sharedLists.erase(it);
+    }
+  }
+
+ private:
+  std::shared_ptr<ModelOpcUa::StructureNode> node(const std::shared_ptr<ModelOpcUa::StructureNode> &node) {
+    auto it = m_sharedNodes.find(node);
+    if (it != m_sharedNodes.end()) {
+      return it->second;
+    }
+    node->SpecifiedChildNodes = childList(node->SpecifiedChildNodes);
+    auto sharedNode = *m_uniqueNodes.insert(node).first;
+    m_sharedNodes.emplace(node, sharedNode);
+    return sharedNode;
+  }
+
+  std::shared_ptr<ChildList_t> childList(const std::shared_ptr<ChildList_t> &list) {
+    if (list == nullptr || m_typeLists.count(list.get()) != 0) {
+      return list;
+    }
+    auto it = m_sharedLists.find(list);
+    if (it != m_sharedLists.end()) {
+      return it->second;
+    }
+    if (!m_inProgress.insert(list.get()).second) {
+      return list;
+    }
+    ShareChildren(*list);
+    m_inProgress.erase(list.get());
+    auto sharedList = *m_uniqueLists.insert(list).first;
+    m_sharedLists.emplace(list, sharedList);
+    return sharedList;
+  }
+
+  std::unordered_set<const ChildList_t *> m_typeLists;
+  std::unordered_set<const ChildList_t *> m_inProgress;
+  std::unordered_set<std::shared_ptr<ModelOpcUa::StructureNode>, NodeHash, NodeEqual> m_uniqueNodes;
+  std::unordered_set<std::shared_ptr<ChildList_t>, ListHash, ListEqual> m_uniqueLists;
+  /// Keyed by the owning pointer, so a replaced node or list can not be freed and its address reused while sharing
+  std::unordered_map<std::shared_ptr<ModelOpcUa::StructureNode>, std::shared_ptr<ModelOpcUa::StructureNode>> m_sharedNodes;
+  std::unordered_map<std::shared_ptr<ChildList_t>, std::shared_ptr<ChildList_t>> m_sharedLists;
+};
+
+std::size_t heapSize(const std::string &value) {
+  auto data = value.data();
+  auto object = reinterpret_cast<const char *>(&value);
+  // Short strings are stored inside the object
+  if (data >= object && data < object + sizeof(value)) {
+    return 0;
+  }
+  return value.capacity() + 1;
+}
+
+std::size_t heapSize(const ModelOpcUa::StructureNode &node) {
+  return ControlBlockSize + sizeof(node) + heapSize(node.ReferenceType.Uri) + heapSize(node.ReferenceType.Id) +
+         heapSize(node.SpecifiedTypeNodeId.Uri) + heapSize(node.SpecifiedTypeNodeId.Id) + heapSize(node.SpecifiedBrowseName.Uri) +
+         heapSize(node.SpecifiedBrowseName.Name);
+}
+
+std::size_t heapSize(const ChildList_t &list) {
+  // Each list element holds the shared_ptr and the links to its neighbours
+  return ControlBlockSize + sizeof(list) + list.size() * (sizeof(ChildList_t::value_type) + 2 * sizeof(void *));
+}
+}  // namespace
+
+Statistics_t Measure(const TypeMap_t &typeMap) {
+  Statistics_t statistics;
+  std::unordered_set<const ModelOpcUa::StructureNode *> nodes;
+  std::unordered_set<const ChildList_t *> lists;
+  std::vector<const ModelOpcUa::StructureNode *> pending;
+  for (const auto &type : typeMap) {
+    if (nodes.insert(type.second.get()).second) {
+      pending.push_back(type.second.get());
+    }
+  }
+  while (!pending.empty()) {
+    auto node = pending.back();
+    pending.pop_back();
+    statistics.Bytes += heapSize(*node);
+    auto list = node->SpecifiedChildNodes.get();
+    if (list == nullptr || !lists.insert(list).second) {
+      continue;
+    }
+    statistics.Bytes += heapSize(*list);
+    for (const auto &child : *list) {
+      if (nodes.insert(child.get()).second) {
+        pending.push_back(child.get());
+      }
+    }
+  }
+  statistics.Nodes = nodes.size();
+  statistics.ChildLists = lists.size();
+  return statistics;
+}
+
+void Share(TypeMap_t &typeMap) {
+  Sharing sharing;
+  for (const auto &type : typeMap) {
+    sharing.AddType(*type.second);
+  }
+  for (auto &type : typeMap) {
+    if (type.second->SpecifiedChildNodes != nullptr) {
+      sharing.ShareChildren(*type.second->SpecifiedChildNodes);
+    }
+  }
+}
+
+struct IncrementalSharing::Table {
+  Sharing sharing;
+};
+
+IncrementalSharing::IncrementalSharing() : m_pTable(new Table()) {}
+
+IncrementalSharing::~IncrementalSharing() = default;
+
+void IncrementalSharing::Share(const std::vector<std::shared_ptr<ModelOpcUa::StructureNode>> &addedTypes) {
+  for (const auto &type : addedTypes) {
+    m_pTable->sharing.AddType(*type);
+  }
+  for (const auto &type : addedTypes) {
+    if (type->SpecifiedChildNodes != nullptr) {
+      m_pTable->sharing.ShareChildren(*type->SpecifiedChildNodes);
+    }
+  }
+  // Replaced nodes and lists are no longer reachable from the types, a later call sees them as new ones
+  m_pTable->sharing.Prune();
+}
+}  // namespace TypeModelSharing
+}  // namespace Dashboard
+}  // namespace Umati
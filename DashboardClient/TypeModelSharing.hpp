@@ -0,0 +1,60 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <ModelOpcUa/ModelDefinition.hpp>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Umati {
+namespace Dashboard {
+/**
+ * Structural sharing of the type model built by OpcUaTypeReader.
+ *
+ * Instance declarations with the same definition, e.g. the properties of an identification or the children of a state machine,
+ * are created once per type that declares them. Share replaces structurally equal StructureNodes and child lists by one instance,
+ * so the type model must not be modified afterwards. The child lists of the types themselves are kept, children refer to them
+ * after OpcUaTypeReader::updateTypeMap and may form cycles through them.
+ */
+namespace TypeModelSharing {
+typedef std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureNode>> TypeMap_t;
+
+struct Statistics_t {
+  std::size_t Nodes = 0;
+  std::size_t ChildLists = 0;
+  /// Estimated heap size of the nodes, child lists and strings, without allocator overhead
+  std::size_t Bytes = 0;
+};
+
+/// Counts each node and child list reachable from the types once
+Statistics_t Measure(const TypeMap_t &typeMap);
+
+void Share(TypeMap_t &typeMap);
+
+/**
+ * Shares types added to the type map later, e.g. read on their first use, with the types shared by earlier calls.
+ * The nodes and child lists shared before might be in use and are neither modified nor replaced, only new ones are.
+ * Each call only visits the new nodes and lists.
+ */
+class IncrementalSharing {
+ public:
+  IncrementalSharing();
+  ~IncrementalSharing();
+
+  /// Each type must be passed once, after its children refer to the child lists of their types
+  void Share(const std::vector<std::shared_ptr<ModelOpcUa::StructureNode>> &addedTypes);
+
+ private:
+  struct Table;
+  std::unique_ptr<Table> m_pTable;
+};
+}  // namespace TypeModelSharing
+}  // namespace Dashboard
+}  // namespace Umati
@@ -0,0 +1,69 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "UadpWriterGroup.hpp"
+
+namespace Umati {
+namespace Dashboard {
+UadpWriterGroup::UadpWriterGroup(const Util::UadpConfig &config, std::string publisherId)
+  : m_topicPrefix(config.TopicPrefix),
+    m_publisherId(config.PublisherId.empty() ? std::move(publisherId) : config.PublisherId),
+    m_writerGroup(config.WriterGroup),
+    m_writerGroupId(config.WriterGroupId),
+    m_keyFrameCount(config.KeyFrameCount) {}
+
+std::string UadpWriterGroup::DataTopic(const std::string &dataSetWriter) const { return topic("data", dataSetWriter); }
+
+std::string UadpWriterGroup::MetaDataTopic(const std::string &dataSetWriter) const { return topic("metadata", dataSetWriter); }
+
+std::uint16_t UadpWriterGroup::AllocateDataSetWriterId() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  if (m_nextDataSetWriterId == 0) {
+    // Wrapped around, only reached if machines are added and removed very often
+    m_nextDataSetWriterId = 1;
+  }
+  return m_nextDataSetWriterId++;
+}
+
+void UadpWriterGroup::PublishMetaData(
+  IPublisher &publisher, const std::string &dataSetWriter, std::uint16_t dataSetWriterId, const Util::Uadp::DataSetMetaData_t &metaData) {
+  PublishOptions options;
+  options.Compressible = false;
+  options.TopicClass = "uadp";
+  std::lock_guard<std::mutex> l(m_mutex);
+  Util::Uadp::NetworkMessageHeader_t header;
+  header.publisherId = m_publisherId;
+  header.sequenceNumber = m_discoverySequenceNumber++;
+  publisher.Publish(MetaDataTopic(dataSetWriter), Util::Uadp::EncodeMetaData(header, dataSetWriterId, metaData), options);
+}
+
+void UadpWriterGroup::ClearMetaData(IPublisher &publisher, const std::string &dataSetWriter) {
+  PublishOptions options;
+  options.Compressible = false;
+  options.TopicClass = "uadp";
+  publisher.Publish(MetaDataTopic(dataSetWriter), std::string(), options);
+}
+
+void UadpWriterGroup::PublishDataSetMessage(
+  IPublisher &publisher, const std::string &dataSetWriter, std::uint16_t dataSetWriterId, const Util::Uadp::DataSetMessage_t &message) {
+  PublishOptions options;
+  options.Retain = false;
+  options.Compressible = false;
+  options.TopicClass = "uadp";
+  std::lock_guard<std::mutex> l(m_mutex);
+  Util::Uadp::NetworkMessageHeader_t header;
+  header.publisherId = m_publisherId;
+  header.writerGroupId = m_writerGroupId;
+  header.sequenceNumber = m_sequenceNumber++;
+  publisher.Publish(DataTopic(dataSetWriter), Util::Uadp::EncodeDataSetMessage(header, dataSetWriterId, message), options);
+}
+
+std::string UadpWriterGroup::topic(const std::string &messageType, const std::string &dataSetWriter) const {
+  return m_topicPrefix + "/uadp/" + messageType + "/" + m_publisherId + "/" + m_writerGroup + "/" + dataSetWriter;
+}
+}  // namespace Dashboard
+}  // namespace Umati
@@ -0,0 +1,66 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <Configuration.hpp>
+#include <Uadp.hpp>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "IPublisher.hpp"
+
+namespace Umati {
+namespace Dashboard {
+/**
+ * The client as OPC UA PubSub publisher with a single WriterGroup, shared by all DashboardClients.
+ * Each machine is a DataSetWriter of the group.
+ *
+ * Topics follow the MQTT mapping of OPC UA Part 14:
+ * - <TopicPrefix>/uadp/data/<PublisherId>/<WriterGroup>/<DataSetWriter>
+ * - <TopicPrefix>/uadp/metadata/<PublisherId>/<WriterGroup>/<DataSetWriter> (retained)
+ */
+class UadpWriterGroup {
+ public:
+  /// publisherId replaces the empty PublisherId of config
+  UadpWriterGroup(const Util::UadpConfig &config, std::string publisherId);
+
+  std::string DataTopic(const std::string &dataSetWriter) const;
+  std::string MetaDataTopic(const std::string &dataSetWriter) const;
+
+  /// DataSetMessages between two key frames, including the key frame
+  std::uint32_t KeyFrameCount() const { return m_keyFrameCount; }
+
+  /// Returns an unused DataSetWriterId, 0 is never returned
+  std::uint16_t AllocateDataSetWriterId();
+
+  /// Publishes the metadata retained, so subscribers joining later can decode the DataSetMessages
+  void PublishMetaData(IPublisher &publisher, const std::string &dataSetWriter, std::uint16_t dataSetWriterId, const Util::Uadp::DataSetMetaData_t &metaData);
+
+  /// Removes the retained metadata of a DataSetWriter that stopped publishing
+  void ClearMetaData(IPublisher &publisher, const std::string &dataSetWriter);
+
+  /// Sets the sequence number of the NetworkMessage and publishes it (not retained, not compressed)
+  void PublishDataSetMessage(IPublisher &publisher, const std::string &dataSetWriter, std::uint16_t dataSetWriterId, const Util::Uadp::DataSetMessage_t &message);
+
+ private:
+  std::string topic(const std::string &messageType, const std::string &dataSetWriter) const;
+
+  const std::string m_topicPrefix;
+  const std::string m_publisherId;
+  const std::string m_writerGroup;
+  const std::uint16_t m_writerGroupId;
+  const std::uint32_t m_keyFrameCount;
+
+  std::mutex m_mutex;
+  std::uint16_t m_sequenceNumber = 0;
+  std::uint16_t m_discoverySequenceNumber = 0;
+  std::uint16_t m_nextDataSetWriterId = 1;
+};
+}  // namespace Dashboard
+}  // namespace Umati
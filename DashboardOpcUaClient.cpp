@@ -11,6 +11,7 @@
 #include "DashboardOpcUaClient.hpp"
 #include "MachineObserver/Topics.hpp"
 #include "Util/ClientVersion.hpp"
+#include <IdEncode.hpp>
 
 DashboardOpcUaClient::DashboardOpcUaClient(std::shared_ptr<Umati::Util::Configuration> configuration, std::function<void()> issueReset)
   : m_issueReset(issueReset),
@@ -24,20 +25,79 @@ DashboardOpcUaClient::DashboardOpcUaClient(std::shared_ptr<Umati::Util::Configur
       configuration->getObjectTypeNamespaces(),
       m_opcUaWrapper,
       configuration->getOpcUa().ByPassCertVerification)),
-    m_pPublisher(std::make_shared<Umati::MqttPublisher_Paho::MqttPublisher_Paho>(
-      configuration->getMqtt().Protocol,
-      configuration->getMqtt().Hostname,
-      configuration->getMqtt().Port,
-      configuration->getMqtt().CaCertPath,
-      configuration->getMqtt().CaTrustStorePath,
-      Umati::MachineObserver::Topics::ClientOnline(),
-      Umati::MachineObserver::Topics::GwVersion(),
-      gitClientVersion,
-      configuration->getMqtt().Username,
-      configuration->getMqtt().Password)),
+    m_pSparkplugNode(createSparkplugNode(configuration)),
+    m_pUadpWriterGroup(createUadpWriterGroup(configuration)),
+    m_pPublisher(createPublisher(configuration, m_pSparkplugNode)),
     m_pOpcUaTypeReader(
-      std::make_shared<Umati::Dashboard::OpcUaTypeReader>(m_pClient, configuration->getObjectTypeNamespaces(), configuration->getNamespaceInformations())),
-    m_machinesFilter(configuration->getMachinesFilter()) {}
+      std::make_shared<Umati::Dashboard::OpcUaTypeReader>(
+        m_pClient, configuration->getObjectTypeNamespaces(), configuration->getNamespaceInformations(), configuration->getOpcUa().TypeCacheFile,
+        configuration->getOpcUa().NodeSetFiles, configuration->getOpcUa().LazyTypes)),
+    m_machinesFilter(configuration->getMachinesFilter()),
+    m_publishConfig(configuration->getPublish()) {}
+
+std::shared_ptr<Umati::Dashboard::SparkplugNode> DashboardOpcUaClient::createSparkplugNode(const std::shared_ptr<Umati::Util::Configuration> &configuration) {
+  auto sparkplug = configuration->getPublish().Sparkplug;
+  if (!sparkplug.Enabled) {
+    return nullptr;
+  }
+  return std::make_shared<Umati::Dashboard::SparkplugNode>(
+    sparkplug.GroupId,
+    Umati::Util::IdEncode(sparkplug.EdgeNodeId.empty() ? configuration->getMqtt().ClientId : sparkplug.EdgeNodeId),
+    sparkplug.Will == "NDEATH");
+}
+
+std::shared_ptr<Umati::Dashboard::UadpWriterGroup> DashboardOpcUaClient::createUadpWriterGroup(const std::shared_ptr<Umati::Util::Configuration> &configuration) {
+  auto uadp = configuration->getPublish().Uadp;
+  if (!uadp.Enabled) {
+    return nullptr;
+  }
+  return std::make_shared<Umati::Dashboard::UadpWriterGroup>(uadp, Umati::Util::IdEncode(configuration->getMqtt().ClientId));
+}
+
+std::shared_ptr<Umati::Dashboard::IPublisher> DashboardOpcUaClient::createPublisher(
+  const std::shared_ptr<Umati::Util::Configuration> &configuration, const std::shared_ptr<Umati::Dashboard::SparkplugNode> &pSparkplugNode) {
+  auto publish = configuration->getPublish();
+  std::vector<std::pair<std::string, std::shared_ptr<Umati::Dashboard::IPublisher>>> sinks;
+  for (const auto &sink : publish.Sinks) {
+    if (sink == "mqtt") {
+      sinks.emplace_back(
+        sink,
+        std::make_shared<Umati::MqttPublisher_Paho::MqttPublisher_Paho>(
+          configuration->getMqtt().Protocol,
+          configuration->getMqtt().Hostname,
+          configuration->getMqtt().Port,
+          configuration->getMqtt().CaCertPath,
+          configuration->getMqtt().CaTrustStorePath,
+          Umati::MachineObserver::Topics::ClientOnline(),
+          Umati::MachineObserver::Topics::GwVersion(),
+          gitClientVersion,
+          configuration->getMqtt().Username,
+          configuration->getMqtt().Password,
+          publish.Compression,
+          Umati::MachineObserver::Topics::CompressionDictionaries(),
+          configuration->getMqtt().QueueSize,
+          configuration->getMqtt().OfflineBuffer,
+          configuration->getMqtt().V5,
+          pSparkplugNode));
+    } else if (sink == "file") {
+      sinks.emplace_back(sink, std::make_shared<Umati::Dashboard::FilePublisher>(publish.File));
+    }
+#ifdef UMATI_WITH_REDIS
+    else if (sink == "redis") {
+      sinks.emplace_back(sink, std::make_shared<Umati::RedisPublisher::RedisPublisher>(publish.Redis));
+    }
+#endif
+  }
+  // The MQTT publisher has its own queue and sender thread, the composite gives every other sink one as well
+  if (sinks.size() == 1 && sinks.front().first == "mqtt") {
+    return sinks.front().second;
+  }
+  auto pComposite = std::make_shared<Umati::Dashboard::CompositePublisher>();
+  for (auto &sink : sinks) {
+    pComposite->AddSink(sink.first, sink.second, publish.SinkQueueSize);
+  }
+  return pComposite;
+}
 
 bool DashboardOpcUaClient::connect(std::atomic_bool &running) {
   std::size_t i = 0;
@@ -60,25 +120,30 @@ void DashboardOpcUaClient::ReadTypeDictionaries() {
 }
 
 void DashboardOpcUaClient::StartMachineObserver() {
-  m_pMachineObserver = std::make_shared<Umati::MachineObserver::DashboardMachineObserver>(m_pClient, m_pPublisher, m_pOpcUaTypeReader, m_machinesFilter);
-  m_lastPublish = std::chrono::steady_clock::now();
+  m_pMachineObserver = std::make_shared<Umati::MachineObserver::DashboardMachineObserver>(
+    m_pClient, m_pPublisher, m_pOpcUaTypeReader, m_machinesFilter, m_publishConfig, m_pSparkplugNode, m_pUadpWriterGroup);
   m_lastConnectionVerify = std::chrono::steady_clock::now();
 }
 
 void DashboardOpcUaClient::Iterate() {
+  auto currentTime = std::chrono::steady_clock::now();
+  auto nextPublish = m_pMachineObserver->PublishDue(currentTime);
+
+  // Process OPC UA messages until the next machine is due, but return regularly to verify the connection
+  std::chrono::milliseconds timeout(100);
+  auto now = std::chrono::steady_clock::now();
+  if (nextPublish < now + timeout) {
+    // Round up, waking up before the deadline would only spin
+    auto remaining_us = std::chrono::duration_cast<std::chrono::microseconds>(nextPublish - now).count();
+    timeout = std::chrono::milliseconds(remaining_us > 0 ? (remaining_us + 999) / 1000 : 0);
+  }
   {
     std::lock_guard<std::recursive_mutex> l(m_pClient->m_clientMutex);
-    auto retval = UA_Client_run_iterate(m_pClient->m_pClient.get(), 100);
+    auto retval = UA_Client_run_iterate(m_pClient->m_pClient.get(), static_cast<UA_UInt32>(timeout.count()));
   }
 
-  std::this_thread::sleep_for(std::chrono::milliseconds(10));
-
-  auto currentTime = std::chrono::steady_clock::now();
-  auto pudDiff_ms = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - m_lastPublish).count();
-  if (pudDiff_ms > 900) {
-    m_lastPublish = currentTime;
-    m_pMachineObserver->PublishAll();
-  }
+  // Give the machine update thread a chance to take the client mutex
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
   auto diffConnVerify_ms = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - m_lastConnectionVerify).count();
   if (diffConnVerify_ms > 30000) {
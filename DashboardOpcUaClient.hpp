@@ -9,8 +9,15 @@
 
 #include "OpcUaClient/OpcUaClient.hpp"
 #include <DashboardClient.hpp>
+#include <SparkplugNode.hpp>
+#include <UadpWriterGroup.hpp>
 #include <OpcUaTypeReader.hpp>
 #include <MqttPublisher_Paho.hpp>
+#include <CompositePublisher.hpp>
+#include <FilePublisher.hpp>
+#ifdef UMATI_WITH_REDIS
+#include <RedisPublisher.hpp>
+#endif
 #include <DashboardMachineObserver.hpp>
 #include "Util/Configuration.hpp"
 #include "MachineObserver/Topics.hpp"
@@ -27,13 +34,23 @@ public:
     void StartMachineObserver();
     void Iterate();
 protected:
+    static std::shared_ptr<Umati::Dashboard::SparkplugNode> createSparkplugNode(const std::shared_ptr<Umati::Util::Configuration> &configuration);
+    static std::shared_ptr<Umati::Dashboard::UadpWriterGroup> createUadpWriterGroup(const std::shared_ptr<Umati::Util::Configuration> &configuration);
+    static std::shared_ptr<Umati::Dashboard::IPublisher> createPublisher(
+      const std::shared_ptr<Umati::Util::Configuration> &configuration, const std::shared_ptr<Umati::Dashboard::SparkplugNode> &pSparkplugNode);
+
     std::function<void()> m_issueReset;
     std::shared_ptr<Umati::OpcUa::OpcUaInterface> m_opcUaWrapper;
     std::shared_ptr<Umati::OpcUa::OpcUaClient> m_pClient;
-    std::shared_ptr<Umati::MqttPublisher_Paho::MqttPublisher_Paho> m_pPublisher;
+    /// Null if Sparkplug B is disabled
+    std::shared_ptr<Umati::Dashboard::SparkplugNode> m_pSparkplugNode;
+    /// Null if UADP is disabled
+    std::shared_ptr<Umati::Dashboard::UadpWriterGroup> m_pUadpWriterGroup;
+    /// The only sink or a CompositePublisher forwarding to all configured sinks
+    std::shared_ptr<Umati::Dashboard::IPublisher> m_pPublisher;
     std::shared_ptr<Umati::Dashboard::OpcUaTypeReader> m_pOpcUaTypeReader;
     std::shared_ptr<Umati::MachineObserver::DashboardMachineObserver> m_pMachineObserver;
-    std::chrono::time_point<std::chrono::steady_clock> m_lastPublish;
     std::chrono::time_point<std::chrono::steady_clock> m_lastConnectionVerify;
     std::vector<ModelOpcUa::NodeId_t> m_machinesFilter;
+    Umati::Util::PublishConfig m_publishConfig;
 };
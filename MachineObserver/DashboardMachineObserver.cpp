@@ -27,35 +27,133 @@ namespace Umati
 			std::shared_ptr<Dashboard::IDashboardDataClient> pDataClient,
 			std::shared_ptr<Umati::Dashboard::IPublisher> pPublisher,
 			std::shared_ptr<Umati::Dashboard::OpcUaTypeReader> pOpcUaTypeReader,
-			std::vector<ModelOpcUa::NodeId_t> machinesFilter)
+			std::vector<ModelOpcUa::NodeId_t> machinesFilter,
+			Util::PublishConfig publishConfig,
+			std::shared_ptr<Umati::Dashboard::SparkplugNode> pSparkplugNode,
+			std::shared_ptr<Umati::Dashboard::UadpWriterGroup> pUadpWriterGroup)
 			:MachineObserver(std::move(pDataClient), std::move(pOpcUaTypeReader), std::move(machinesFilter)),
-								m_pPublisher(std::move(pPublisher))
+								m_pPublisher(std::move(pPublisher)),
+								m_publishConfig(publishConfig),
+								m_pSparkplugNode(std::move(pSparkplugNode)),
+								m_pUadpWriterGroup(std::move(pUadpWriterGroup))
 		{
+			if (m_publishConfig.Workers > 0)
+			{
+				m_pWorkerPool.reset(new Util::WorkerPool(m_publishConfig.Workers));
+			}
 			startUpdateMachineThread();
 		}
 
 		DashboardMachineObserver::~DashboardMachineObserver()
 		{
 			stopMachineUpdateThread();
+			// Finish running publishes, so no online status is sent after the offline marker
+			m_pWorkerPool.reset();
+
+			// There is only a last will for the whole client, so mark each machine as offline on a regular shutdown
+			std::unique_lock<decltype(m_dashboardClients_mutex)> ul(m_dashboardClients_mutex);
+			for (const auto &pDashClient : m_dashboardClients)
+			{
+				pDashClient.second->PublishOffline();
+			}
 		}
 
-		void DashboardMachineObserver::PublishAll()
+		Util::TimerWheel::Clock_t::time_point DashboardMachineObserver::PublishDue(Util::TimerWheel::Clock_t::time_point now)
 		{
+			std::vector<Util::TimerWheel::TimerId_t> dueTimers;
+			Util::TimerWheel::Clock_t::time_point nextDeadline;
+			{
+				std::unique_lock<decltype(m_scheduler_mutex)> ul(m_scheduler_mutex);
+				m_scheduler.Advance(now, dueTimers);
+				nextDeadline = m_scheduler.NextDeadline();
+			}
+
+			// Only take the due clients under the lock, building the payloads must not block adding or removing machines
+			std::vector<std::shared_ptr<Umati::Dashboard::DashboardClient>> dueClients;
 			{
 				std::unique_lock<decltype(m_dashboardClients_mutex)> ul(m_dashboardClients_mutex);
-				for (const auto &pDashClient : m_dashboardClients)
+				for (auto timerId : dueTimers)
 				{
-					pDashClient.second->Publish();
+					auto itTimer = m_publishTimers.find(timerId);
+					if (itTimer == m_publishTimers.end())
+					{
+						continue;
+					}
+					auto itClient = m_dashboardClients.find(itTimer->second);
+					if (itClient != m_dashboardClients.end())
+					{
+						dueClients.push_back(itClient->second);
+					}
 				}
 			}
 
-			// Publish online machines every 30th publish
-			if (++m_publishMachinesOnline >= 30)
+			if (!m_pWorkerPool)
 			{
-				this->publishMachinesList();
-				m_publishMachinesOnline = 0;
+				for (const auto &pDashClient : dueClients)
+				{
+					pDashClient->Publish();
+				}
+				return nextDeadline;
 			}
 
+			for (const auto &pDashClient : dueClients)
+			{
+				{
+					// A client is published by one worker at a time, this keeps the order of the messages per topic
+					std::unique_lock<decltype(m_publishingClients_mutex)> ul(m_publishingClients_mutex);
+					if (!m_publishingClients.insert(pDashClient).second)
+					{
+						continue;
+					}
+				}
+				m_pWorkerPool->Post([this, pDashClient]() {
+					try
+					{
+						pDashClient->Publish();
+					}
+					catch (const std::exception &ex)
+					{
+						LOG(ERROR) << "Publish failed: " << ex.what();
+					}
+					std::unique_lock<decltype(m_publishingClients_mutex)> ul(m_publishingClients_mutex);
+					m_publishingClients.erase(pDashClient);
+				});
+			}
+			return nextDeadline;
+		}
+
+		/**
+		* Each machine is published periodically with the interval of its companion specification. The first deadline is
+		* offset by a hash of the machine id, so the machines are spread over the interval instead of being published at once.
+		*/
+		void DashboardMachineObserver::startPublishTimer(const ModelOpcUa::NodeId_t &machineNodeId, const std::string &specification)
+		{
+			stopPublishTimer(machineNodeId);
+
+			auto itInterval = m_publishConfig.Intervals.find(specification);
+			std::chrono::milliseconds interval(itInterval != m_publishConfig.Intervals.end() ? itInterval->second : m_publishConfig.Interval);
+			std::chrono::milliseconds offset(std::hash<std::string>()(static_cast<std::string>(machineNodeId)) % interval.count());
+
+			std::unique_lock<decltype(m_scheduler_mutex)> ul(m_scheduler_mutex);
+			auto timerId = m_scheduler.Add(Util::TimerWheel::Clock_t::now() + offset, interval);
+			m_publishTimers.insert(std::make_pair(timerId, machineNodeId));
+		}
+
+		void DashboardMachineObserver::stopPublishTimer(const ModelOpcUa::NodeId_t &machineNodeId)
+		{
+			std::unique_lock<decltype(m_scheduler_mutex)> ul(m_scheduler_mutex);
+			for (auto it = m_publishTimers.begin(); it != m_publishTimers.end();)
+			{
+				if (it->second == machineNodeId)
+				{
+					m_scheduler.Remove(it->first);
+					it = m_publishTimers.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
 		}
 
 		void DashboardMachineObserver::startUpdateMachineThread()
@@ -73,6 +171,8 @@ namespace Umati
 					if ((cnt % 10) == 0)
 					{
 						this->UpdateMachines();
+						// The lists only change by UpdateMachines
+						this->publishMachinesList();
 					}
 
 					++cnt;
@@ -96,7 +196,20 @@ namespace Umati
 		{
 			std::unique_lock<decltype(m_dashboardClients_mutex)> ul_machines(m_dashboardClients_mutex);
 			std::unique_lock<decltype(m_machineIdentificationsCache_mutex)> ul(m_machineIdentificationsCache_mutex);
-			PublishMachinesList pubList(m_pPublisher, m_pOpcUaTypeReader->m_expectedObjectTypeNames, Topics::List);
+			time_t now;
+			time(&now);
+			auto connectGeneration = m_pPublisher->ConnectGeneration();
+			bool refresh = connectGeneration != m_listsConnectGeneration ||
+						   (m_publishConfig.StatusRefreshInterval > 0 &&
+							difftime(now, m_listsRefreshed) >= m_publishConfig.StatusRefreshInterval);
+			if (refresh)
+			{
+				m_listsRefreshed = now;
+				m_listsConnectGeneration = connectGeneration;
+			}
+
+			auto listEncoding = Util::PayloadEncodingFromString(m_publishConfig.Encoding.List);
+			PublishMachinesList pubList(m_pPublisher, m_pOpcUaTypeReader->m_expectedObjectTypeNames, Topics::List, listEncoding);
 			for (auto &machineOnline : m_onlineMachines)
 			{
 				auto it = m_machineIdentificationsCache.find(machineOnline.first);
@@ -108,9 +221,9 @@ namespace Umati
 				identificationAsJson["ParentId"] = Umati::Util::IdEncode(static_cast<std::string>(machineOnline.second.Parent));
 				pubList.AddMachine(machineOnline.second.Specification, identificationAsJson);
 			}
-            pubList.Publish();
+            pubList.Publish(m_publishedListPayloads, refresh);
             auto errors = std::vector<std::string>{"errors"};
-            PublishMachinesList pubInvalidList(m_pPublisher, errors, Topics::ErrorList);
+            PublishMachinesList pubInvalidList(m_pPublisher, errors, Topics::ErrorList, listEncoding);
             for (auto &machineInvalid: m_invalidMachines)
             {
                 auto it = m_machineIdentificationsCache.find(machineInvalid.first);
@@ -121,7 +234,7 @@ namespace Umati
                 identificationAsJson["Error"] = machineInvalid.second.second;
                 pubInvalidList.AddMachine("errors", identificationAsJson);
             }
-            pubInvalidList.Publish();
+            pubInvalidList.Publish(m_publishedListPayloads, refresh);
 		}
 
 		std::string DashboardMachineObserver::getTypeName(const ModelOpcUa::NodeId_t &nodeId)
@@ -142,7 +255,7 @@ namespace Umati
 				LOG(INFO) << "New Machine: " << machine.BrowseName.Name << " NodeId:"
 						  << static_cast<std::string>(machine.NodeId);
 
-				auto pDashClient = std::make_shared<Umati::Dashboard::DashboardClient>(m_pDataClient, m_pPublisher, m_pOpcUaTypeReader);
+				auto pDashClient = std::make_shared<Umati::Dashboard::DashboardClient>(m_pDataClient, m_pPublisher, m_pOpcUaTypeReader, m_publishConfig, m_pSparkplugNode, m_pUadpWriterGroup);
 				MachineInformation_t machineInformation;
 				machineInformation.NamespaceURI = machine.NodeId.Uri;
 				machineInformation.StartNodeId = machine.NodeId;
@@ -172,7 +285,9 @@ namespace Umati
 					{machineInformation.NamespaceURI, machine.NodeId.Id},
 					p_type,
 					Topics::Machine(p_type, static_cast<std::string>(machine.NodeId)),
-					Topics::OnlineStatus(static_cast<std::string>(machine.NodeId)));
+					Topics::OnlineStatus(static_cast<std::string>(machine.NodeId)),
+					Topics::MachineDelta(p_type, static_cast<std::string>(machine.NodeId)),
+					Util::IdEncode(static_cast<std::string>(machine.NodeId)));
 
 				LOG(INFO) << "Read model finished";
 
@@ -181,6 +296,7 @@ namespace Umati
 					m_dashboardClients.insert(std::make_pair(machine.NodeId, pDashClient));
 					m_onlineMachines.insert(std::make_pair(machine.NodeId, machineInformation));
 					m_machineNames.insert(std::make_pair(machine.NodeId, machine.BrowseName.Name));
+					startPublishTimer(machine.NodeId, machineInformation.Specification);
 				}
 
 			}
@@ -201,8 +317,10 @@ namespace Umati
 			LOG(INFO) << "Remove Machine with NodeId:"
 					  << static_cast<std::string>(machineNodeId);
 			auto it = m_dashboardClients.find(machineNodeId);
+			stopPublishTimer(machineNodeId);
 			if (it != m_dashboardClients.end())
 			{
+				it->second->PublishOffline();
 				it->second.get()->Unsubscribe(machineNodeId);
 				m_dashboardClients.erase(it);
 			}
@@ -307,7 +425,8 @@ namespace Umati
 			auto it = m_machineNames.find(machineNodeId);
 			if (it != m_machineNames.end() && p_type != nullptr)
 			{
-				identificationAsJson["Topic"] = Topics::Machine(p_type, static_cast<std::string>(machineNodeId));
+				identificationAsJson["Topic"] = Topics::Machine(p_type, static_cast<std::string>(machineNodeId)) +
+												Util::PayloadEncodingTopicSuffix(Util::PayloadEncodingFromString(m_publishConfig.Encoding.Machine));
 				identificationAsJson["MachineId"] = Umati::Util::IdEncode(static_cast<std::string>(machineNodeId));
 				identificationAsJson["TypeDefinition"] = p_type->SpecifiedBrowseName.Name;
 			}
@@ -10,6 +10,8 @@
 #include "MachineObserver.hpp"
 #include <OpcUaTypeReader.hpp>
 #include <DashboardClient.hpp>
+#include <TimerWheel.hpp>
+#include <WorkerPool.hpp>
 #include <atomic>
 #include <thread>
 #include <mutex>
@@ -30,11 +32,15 @@ namespace Umati
 				std::shared_ptr<Dashboard::IDashboardDataClient> pDataClient,
 				std::shared_ptr<Umati::Dashboard::IPublisher> pPublisher,
 				std::shared_ptr<Umati::Dashboard::OpcUaTypeReader> pOpcUaTypeReaderm,
-				std::vector<ModelOpcUa::NodeId_t> machinesFilter);
+				std::vector<ModelOpcUa::NodeId_t> machinesFilter,
+				Util::PublishConfig publishConfig = Util::PublishConfig(),
+				std::shared_ptr<Umati::Dashboard::SparkplugNode> pSparkplugNode = nullptr,
+				std::shared_ptr<Umati::Dashboard::UadpWriterGroup> pUadpWriterGroup = nullptr);
 
 			~DashboardMachineObserver() override;
 
-			void PublishAll();
+			/// Publishes all machines that are due and returns the time the next machine is due
+			Util::TimerWheel::Clock_t::time_point PublishDue(Util::TimerWheel::Clock_t::time_point now);
 
 		protected:
 			void startUpdateMachineThread();
@@ -43,6 +49,12 @@ namespace Umati
 
 			void publishMachinesList();
 
+			/// Expects m_dashboardClients_mutex to be locked
+			void startPublishTimer(const ModelOpcUa::NodeId_t &machineNodeId, const std::string &specification);
+
+			/// Expects m_dashboardClients_mutex to be locked
+			void stopPublishTimer(const ModelOpcUa::NodeId_t &machineNodeId);
+
 			// Inherit from MachineObserver
 			void addMachine(ModelOpcUa::BrowseResult_t machine) override;
 
@@ -63,16 +75,35 @@ namespace Umati
 				ModelOpcUa::NodeId_t Parent;
 			};
 
-			int m_publishMachinesOnline = 0;
+			/// Last payload per list topic, lists are only republished on changes, reconnects or after StatusRefreshInterval
+			std::map<std::string, std::string> m_publishedListPayloads;
+			time_t m_listsRefreshed = 0;
+			/// IPublisher::ConnectGeneration of the last published lists
+			std::uint64_t m_listsConnectGeneration = 0;
 
 			std::atomic_bool m_running = {false};
 			std::thread m_updateMachineThread;
 
 			std::shared_ptr<Umati::Dashboard::IPublisher> m_pPublisher;
+			Util::PublishConfig m_publishConfig;
+			/// Null if Sparkplug B is disabled, every machine becomes a device of the node
+			std::shared_ptr<Umati::Dashboard::SparkplugNode> m_pSparkplugNode;
+			/// Null if UADP is disabled, every machine becomes a DataSetWriter of the group
+			std::shared_ptr<Umati::Dashboard::UadpWriterGroup> m_pUadpWriterGroup;
 			std::mutex m_dashboardClients_mutex;
 			std::map<ModelOpcUa::NodeId_t, std::shared_ptr<Umati::Dashboard::DashboardClient>> m_dashboardClients;
 			std::map<ModelOpcUa::NodeId_t, MachineInformation_t> m_onlineMachines;
 			std::map<ModelOpcUa::NodeId_t, std::string> m_machineNames;
+			/// Machine of each periodic publish timer, guarded by m_dashboardClients_mutex
+			std::map<Util::TimerWheel::TimerId_t, ModelOpcUa::NodeId_t> m_publishTimers;
+			/// Locked after m_dashboardClients_mutex, if both are required
+			std::mutex m_scheduler_mutex;
+			Util::TimerWheel m_scheduler;
+			/// Only created if Workers is configured
+			std::unique_ptr<Util::WorkerPool> m_pWorkerPool;
+			std::mutex m_publishingClients_mutex;
+			/// Clients currently published by a worker, they are skipped if they are due again in the meantime
+			std::set<std::shared_ptr<Umati::Dashboard::DashboardClient>> m_publishingClients;
 
 			void browseIdentificationValues(const ModelOpcUa::NodeId_t &machineNodeId, const ModelOpcUa::NodeId_t &typeDefinition, 
 											ModelOpcUa::BrowseResult_t &identification,
@@ -13,16 +13,20 @@ namespace Umati
 {
 	namespace MachineObserver
 	{
-		PublishMachinesList::PublishMachinesList(std::shared_ptr<Umati::Dashboard::IPublisher> pPublisher, std::vector<std::string> &specifications, std::function<std::string(const std::string&)> getTopic)
-		:m_pPublisher(pPublisher), m_Specifications(specifications), m_getTopic(getTopic)
-		{}
+		PublishMachinesList::PublishMachinesList(std::shared_ptr<Umati::Dashboard::IPublisher> pPublisher, std::vector<std::string> &specifications, std::function<std::string(const std::string&)> getTopic,
+												 Util::PayloadEncoding_t encoding)
+		:m_pPublisher(pPublisher), m_Specifications(specifications), m_getTopic(getTopic), m_encoding(encoding)
+		{
+			m_options.ContentType = Util::PayloadEncodingContentType(encoding);
+			m_options.TopicClass = "list";
+		}
 
 		void PublishMachinesList::AddMachine(std::string specification, nlohmann::json data)
 		{
 			m_Machines[specification].push_back(data);
 		}
 
-		void PublishMachinesList::Publish()
+		void PublishMachinesList::Publish(std::map<std::string, std::string> &publishedPayloads, bool refresh)
 		{
 			for(auto el : m_Machines)
 			{
@@ -31,16 +35,30 @@ namespace Umati
 				{
 					publishData.push_back(machineData);
 				}
-				m_pPublisher->Publish(m_getTopic(el.first), publishData.dump(0));
+				publishList(el.first, publishData, publishedPayloads, refresh);
 			}
 
 			for(auto spec : m_Specifications)
 			{
 				if(m_Machines.count(spec) == 0)
 				{
-					m_pPublisher->Publish(m_getTopic(spec), nlohmann::json::array().dump(0));
+					publishList(spec, nlohmann::json::array(), publishedPayloads, refresh);
 				}
 			}
 		}
+
+		void PublishMachinesList::publishList(const std::string &specification, const nlohmann::json &list,
+											  std::map<std::string, std::string> &publishedPayloads, bool refresh)
+		{
+			std::string topic = m_getTopic(specification) + Util::PayloadEncodingTopicSuffix(m_encoding);
+			std::string payload = Util::EncodePayload(list, m_encoding, 0);
+			auto &published = publishedPayloads[topic];
+			if(!refresh && payload == published)
+			{
+				return;
+			}
+			m_pPublisher->Publish(topic, payload, m_options);
+			published = std::move(payload);
+		}
 	}
 }
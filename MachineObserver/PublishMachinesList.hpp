@@ -13,6 +13,7 @@
 #include <list>
 #include <string>
 #include <nlohmann/json.hpp>
+#include <PayloadEncoding.hpp>
 
 namespace Umati
 {
@@ -21,15 +22,22 @@ namespace Umati
 		/// Sorting and preparing machines for publish machines list.
 		class PublishMachinesList {
 			public:
-			PublishMachinesList(std::shared_ptr<Umati::Dashboard::IPublisher> pPublisher, std::vector<std::string> &specifications, std::function<std::string(const std::string&)> getTopic);
+			PublishMachinesList(std::shared_ptr<Umati::Dashboard::IPublisher> pPublisher, std::vector<std::string> &specifications, std::function<std::string(const std::string&)> getTopic,
+								Util::PayloadEncoding_t encoding = Util::PayloadEncoding_t::Json);
 
 			void AddMachine(std::string specification, nlohmann::json data);
-			void Publish();
+			/// Only publishes lists, that differ from the payload in publishedPayloads (by topic) or all if refresh is set. Updates publishedPayloads.
+			void Publish(std::map<std::string, std::string> &publishedPayloads, bool refresh = false);
 			protected:
 			const std::vector<std::string> &m_Specifications;
 			std::map<std::string, std::list<nlohmann::json>> m_Machines;
 			std::shared_ptr<Umati::Dashboard::IPublisher> m_pPublisher;
             std::function<std::string(const std::string&)> m_getTopic;
+			Util::PayloadEncoding_t m_encoding;
+			Umati::Dashboard::PublishOptions m_options;
+
+			void publishList(const std::string &specification, const nlohmann::json &list,
+							 std::map<std::string, std::string> &publishedPayloads, bool refresh);
 		};
 	}
 }
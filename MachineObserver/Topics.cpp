@@ -21,6 +21,10 @@ std::string Topics::Machine(const std::shared_ptr<ModelOpcUa::StructureNode> &p_
   return topic.str();
 }
 
+std::string Topics::MachineDelta(const std::shared_ptr<ModelOpcUa::StructureNode> &p_type, const std::string &machineId) {
+  return Topics::Machine(p_type, machineId) + "/$delta";
+}
+
 std::string Topics::List(const std::string &specType) {
   std::stringstream topic;
   topic << Topics::Prefix << "/" << Topics::ClientId << "/list/" << specType;
@@ -49,5 +53,11 @@ std::string Topics::GwVersion() {
   topic << Topics::Prefix << "/" << Topics::ClientId << "/gw-version";
   return topic.str();
 }
+
+std::string Topics::CompressionDictionaries() {
+  std::stringstream topic;
+  topic << Topics::Prefix << "/" << Topics::ClientId << "/$dictionary";
+  return topic.str();
+}
 }  // namespace MachineObserver
 }  // namespace Umati
@@ -16,11 +16,15 @@ class Topics {
   static std::string Prefix;
   static std::string ClientId;
   static std::string Machine(const std::shared_ptr<ModelOpcUa::StructureNode> &p_type, const std::string &machineId);
+  /// Merge patches relative to the previous document of Machine(p_type, machineId)
+  static std::string MachineDelta(const std::shared_ptr<ModelOpcUa::StructureNode> &p_type, const std::string &machineId);
   static std::string List(const std::string &specType);
   static std::string ErrorList(const std::string &specType);
   static std::string OnlineStatus(const std::string &machineId);
   static std::string ClientOnline();
   static std::string GwVersion();
+  /// Parent of the retained compression dictionaries, one subtopic per dictionary id
+  static std::string CompressionDictionaries();
 };
 }  // namespace MachineObserver
 }  // namespace Umati
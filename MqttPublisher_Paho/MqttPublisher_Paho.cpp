@@ -10,6 +10,7 @@
 #include "MqttPublisher_Paho.hpp"
 
 #include <easylogging++.h>
+#include <algorithm>
 #include <sstream>
 
 namespace Umati {
@@ -25,32 +26,100 @@ MqttPublisher_Paho::MqttPublisher_Paho(
   const std::string &versionTopic,
   const std::string &gitClientVersion,
   const std::string &username,
-  const std::string &password)
-  : m_cli(getUri(protocol, host, port), getClientId(), 0, nullptr),
+  const std::string &password,
+  const Umati::Util::CompressionConfig &compression,
+  const std::string &dictionaryTopic,
+  std::size_t queueSize,
+  const Umati::Util::OfflineBufferConfig &offlineBuffer,
+  const Umati::Util::MqttV5Config &v5,
+  std::shared_ptr<Umati::Dashboard::SparkplugNode> pSparkplugNode)
+  : m_cli(getUri(protocol, host, port), getClientId(), mqtt::create_options(v5.Enabled ? MQTTVERSION_5 : MQTTVERSION_DEFAULT, 0), nullptr),
     m_callbacks(this),
     m_onlineTopic(onlineTopic),
     m_versionTopic(versionTopic),
-    m_gitClientVersion(gitClientVersion) {
+    m_gitClientVersion(gitClientVersion),
+    m_dictionaryTopic(dictionaryTopic),
+    m_compressor(compression, [this](std::uint32_t dictionaryId, const std::string &dictionary) { publishDictionary(dictionaryId, dictionary); }),
+    m_queue(queueSize),
+    m_v5(v5),
+    m_pSparkplugNode(std::move(pSparkplugNode)) {
+  if (!offlineBuffer.File.empty()) {
+    try {
+      m_offlineBuffer.reset(new Umati::Dashboard::OfflineBuffer(offlineBuffer.File, offlineBuffer.Size, offlineBuffer.History));
+      if (offlineBuffer.ReplayRate > 0) {
+        m_replayInterval = std::chrono::microseconds(std::chrono::seconds(1)) / offlineBuffer.ReplayRate;
+      }
+    } catch (const std::exception &ex) {
+      LOG(ERROR) << "Offline buffer disabled: " << ex.what();
+    }
+  }
+
   m_cli.set_callback(m_callbacks);
 
-  mqtt::connect_options opts_conn = getOptions(username, password);
+  m_connectOptions = getOptions(username, password, v5.Enabled);
 
   if (protocol == "wss") {
     mqtt::ssl_options ssl_opts;
     ssl_opts.ca_path(CaCertPath);
     ssl_opts.set_trust_store(CaTrustStorePath);
     ssl_opts.set_verify(true);
-    opts_conn.set_ssl(ssl_opts);
+    m_connectOptions.set_ssl(ssl_opts);
   }
 
-  mqtt::will_options opts_will = getLastWill();
-  opts_conn.set_will(opts_will);
+  LOG(INFO) << "Connect to " << host;
+  connect();
+  // Messages published by the connected callback are queued until now
+  m_sender = std::thread(&MqttPublisher_Paho::sendLoop, this);
+  if (m_offlineBuffer) {
+    m_replayer = std::thread(&MqttPublisher_Paho::replayLoop, this);
+  }
+  m_reconnector = std::thread(&MqttPublisher_Paho::reconnectLoop, this);
+}
 
+bool MqttPublisher_Paho::connect() {
+  // Each CONNECT gets a new bdSeq, the NBIRTH after it carries the same
+  m_connectOptions.set_will(getLastWill(m_pSparkplugNode ? m_pSparkplugNode->NextDeathPayload() : std::string()));
   try {
-    LOG(INFO) << "Connect to " << host;
-    m_cli.connect(opts_conn)->wait();
+    auto token = m_cli.connect(m_connectOptions);
+    token->wait();
+    std::uint16_t topicAliasMaximum = 0;
+    if (m_v5.Enabled) {
+      // Without a maximum in the CONNACK, the broker does not accept topic aliases
+      auto properties = token->get_connect_response().get_properties();
+      std::uint16_t brokerMaximum = 0;
+      if (properties.contains(mqtt::property::TOPIC_ALIAS_MAXIMUM)) {
+        brokerMaximum = mqtt::get<std::uint16_t>(properties, mqtt::property::TOPIC_ALIAS_MAXIMUM);
+      }
+      topicAliasMaximum = std::min(m_v5.TopicAliasMaximum, brokerMaximum);
+      LOG(INFO) << "Using MQTT v5 with " << topicAliasMaximum << " topic aliases";
+    }
+    resetTopicAliases(topicAliasMaximum);
+    return true;
   } catch (const mqtt::exception &ex) {
     LOG(ERROR) << "Paho Exception:" << ex.what();
+    return false;
+  }
+}
+
+void MqttPublisher_Paho::reconnectLoop() {
+  const std::chrono::seconds minRetryInterval(2);
+  const std::chrono::seconds maxRetryInterval(10);
+  auto retryInterval = minRetryInterval;
+  std::unique_lock<std::mutex> ul(m_reconnectMutex);
+  while (!m_stopReconnect) {
+    if (m_cli.is_connected()) {
+      m_reconnectCv.wait(ul, [this]() { return m_stopReconnect || m_connectionLost; });
+      m_connectionLost = false;
+      retryInterval = minRetryInterval;
+      continue;
+    }
+    ul.unlock();
+    bool connected = connect();
+    ul.lock();
+    if (!connected) {
+      m_reconnectCv.wait_for(ul, retryInterval, [this]() { return m_stopReconnect; });
+      retryInterval = std::min(retryInterval * 2, maxRetryInterval);
+    }
   }
 }
 
@@ -60,13 +129,16 @@ std::string MqttPublisher_Paho::getUri(std::string protocol, std::string host, s
   return ss.str();
 }
 
-mqtt::connect_options MqttPublisher_Paho::getOptions(const std::string &username, const std::string &password) {
-  mqtt::connect_options opts_conn;
+mqtt::connect_options MqttPublisher_Paho::getOptions(const std::string &username, const std::string &password, bool v5) {
+  mqtt::connect_options opts_conn = v5 ? mqtt::connect_options::v5() : mqtt::connect_options();
   opts_conn.set_keep_alive_interval(std::chrono::seconds(10));
-  opts_conn.set_clean_session(true);
-
-  opts_conn.set_automatic_reconnect(2, 10);
+  if (v5) {
+    opts_conn.set_clean_start(true);
+  } else {
+    opts_conn.set_clean_session(true);
+  }
 
+  // No automatic reconnect, the topic alias maximum of each CONNACK is needed
   if (!username.empty()) {
     opts_conn.set_user_name(username);
   }
@@ -77,8 +149,16 @@ mqtt::connect_options MqttPublisher_Paho::getOptions(const std::string &username
   return opts_conn;
 }
 
-mqtt::will_options MqttPublisher_Paho::getLastWill() const {
+mqtt::will_options MqttPublisher_Paho::getLastWill(const std::string &deathPayload) const {
   mqtt::will_options opts_will;
+  if (m_pSparkplugNode && m_pSparkplugNode->DeathAsWill()) {
+    // MQTT allows a single will, a Sparkplug host application relies on the NDEATH
+    opts_will.set_topic(m_pSparkplugNode->NodeTopic("NDEATH"));
+    opts_will.set_payload(deathPayload);
+    opts_will.set_qos(1);
+    opts_will.set_retained(false);
+    return opts_will;
+  }
   opts_will.set_topic(m_onlineTopic);
   opts_will.set_payload(std::string("0"));
   opts_will.set_retained(true);
@@ -86,10 +166,228 @@ mqtt::will_options MqttPublisher_Paho::getLastWill() const {
 }
 
 void MqttPublisher_Paho::Publish(std::string channel, std::string message) {
+  Publish(std::move(channel), std::move(message), Umati::Dashboard::PublishOptions());
+}
+
+void MqttPublisher_Paho::Publish(std::string channel, std::string message, const Umati::Dashboard::PublishOptions &options) {
+  m_queue.Push(std::move(channel), std::move(message), options);
+}
+
+bool MqttPublisher_Paho::TakeDropped(const std::string &channel) { return m_queue.TakeDropped(channel); }
+
+std::uint64_t MqttPublisher_Paho::DroppedMessages() { return m_queue.DroppedMessages(); }
+
+std::uint64_t MqttPublisher_Paho::ConnectGeneration() { return m_connectGeneration; }
+
+Umati::Dashboard::PublishQueue::Statistics_t MqttPublisher_Paho::GetStatistics(bool reset) { return m_queue.GetStatistics(reset); }
+
+void MqttPublisher_Paho::sendLoop() {
+  auto lastStatistics = std::chrono::steady_clock::now();
+  Umati::Dashboard::PublishQueue::Message_t message;
+  while (m_queue.Pop(message)) {
+    // Before the frames compressed with them
+    sendUnsentDictionaries();
+    if (m_queue.TakeDroppedSequenced()) {
+      requestRebirth();
+    }
+    if (message.options.Sequenced) {
+      sendSequenced(message);
+      continue;
+    }
+    std::string topic = message.channel;
+    std::uint32_t dictionaryId = 0;
+    if (message.options.Compressible && m_compressor.Compress(message.options.CompressionGroup, message.message, &dictionaryId)) {
+      // Own topic per dictionary, so consumers of MQTT 3 can tell compressed frames apart as well
+      topic += "/$zstd/" + std::to_string(dictionaryId);
+      message.options.ContentType = "application/zstd";
+      message.options.UserProperties.emplace_back("ContentEncoding", "zstd");
+    }
+    if (message.options.Retain) {
+      auto &retainedTopic = m_retainedTopics[message.channel];
+      if (!retainedTopic.empty() && retainedTopic != topic) {
+        // Remove the outdated retained value, e.g. the uncompressed one after the payload grew beyond the threshold
+        Umati::Dashboard::PublishOptions clearOptions;
+        clearOptions.TopicClass = message.options.TopicClass;
+        sendOrBuffer(retainedTopic, std::string(), clearOptions);
+      }
+      retainedTopic = topic;
+    }
+    sendOrBuffer(topic, message.message, message.options);
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastStatistics >= std::chrono::minutes(1)) {
+      lastStatistics = now;
+      logStatistics();
+    }
+  }
+}
+
+void MqttPublisher_Paho::sendOrBuffer(const std::string &topic, const std::string &message, const Umati::Dashboard::PublishOptions &options) {
+  // While buffered messages are replayed, new ones are appended to keep the order
+  if (m_offlineBuffer && (!m_cli.is_connected() || !m_offlineBuffer->Empty())) {
+    m_offlineBuffer->Append(topic, message, options);
+    return;
+  }
+  try {
+    publishMessage(topic, message, options);
+  } catch (const mqtt::exception &ex) {
+    LOG(ERROR) << "Paho Exception:" << ex.what();
+    if (m_offlineBuffer) {
+      m_offlineBuffer->Append(topic, message, options);
+    }
+  }
+}
+
+void MqttPublisher_Paho::sendSequenced(const Umati::Dashboard::PublishQueue::Message_t &message) {
+  if (m_pSparkplugNode && message.channel == m_pSparkplugNode->NodeTopic("NBIRTH")) {
+    m_sequenceBroken = false;
+  }
+  if (m_sequenceBroken) {
+    // Outdated by the next NBIRTH
+    return;
+  }
+  if (!m_cli.is_connected()) {
+    // The connected callback publishes the next NBIRTH
+    m_sequenceBroken = true;
+    return;
+  }
+  try {
+    publishMessage(message.channel, message.message, message.options);
+  } catch (const mqtt::exception &ex) {
+    LOG(ERROR) << "Paho Exception:" << ex.what();
+    requestRebirth();
+  }
+}
+
+void MqttPublisher_Paho::requestRebirth() {
+  m_sequenceBroken = true;
+  if (m_pSparkplugNode && m_cli.is_connected()) {
+    LOG(WARNING) << "Sparkplug message lost, publishing a new NBIRTH";
+    m_pSparkplugNode->PublishBirth(*this);
+  }
+}
+
+void MqttPublisher_Paho::publishMessage(
+  const std::string &channel, const std::string &message, const Umati::Dashboard::PublishOptions &options, int qos) {
+  std::lock_guard<std::mutex> l(m_publishMutex);
+  std::string topic = channel;
+  std::int64_t savedBytes = 0;
+  if (!m_v5.Enabled) {
+    m_cli.publish(topic, message, qos, options.Retain);
+  } else {
+    mqtt::properties properties;
+    if (!options.ContentType.empty()) {
+      properties.add(mqtt::property(mqtt::property::CONTENT_TYPE, options.ContentType));
+    }
+    if (!options.Retain && m_v5.MessageExpiry > 0) {
+      properties.add(mqtt::property(mqtt::property::MESSAGE_EXPIRY_INTERVAL, static_cast<int>(m_v5.MessageExpiry)));
+    }
+    for (const auto &userProperty : options.UserProperties) {
+      properties.add(mqtt::property(mqtt::property::USER_PROPERTY, userProperty.first, userProperty.second));
+    }
+
+    bool established = false;
+    auto alias = m_topicAliases.Get(channel, established);
+    if (alias != 0) {
+      properties.add(mqtt::property(mqtt::property::TOPIC_ALIAS, alias));
+      // Property identifier and two bytes alias
+      savedBytes -= 3;
+      if (established) {
+        savedBytes += static_cast<std::int64_t>(topic.size());
+        topic.clear();
+      }
+    }
+    m_cli.publish(mqtt::message::create(topic, message, qos, options.Retain, properties));
+    // Not reached if publish throws, so the next message carries the topic again
+    m_topicAliases.Sent(channel);
+  }
+
+  auto &statistics = m_topicClassStatistics[options.TopicClass.empty() ? "other" : options.TopicClass];
+  ++statistics.messages;
+  statistics.bytes += topic.size() + message.size();
+  statistics.savedBytes += savedBytes;
+}
+
+void MqttPublisher_Paho::resetTopicAliases(std::uint16_t maximum) {
+  std::lock_guard<std::mutex> l(m_publishMutex);
+  m_topicAliases.Reset(maximum);
+}
+
+std::map<std::string, MqttPublisher_Paho::TopicClassStatistics_t> MqttPublisher_Paho::GetTopicClassStatistics() {
+  std::lock_guard<std::mutex> l(m_publishMutex);
+  return m_topicClassStatistics;
+}
+
+void MqttPublisher_Paho::replayLoop() {
+  Umati::Dashboard::OfflineBuffer::Record_t record;
+  std::unique_lock<std::mutex> ul(m_replayMutex);
+  while (!m_stopReplay) {
+    bool sent = false;
+    if (m_cli.is_connected() && m_offlineBuffer->Peek(record)) {
+      try {
+        record.options.TopicClass = "replay";
+        publishMessage(record.channel, record.message, record.options);
+        m_offlineBuffer->Pop(record.sequence);
+        sent = true;
+      } catch (const mqtt::exception &ex) {
+        LOG(ERROR) << "Paho Exception:" << ex.what();
+      }
+    }
+    auto wait = sent ? m_replayInterval : std::chrono::microseconds(std::chrono::milliseconds(500));
+    m_replayCv.wait_for(ul, wait, [this]() { return m_stopReplay; });
+  }
+}
+
+void MqttPublisher_Paho::logStatistics() {
+  auto statistics = m_queue.GetStatistics(true);
+  LOG(INFO) << "Publish queue: depth " << statistics.depth << " (max " << statistics.maxDepth << "), " << statistics.popped << " sent, "
+            << statistics.coalesced << " coalesced, " << statistics.dropped << " dropped (" << statistics.droppedNotRetained
+            << " not retained), latency avg " << statistics.averageLatency.count() << " us (max " << statistics.maxLatency.count() << " us)";
+  if (m_offlineBuffer) {
+    auto bufferStatistics = m_offlineBuffer->GetStatistics();
+    LOG(INFO) << "Offline buffer: " << bufferStatistics.records << " messages (" << bufferStatistics.usedBytes << " bytes), "
+              << bufferStatistics.stored << " stored, " << bufferStatistics.superseded << " superseded, " << bufferStatistics.dropped << " dropped";
+  }
+  for (const auto &topicClass : GetTopicClassStatistics()) {
+    LOG(INFO) << "Topic class " << topicClass.first << ": " << topicClass.second.messages << " messages, " << topicClass.second.bytes << " bytes, "
+              << topicClass.second.savedBytes << " bytes saved by topic aliases";
+  }
+}
+
+void MqttPublisher_Paho::publishDictionary(std::uint32_t dictionaryId, const std::string &dictionary) {
+  {
+    std::lock_guard<std::mutex> l(m_dictionaryMutex);
+    m_dictionaries[dictionaryId] = dictionary;
+  }
+  sendDictionary(dictionaryId, dictionary);
+}
+
+void MqttPublisher_Paho::sendDictionary(std::uint32_t dictionaryId, const std::string &dictionary) {
   try {
-    m_cli.publish(channel, message, 0, true);
+    Umati::Dashboard::PublishOptions options;
+    options.TopicClass = "dictionary";
+    publishMessage(m_dictionaryTopic + "/" + std::to_string(dictionaryId), dictionary, options, 1);
   } catch (const mqtt::exception &ex) {
     LOG(ERROR) << "Paho Exception:" << ex.what();
+    std::lock_guard<std::mutex> l(m_dictionaryMutex);
+    m_unsentDictionaries.insert(dictionaryId);
+  }
+}
+
+void MqttPublisher_Paho::sendUnsentDictionaries() {
+  std::map<std::uint32_t, std::string> unsent;
+  {
+    std::lock_guard<std::mutex> l(m_dictionaryMutex);
+    if (m_unsentDictionaries.empty() || !m_cli.is_connected()) {
+      return;
+    }
+    for (auto dictionaryId : m_unsentDictionaries) {
+      unsent.emplace(dictionaryId, m_dictionaries[dictionaryId]);
+    }
+    m_unsentDictionaries.clear();
+  }
+  for (const auto &dictionary : unsent) {
+    sendDictionary(dictionary.first, dictionary.second);
   }
 }
 
@@ -107,7 +405,29 @@ std::string MqttPublisher_Paho::getClientId() {
 }
 
 MqttPublisher_Paho::~MqttPublisher_Paho() {
+  {
+    std::lock_guard<std::mutex> l(m_reconnectMutex);
+    m_stopReconnect = true;
+  }
+  m_reconnectCv.notify_all();
+  m_reconnector.join();
+  if (m_replayer.joinable()) {
+    {
+      std::lock_guard<std::mutex> l(m_replayMutex);
+      m_stopReplay = true;
+    }
+    m_replayCv.notify_all();
+    m_replayer.join();
+  }
+  m_queue.Close();
+  m_sender.join();
+  // Only the sender starts trainings, the pending ones publish with members destroyed before m_compressor
+  m_compressor.WaitForTraining();
+  logStatistics();
   try {
+    if (m_pSparkplugNode) {
+      m_cli.publish(m_pSparkplugNode->NodeTopic("NDEATH"), m_pSparkplugNode->DeathPayload(), 1, false);
+    }
     auto tokenPtr = m_cli.publish(m_onlineTopic, std::string("0"), 0, true);
     tokenPtr->wait_for(1000);
     if (!tokenPtr->is_complete()) {
@@ -123,10 +443,50 @@ MqttPublisher_Paho::MqttCallbacks::MqttCallbacks(MqttPublisher_Paho *mqttPublish
 
 void MqttPublisher_Paho::MqttCallbacks::connected(const std::string &cause) {
   LOG(INFO) << "Mqtt Connected: " << cause;
-  m_mqttPublisher_paho->Publish(m_mqttPublisher_paho->m_onlineTopic, "1");
-  m_mqttPublisher_paho->Publish(m_mqttPublisher_paho->m_versionTopic, m_mqttPublisher_paho->m_gitClientVersion);
+  // The machines publish their retained states again, the broker might have been restarted without persistence
+  ++m_mqttPublisher_paho->m_connectGeneration;
+  {
+    // Sent by the sender thread, which the online state below wakes up
+    std::lock_guard<std::mutex> l(m_mqttPublisher_paho->m_dictionaryMutex);
+    for (const auto &dictionary : m_mqttPublisher_paho->m_dictionaries) {
+      m_mqttPublisher_paho->m_unsentDictionaries.insert(dictionary.first);
+    }
+  }
+  Umati::Dashboard::PublishOptions options;
+  options.TopicClass = "client";
+  m_mqttPublisher_paho->Publish(m_mqttPublisher_paho->m_onlineTopic, "1", options);
+  m_mqttPublisher_paho->Publish(m_mqttPublisher_paho->m_versionTopic, m_mqttPublisher_paho->m_gitClientVersion, options);
+  auto &pSparkplugNode = m_mqttPublisher_paho->m_pSparkplugNode;
+  if (pSparkplugNode) {
+    // Subscribed before the NBIRTH is published, as required by Sparkplug B, the clean session forgets it with each connect
+    try {
+      m_mqttPublisher_paho->m_cli.subscribe(pSparkplugNode->NodeTopic("NCMD"), 1);
+    } catch (const mqtt::exception &ex) {
+      LOG(ERROR) << "Could not subscribe to NCMD: " << ex.what();
+    }
+    pSparkplugNode->PublishBirth(*m_mqttPublisher_paho);
+  }
 }
 
-void MqttPublisher_Paho::MqttCallbacks::connection_lost(const std::string &cause) { LOG(ERROR) << "Connection lost: " << cause; }
+void MqttPublisher_Paho::MqttCallbacks::message_arrived(mqtt::const_message_ptr msg) {
+  auto &pSparkplugNode = m_mqttPublisher_paho->m_pSparkplugNode;
+  if (pSparkplugNode && msg->get_topic() == pSparkplugNode->NodeTopic("NCMD") &&
+      !pSparkplugNode->HandleCommand(*m_mqttPublisher_paho, msg->to_string())) {
+    LOG(WARNING) << "Ignoring invalid NCMD payload";
+  }
+}
+
+void MqttPublisher_Paho::MqttCallbacks::connection_lost(const std::string &cause) {
+  LOG(ERROR) << "Connection lost: " << cause;
+  // Until the next CONNACK tells the maximum of the new connection
+  m_mqttPublisher_paho->resetTopicAliases(0);
+  // Sparkplug messages that were queued meanwhile are outdated by the NBIRTH after the reconnect
+  m_mqttPublisher_paho->m_sequenceBroken = true;
+  {
+    std::lock_guard<std::mutex> l(m_mqttPublisher_paho->m_reconnectMutex);
+    m_mqttPublisher_paho->m_connectionLost = true;
+  }
+  m_mqttPublisher_paho->m_reconnectCv.notify_all();
+}
 }  // namespace MqttPublisher_Paho
 }  // namespace Umati
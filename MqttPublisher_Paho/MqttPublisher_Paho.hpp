@@ -10,6 +10,12 @@
 #pragma once
 
 #include <random>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <set>
 #include <string>
 #include <thread>
 #include <chrono>
@@ -19,6 +25,11 @@
 #include <ctime>
 
 #include <IPublisher.hpp>
+#include <PublishQueue.hpp>
+#include <OfflineBuffer.hpp>
+#include <SparkplugNode.hpp>
+#include "TopicAliases.hpp"
+#include <PayloadCompressor.hpp>
 #include <mqtt/async_client.h>
 
 namespace Umati {
@@ -35,19 +46,74 @@ class MqttPublisher_Paho : public Umati::Dashboard::IPublisher {
     const std::string &versionTopic = std::string(),
     const std::string &gitClientVersion = std::string(),
     const std::string &username = std::string(),
-    const std::string &password = std::string());
+    const std::string &password = std::string(),
+    const Umati::Util::CompressionConfig &compression = Umati::Util::CompressionConfig(),
+    const std::string &dictionaryTopic = std::string(),
+    std::size_t queueSize = 1000,
+    const Umati::Util::OfflineBufferConfig &offlineBuffer = Umati::Util::OfflineBufferConfig(),
+    const Umati::Util::MqttV5Config &v5 = Umati::Util::MqttV5Config(),
+    std::shared_ptr<Umati::Dashboard::SparkplugNode> pSparkplugNode = nullptr);
 
   virtual ~MqttPublisher_Paho();
 
   // Inherit from IPublisher
   void Publish(std::string channel, std::string message) override;
+  /// Only queues the message, it is sent by the sender thread
+  void Publish(std::string channel, std::string message, const Umati::Dashboard::PublishOptions &options) override;
+
+  bool TakeDropped(const std::string &channel) override;
+  std::uint64_t DroppedMessages() override;
+  /// Incremented by the connected callback
+  std::uint64_t ConnectGeneration() override;
+
+  Umati::Dashboard::PublishQueue::Statistics_t GetStatistics(bool reset = false);
+
+  struct TopicClassStatistics_t {
+    std::uint64_t messages = 0;
+    /// Sent topic and payload bytes
+    std::uint64_t bytes = 0;
+    /// Topic bytes saved by topic aliases, minus the size of the alias properties
+    std::int64_t savedBytes = 0;
+  };
+
+  /// By PublishOptions::TopicClass, since the start of the client
+  std::map<std::string, TopicClassStatistics_t> GetTopicClassStatistics();
 
  private:
   static std::string getClientId();
 
-  mqtt::will_options getLastWill() const;
+  /// Adds the MQTT v5 properties and the topic alias, throws mqtt::exception
+  void publishMessage(const std::string &channel, const std::string &message, const Umati::Dashboard::PublishOptions &options, int qos = 0);
+  /// Publishes a Sequenced message, which is never buffered. A lost one breaks the sequence until the next NBIRTH.
+  void sendSequenced(const Umati::Dashboard::PublishQueue::Message_t &message);
+  /// Drops Sequenced messages until the next NBIRTH and publishes it, the connected callback does while disconnected
+  void requestRebirth();
+  /// Publishes or, while disconnected or replaying, appends to m_offlineBuffer
+  void sendOrBuffer(const std::string &topic, const std::string &message, const Umati::Dashboard::PublishOptions &options);
+  /// Forgets the aliases of the previous connection
+  void resetTopicAliases(std::uint16_t maximum);
 
-  static mqtt::connect_options getOptions(const std::string &username, const std::string &password);
+  /// Connects with a new last will and applies the topic alias maximum of the CONNACK, returns false on failure
+  bool connect();
+  /// Connects again after the connection was lost or the first connect failed
+  void reconnectLoop();
+
+  void sendLoop();
+  /// Sends the content of m_offlineBuffer while connected
+  void replayLoop();
+  void logStatistics();
+
+  /// Called from the dictionary training, so consumers can decompress with the dictionary id of the zstd frame
+  void publishDictionary(std::uint32_t dictionaryId, const std::string &dictionary);
+  /// A failed dictionary is marked unsent
+  void sendDictionary(std::uint32_t dictionaryId, const std::string &dictionary);
+  /// Retries the failed dictionaries and those of the previous connection while connected, only used by m_sender
+  void sendUnsentDictionaries();
+
+  /// NDEATH with deathPayload if the Sparkplug node has DeathAsWill set, otherwise the client offline state
+  mqtt::will_options getLastWill(const std::string &deathPayload) const;
+
+  static mqtt::connect_options getOptions(const std::string &username, const std::string &password, bool v5);
   static std::string getUri(std::string protocol, std::string host, std::uint16_t port);
 
   class MqttCallbacks : public mqtt::callback {
@@ -60,14 +126,53 @@ class MqttPublisher_Paho : public Umati::Dashboard::IPublisher {
 
     void connection_lost(const std::string &cause) override;
 
+    /// Handles the NCMD of the Sparkplug node
+    void message_arrived(mqtt::const_message_ptr msg) override;
+
     MqttPublisher_Paho *m_mqttPublisher_paho;
   };
 
   mqtt::async_client m_cli;
   MqttCallbacks m_callbacks;
+  /// The will is replaced before each connect
+  mqtt::connect_options m_connectOptions;
+  std::thread m_reconnector;
+  std::mutex m_reconnectMutex;
+  std::condition_variable m_reconnectCv;
+  bool m_connectionLost = false;
+  bool m_stopReconnect = false;
+  std::atomic<std::uint64_t> m_connectGeneration{0};
   const std::string m_onlineTopic;
   const std::string m_versionTopic;
   const std::string m_gitClientVersion;
+  /// Trained dictionaries are published retained below this topic
+  const std::string m_dictionaryTopic;
+  std::mutex m_dictionaryMutex;
+  /// All dictionaries published so far, by id, the broker might lose them with a restart
+  std::map<std::uint32_t, std::string> m_dictionaries;
+  std::set<std::uint32_t> m_unsentDictionaries;
+  /// Pending dictionary trainings publish with m_cli and the members below, the destructor waits for them
+  Umati::Util::PayloadCompressor m_compressor;
+  Umati::Dashboard::PublishQueue m_queue;
+  std::thread m_sender;
+  /// Topic of the last retained message per channel, compressed ones have their own, only used by m_sender
+  std::map<std::string, std::string> m_retainedTopics;
+  /// Might be null if store-and-forward is disabled
+  std::unique_ptr<Umati::Dashboard::OfflineBuffer> m_offlineBuffer;
+  std::chrono::microseconds m_replayInterval{0};
+  std::thread m_replayer;
+  std::mutex m_replayMutex;
+  std::condition_variable m_replayCv;
+  bool m_stopReplay = false;
+  const Umati::Util::MqttV5Config m_v5;
+  /// Aliases must be assigned in the order the messages are sent, so publishMessage holds it while publishing
+  std::mutex m_publishMutex;
+  TopicAliases m_topicAliases;
+  /// If set, NBIRTH is published after each connect and its NDEATH might replace the client offline state as last will
+  std::shared_ptr<Umati::Dashboard::SparkplugNode> m_pSparkplugNode;
+  /// Set after a Sequenced message was lost and until the next NBIRTH is sent
+  std::atomic<bool> m_sequenceBroken{true};
+  std::map<std::string, TopicClassStatistics_t> m_topicClassStatistics;
 };
 }  // namespace MqttPublisher_Paho
 }  // namespace Umati
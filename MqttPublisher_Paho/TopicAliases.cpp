@@ -0,0 +1,44 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "TopicAliases.hpp"
+
+namespace Umati {
+namespace MqttPublisher_Paho {
+TopicAliases::TopicAliases(std::uint32_t hotThreshold) : m_hotThreshold(hotThreshold) {}
+
+void TopicAliases::Reset(std::uint16_t maximum) {
+  m_maximum = maximum;
+  m_nextAlias = 1;
+  m_topics.clear();
+}
+
+std::uint16_t TopicAliases::Get(const std::string &topic, bool &established) {
+  established = false;
+  if (m_maximum == 0) {
+    return 0;
+  }
+  auto &entry = m_topics[topic];
+  if (entry.alias != 0) {
+    established = entry.established;
+    return entry.alias;
+  }
+  if (++entry.count < m_hotThreshold || m_nextAlias > m_maximum) {
+    return 0;
+  }
+  entry.alias = static_cast<std::uint16_t>(m_nextAlias++);
+  return entry.alias;
+}
+
+void TopicAliases::Sent(const std::string &topic) {
+  auto it = m_topics.find(topic);
+  if (it != m_topics.end() && it->second.alias != 0) {
+    it->second.established = true;
+  }
+}
+}  // namespace MqttPublisher_Paho
+}  // namespace Umati
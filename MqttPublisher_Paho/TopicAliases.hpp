@@ -0,0 +1,49 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace Umati {
+namespace MqttPublisher_Paho {
+/**
+ * MQTT v5 topic aliases of one connection.
+ *
+ * A topic gets an alias once it was published hotThreshold times, until the maximum of the broker is reached.
+ * Messages contain the full topic until one with the alias was sent successfully, later ones only the alias.
+ * Not thread safe, aliases must be requested in the order the messages are sent.
+ */
+class TopicAliases {
+ public:
+  explicit TopicAliases(std::uint32_t hotThreshold = 2);
+
+  /// Forget all aliases, they are only valid for one connection
+  void Reset(std::uint16_t maximum);
+
+  /// Returns 0 if the topic has no alias, established is set if the alias was already sent together with the topic
+  std::uint16_t Get(const std::string &topic, bool &established);
+
+  /// The message with the alias of the topic was published, a failed one leaves the alias unestablished
+  void Sent(const std::string &topic);
+
+ private:
+  struct Topic_t {
+    std::uint32_t count = 0;
+    std::uint16_t alias = 0;
+    bool established = false;
+  };
+
+  const std::uint32_t m_hotThreshold;
+  std::uint16_t m_maximum = 0;
+  std::uint32_t m_nextAlias = 1;
+  std::unordered_map<std::string, Topic_t> m_topics;
+};
+}  // namespace MqttPublisher_Paho
+}  // namespace Umati
@@ -9,9 +9,12 @@
  */
 
 #include <tinyxml2.h>
+#include <algorithm>
+#include <set>
 #include "OpcUaClient.hpp"
 #include "ScopeExitGuard.hpp"
 #include "SetupSecurity.hpp"
+#include "TypeDictionary/DataTypeDefinition.hpp"
 
 #include <Exceptions/ClientNotConnected.hpp>
 #include "Exceptions/OpcUaNonGoodStatusCodeException.hpp"
@@ -96,6 +99,21 @@ static void stateCallback(UA_Client *client, UA_SecureChannelState channelState,
 
 static void inactivityCallback(UA_Client *client) { LOG(ERROR) << "\n\n\nINACTIVITYCALLBACK\n\n\n"; }
 
+/// Names of the builtin DataTypes in the TypeDictionaries, indexed by their UA_DataTypeKind
+static const char *const BuiltinTypeNames[] = {
+  "opc:Boolean", "opc:SByte", "opc:Byte", "opc:Int16", "opc:UInt16", "opc:Int32", "opc:UInt32", "opc:Int64", "opc:UInt64",
+  "opc:Float", "opc:Double", "opc:String", "opc:DateTime", "opc:Guid", "opc:ByteString", "ua:XmlElement", "ua:NodeId",
+  "ua:ExpandedNodeId", "ua:StatusCode", "ua:QualifiedName", "ua:LocalizedText", "ua:ExtensionObject", "ua:DataValue", "ua:Variant",
+  "ua:DiagnosticInfo"};
+// The table relies on the builtin kinds of open62541 1.3 being numbered like the builtin DataTypes, starting with Boolean = 0
+static_assert(sizeof(BuiltinTypeNames) / sizeof(BuiltinTypeNames[0]) == UA_DATATYPEKIND_DIAGNOSTICINFO + 1, "BuiltinTypeNames must cover all builtin kinds");
+static_assert(
+  UA_DATATYPEKIND_BOOLEAN == 0 && UA_DATATYPEKIND_STRING == 11 && UA_DATATYPEKIND_XMLELEMENT == 15 && UA_DATATYPEKIND_EXTENSIONOBJECT == 21 &&
+    UA_DATATYPEKIND_VARIANT == 23,
+  "Unexpected order of UA_DataTypeKind, update BuiltinTypeNames");
+
+static std::string toString(const UA_String &value) { return std::string(reinterpret_cast<const char *>(value.data), value.length); }
+
 OpcUaClient::OpcUaClient(
   std::string serverURI,
   std::function<void()> issueReset,
@@ -270,6 +288,175 @@ void OpcUaClient::buildCustomDataTypes() {
 }
 
 void OpcUaClient::readTypeDictionaries() {
+  bool hasDefinitions = false;
+  try {
+    hasDefinitions = readDataTypeDefinitions();
+  } catch (const std::exception &ex) {
+    LOG(WARNING) << "Could not read the DataTypeDefinitions: " << ex.what();
+  }
+  if (hasDefinitions) {
+    return;
+  }
+  LOG(INFO) << "Reading the custom DataTypes from the TypeDictionaries of the server";
+  readTypeDictionariesFromXml();
+}
+
+bool OpcUaClient::readDataTypeDefinitions() {
+  // The same namespaces as the skipped TypeDictionaries "Opc.Ua" and "Opc.Ua.Di"
+  const std::set<std::string> skippedNamespaces{Dashboard::ns0Uri, "http://opcfoundation.org/UA/DI/"};
+  auto toModelNodeId = [this](const UA_NodeId &nodeId) {
+    open62541Cpp::UA_NodeId uaNodeId;
+    UA_NodeId_copy(&nodeId, uaNodeId.NodeId);
+    return Converter::UaNodeIdToModelNodeId(uaNodeId, m_indexToUriCache).getNodeId();
+  };
+
+  // Collect the subtypes of Structure and Enumeration, one browse request per level of the hierarchy
+  auto subtypeContext = BrowseContext_t::WithReference(Dashboard::NodeId_HasSubtype);
+  subtypeContext.nodeClassMask = static_cast<std::uint32_t>(BrowseContext_t::NodeClassMask::DATATYPE);
+  std::map<ModelOpcUa::NodeId_t, ModelOpcUa::BrowseResult_t> customTypes;
+  std::set<ModelOpcUa::NodeId_t> enumerations{Dashboard::NodeId_Enumeration};
+  std::vector<ModelOpcUa::NodeId_t> level{Dashboard::NodeId_Structure, Dashboard::NodeId_Enumeration};
+  while (!level.empty()) {
+    auto subtypes = BrowseMultiple(level, subtypeContext);
+    std::vector<ModelOpcUa::NodeId_t> nextLevel;
+    for (std::size_t i = 0; i < level.size(); ++i) {
+      bool isEnumeration = enumerations.count(level[i]) != 0;
+      for (auto &subtype : subtypes[i]) {
+        nextLevel.push_back(subtype.NodeId);
+        if (isEnumeration) {
+          enumerations.insert(subtype.NodeId);
+        }
+        if (skippedNamespaces.count(subtype.NodeId.Uri) == 0) {
+          customTypes.emplace(subtype.NodeId, subtype);
+        }
+      }
+    }
+    level.swap(nextLevel);
+  }
+  if (customTypes.empty()) {
+    return false;
+  }
+
+  // Name of a DataType of namespace 0 as used in the TypeDictionaries
+  auto builtinTypeName = [this](const ModelOpcUa::NodeId_t &dataType) -> std::string {
+    auto uaDataType = Converter::ModelNodeIdToUaNodeId(dataType, m_uriToIndexCache).getNodeId();
+    const UA_DataType *type = UA_findDataType(uaDataType.NodeId);
+    if (type == nullptr) {
+      return std::string();
+    }
+    if (type->typeKind <= UA_DATATYPEKIND_DIAGNOSTICINFO) {
+      return BuiltinTypeNames[type->typeKind];
+    }
+    if (type->typeKind == UA_DATATYPEKIND_ENUM) {
+      return "opc:Int32";
+    }
+    for (const auto &entry : XMLtoUaType) {
+      if (&UA_TYPES[entry.second] == type) {
+        return entry.first;
+      }
+    }
+    return std::string();
+  };
+  TypeDictionary::DataTypeDefinitionConverter converter(customTypes, enumerations, builtinTypeName);
+
+  auto toStructureDefinition = [&](const UA_StructureDefinition &definition) {
+    TypeDictionary::StructureDefinition_t ret;
+    switch (definition.structureType) {
+      case UA_STRUCTURETYPE_STRUCTURE:
+        ret.StructureType = TypeDictionary::StructureDefinition_t::StructureType_t::Structure;
+        break;
+      case UA_STRUCTURETYPE_STRUCTUREWITHOPTIONALFIELDS:
+        ret.StructureType = TypeDictionary::StructureDefinition_t::StructureType_t::StructureWithOptionalFields;
+        break;
+      default:
+        ret.StructureType = TypeDictionary::StructureDefinition_t::StructureType_t::Union;
+        break;
+    }
+    ret.BaseDataType = toModelNodeId(definition.baseDataType);
+    if (!UA_NodeId_isNull(&definition.defaultEncodingId)) {
+      ret.DefaultEncodingId = toModelNodeId(definition.defaultEncodingId);
+    }
+    for (std::size_t j = 0; j < definition.fieldsSize; ++j) {
+      const UA_StructureField &structureField = definition.fields[j];
+      ret.Fields.push_back(TypeDictionary::StructureFieldDefinition_t{
+        toString(structureField.name), toModelNodeId(structureField.dataType), structureField.valueRank, structureField.isOptional});
+    }
+    return ret;
+  };
+
+  auto toEnumeratedValues = [](const UA_EnumDefinition &definition) {
+    std::vector<TypeDictionary::EnumeratedValue> ret;
+    for (std::size_t j = 0; j < definition.fieldsSize; ++j) {
+      ret.push_back(TypeDictionary::EnumeratedValue{toString(definition.fields[j].name), definition.fields[j].value});
+    }
+    return ret;
+  };
+
+  // Read the DataTypeDefinitions in chunks of MaxNodesPerRead
+  std::vector<ModelOpcUa::NodeId_t> typeIds;
+  typeIds.reserve(customTypes.size());
+  for (const auto &type : customTypes) {
+    typeIds.push_back(type.first);
+  }
+  std::size_t missingDefinitions = 0;
+  const std::size_t chunkSize = maxNodesPerRead();
+  for (std::size_t begin = 0; begin < typeIds.size(); begin += chunkSize) {
+    const std::size_t count = std::min(chunkSize, typeIds.size() - begin);
+    UA_ReadValueId *nodesToRead = static_cast<UA_ReadValueId *>(UA_Array_new(count, &UA_TYPES[UA_TYPES_READVALUEID]));
+    UA_ReadResponse readResponse;
+    UA_ReadResponse_init(&readResponse);
+    UA_DiagnosticInfo info;
+    UA_DiagnosticInfo_init(&info);
+    ScopeExitGuard readGuard([&]() {
+      UA_Array_delete(nodesToRead, count, &UA_TYPES[UA_TYPES_READVALUEID]);
+      UA_ReadResponse_clear(&readResponse);
+    });
+    for (std::size_t i = 0; i < count; ++i) {
+      nodesToRead[i].attributeId = UA_ATTRIBUTEID_DATATYPEDEFINITION;
+      open62541Cpp::UA_NodeId typeUaNodeId = Converter::ModelNodeIdToUaNodeId(typeIds[begin + i], m_uriToIndexCache).getNodeId();
+      UA_NodeId_copy(typeUaNodeId.NodeId, &nodesToRead[i].nodeId);
+    }
+
+    {
+      std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+      readResponse = m_opcUaWrapper->SessionRead(m_pClient.get(), 0.0, UA_TIMESTAMPSTORETURN_NEITHER, nodesToRead, count, info);
+    }
+
+    if (UA_StatusCode_isBad(readResponse.responseHeader.serviceResult) || readResponse.resultsSize != count) {
+      LOG(INFO) << "Could not read the DataTypeDefinitions of " << count
+                << " DataTypes: " << UA_StatusCode_name(readResponse.responseHeader.serviceResult);
+      return false;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      const UA_DataValue &result = readResponse.results[i];
+      const auto &type = customTypes.at(typeIds[begin + i]);
+      if (UA_StatusCode_isBad(result.status) || !result.hasValue) {
+        ++missingDefinitions;
+      } else if (UA_Variant_hasScalarType(&result.value, &UA_TYPES[UA_TYPES_STRUCTUREDEFINITION])) {
+        if (!converter.AddStructuredType(type, toStructureDefinition(*static_cast<const UA_StructureDefinition *>(result.value.data)))) {
+          ++missingDefinitions;
+        }
+      } else if (UA_Variant_hasScalarType(&result.value, &UA_TYPES[UA_TYPES_ENUMDEFINITION])) {
+        converter.AddEnumeratedType(type, toEnumeratedValues(*static_cast<const UA_EnumDefinition *>(result.value.data)));
+      } else {
+        ++missingDefinitions;
+      }
+    }
+  }
+
+  // The XML TypeDictionaries decode the types without a usable definition as well, so they are used for the whole server
+  if (missingDefinitions != 0) {
+    LOG(INFO) << missingDefinitions << " of " << typeIds.size() << " custom DataTypes have no usable DataTypeDefinition";
+    return false;
+  }
+  for (auto &dictionary : converter.TakeDictionaries()) {
+    m_ptdv.push_back(std::move(dictionary));
+  }
+  return true;
+}
+
+void OpcUaClient::readTypeDictionariesFromXml() {
   std::map<ModelOpcUa::QualifiedName_t, ModelOpcUa::NodeId_t> nameToNodeId{};
   std::map<ModelOpcUa::QualifiedName_t, ModelOpcUa::NodeId_t> nameToBinaryNodeId{};
   const char *buffer = new char[1000];
@@ -432,6 +619,8 @@ bool OpcUaClient::connect() {
 void OpcUaClient::on_connected() {
   updateNamespaceCache();
   std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+  m_maxNodesPerBrowse = 0;
+  m_maxNodesPerRead = 0;
   m_opcUaWrapper->SubscriptionCreateSubscription(m_pClient.get());
 }
 
@@ -740,6 +929,182 @@ std::list<ModelOpcUa::BrowseResult_t> OpcUaClient::BrowseWithResultTypeFilter(
   return BrowseWithContextAndFilter(startNode, uaBrowseContext, filter);
 }
 
+std::vector<std::list<ModelOpcUa::BrowseResult_t>> OpcUaClient::BrowseMultiple(
+  const std::vector<ModelOpcUa::NodeId_t> &startNodes, BrowseContext_t browseContext) {
+  std::vector<std::list<ModelOpcUa::BrowseResult_t>> ret;
+  ret.reserve(startNodes.size());
+  checkConnection();
+  const std::size_t chunkSize = maxNodesPerBrowse();
+  UA_BrowseDescription uaBrowseContext = getUaBrowseContext(browseContext);
+  ScopeExitGuard contextGuard([&]() { UA_BrowseDescription_clear(&uaBrowseContext); });
+
+  for (std::size_t begin = 0; begin < startNodes.size(); begin += chunkSize) {
+    const std::size_t count = std::min(chunkSize, startNodes.size() - begin);
+    UA_BrowseRequest browseRequest;
+    UA_BrowseRequest_init(&browseRequest);
+    UA_BrowseResponse browseResponse;
+    UA_BrowseResponse_init(&browseResponse);
+    ScopeExitGuard browseGuard([&]() {
+      UA_BrowseRequest_clear(&browseRequest);
+      UA_BrowseResponse_clear(&browseResponse);
+    });
+
+    browseRequest.requestedMaxReferencesPerNode = 0;
+    browseRequest.nodesToBrowse = static_cast<UA_BrowseDescription *>(UA_Array_new(count, &UA_TYPES[UA_TYPES_BROWSEDESCRIPTION]));
+    browseRequest.nodesToBrowseSize = count;
+    for (std::size_t i = 0; i < count; ++i) {
+      UA_BrowseDescription_copy(&uaBrowseContext, &browseRequest.nodesToBrowse[i]);
+      open62541Cpp::UA_NodeId startUaNodeId = Converter::ModelNodeIdToUaNodeId(startNodes[begin + i], m_uriToIndexCache).getNodeId();
+      UA_NodeId_copy(startUaNodeId.NodeId, &browseRequest.nodesToBrowse[i].nodeId);
+    }
+
+    {
+      std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+      browseResponse = m_opcUaWrapper->SessionBrowseRequest(m_pClient.get(), browseRequest);
+    }
+
+    if (UA_StatusCode_isBad(browseResponse.responseHeader.serviceResult)) {
+      LOG(ERROR) << "Bad return from browse of " << count << " nodes: " << UA_StatusCode_name(browseResponse.responseHeader.serviceResult);
+      throw Exceptions::OpcUaNonGoodStatusCodeException(browseResponse.responseHeader.serviceResult);
+    }
+    if (browseResponse.resultsSize != count) {
+      LOG(ERROR) << "Browse of " << count << " nodes returned " << browseResponse.resultsSize << " results";
+      throw Exceptions::UmatiException("Invalid browse response");
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      const UA_BrowseResult &result = browseResponse.results[i];
+      if (UA_StatusCode_isBad(result.statusCode)) {
+        LOG(ERROR) << "Bad return from browse of " << static_cast<std::string>(startNodes[begin + i]) << ": " << UA_StatusCode_name(result.statusCode)
+                   << " Updating NamespaceCache...";
+        updateNamespaceCache();
+        throw Exceptions::OpcUaNonGoodStatusCodeException(result.statusCode);
+      }
+    }
+
+    // Servers limit the references per node of a single request, e.g. for folders with many machines
+    std::vector<UA_ByteString> continuationPoints;
+    std::vector<std::list<ModelOpcUa::BrowseResult_t> *> continuedResults;
+    for (std::size_t i = 0; i < count; ++i) {
+      const UA_BrowseResult &result = browseResponse.results[i];
+      std::vector<UA_ReferenceDescription> referenceDescriptions(result.references, result.references + result.referencesSize);
+      std::list<ModelOpcUa::BrowseResult_t> browseResult;
+      ReferenceDescriptionsToBrowseResults(referenceDescriptions, browseResult);
+      ret.push_back(std::move(browseResult));
+      if (result.continuationPoint.length > 0) {
+        UA_ByteString continuationPoint;
+        UA_ByteString_copy(&result.continuationPoint, &continuationPoint);
+        continuationPoints.push_back(continuationPoint);
+        // ret is reserved for all start nodes, so the pointer stays valid
+        continuedResults.push_back(&ret.back());
+      }
+    }
+    browseNext(std::move(continuationPoints), std::move(continuedResults));
+  }
+  return ret;
+}
+
+void OpcUaClient::browseNext(
+  std::vector<UA_ByteString> continuationPoints,
+  std::vector<std::list<ModelOpcUa::BrowseResult_t> *> browseResults,
+  std::function<bool(const UA_ReferenceDescription &)> filter) {
+  ScopeExitGuard continuationGuard([&]() {
+    if (continuationPoints.empty()) {
+      return;
+    }
+    // Continuation points hold resources on the server until they are read completely or released
+    UA_BrowseNextRequest releaseRequest;
+    UA_BrowseNextRequest_init(&releaseRequest);
+    releaseRequest.releaseContinuationPoints = true;
+    releaseRequest.continuationPoints = continuationPoints.data();
+    releaseRequest.continuationPointsSize = continuationPoints.size();
+    {
+      std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+      UA_BrowseNextResponse releaseResponse = m_opcUaWrapper->SessionBrowseNextRequest(m_pClient.get(), releaseRequest);
+      UA_BrowseNextResponse_clear(&releaseResponse);
+    }
+    for (auto &continuationPoint : continuationPoints) {
+      UA_ByteString_clear(&continuationPoint);
+    }
+  });
+
+  while (!continuationPoints.empty()) {
+    UA_BrowseNextRequest request;
+    UA_BrowseNextRequest_init(&request);
+    request.releaseContinuationPoints = false;
+    // Borrowed from continuationPoints, so the request is not cleared
+    request.continuationPoints = continuationPoints.data();
+    request.continuationPointsSize = continuationPoints.size();
+    UA_BrowseNextResponse response;
+    UA_BrowseNextResponse_init(&response);
+    {
+      std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+      response = m_opcUaWrapper->SessionBrowseNextRequest(m_pClient.get(), request);
+    }
+    ScopeExitGuard responseGuard([&]() { UA_BrowseNextResponse_clear(&response); });
+
+    if (UA_StatusCode_isBad(response.responseHeader.serviceResult)) {
+      LOG(ERROR) << "Bad return from BrowseNext of " << continuationPoints.size() << " continuation points: " << UA_StatusCode_name(response.responseHeader.serviceResult);
+      throw Exceptions::OpcUaNonGoodStatusCodeException(response.responseHeader.serviceResult);
+    }
+    if (response.resultsSize != continuationPoints.size()) {
+      LOG(ERROR) << "BrowseNext of " << continuationPoints.size() << " continuation points returned " << response.resultsSize << " results";
+      throw Exceptions::UmatiException("Invalid BrowseNext response");
+    }
+    for (std::size_t i = 0; i < response.resultsSize; ++i) {
+      if (UA_StatusCode_isBad(response.results[i].statusCode)) {
+        LOG(ERROR) << "Bad return from BrowseNext: " << UA_StatusCode_name(response.results[i].statusCode);
+        throw Exceptions::OpcUaNonGoodStatusCodeException(response.results[i].statusCode);
+      }
+    }
+
+    std::vector<UA_ByteString> nextContinuationPoints;
+    std::vector<std::list<ModelOpcUa::BrowseResult_t> *> nextBrowseResults;
+    for (std::size_t i = 0; i < response.resultsSize; ++i) {
+      const UA_BrowseResult &result = response.results[i];
+      std::vector<UA_ReferenceDescription> referenceDescriptions(result.references, result.references + result.referencesSize);
+      ReferenceDescriptionsToBrowseResults(referenceDescriptions, *browseResults[i], filter);
+      UA_ByteString_clear(&continuationPoints[i]);
+      if (result.continuationPoint.length > 0) {
+        UA_ByteString continuationPoint;
+        UA_ByteString_copy(&result.continuationPoint, &continuationPoint);
+        nextContinuationPoints.push_back(continuationPoint);
+        nextBrowseResults.push_back(browseResults[i]);
+      }
+    }
+    continuationPoints = std::move(nextContinuationPoints);
+    browseResults = std::move(nextBrowseResults);
+  }
+}
+
+std::size_t OpcUaClient::maxNodesPerBrowse() {
+  return readOperationLimit(UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERBROWSE, "MaxNodesPerBrowse", m_maxNodesPerBrowse);
+}
+
+std::size_t OpcUaClient::maxNodesPerRead() {
+  return readOperationLimit(UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERREAD, "MaxNodesPerRead", m_maxNodesPerRead);
+}
+
+std::size_t OpcUaClient::readOperationLimit(UA_UInt32 limitNodeId, const char *limitName, std::size_t &limit) {
+  // Used if the server does not limit the request size, keeps single requests reasonably small
+  const std::size_t defaultLimit = 1000;
+  std::lock_guard<std::recursive_mutex> l(m_clientMutex);
+  if (limit != 0) {
+    return limit;
+  }
+  UA_Variant value;
+  UA_Variant_init(&value);
+  UA_StatusCode status = UA_Client_readValueAttribute(m_pClient.get(), UA_NODEID_NUMERIC(0, limitNodeId), &value);
+  limit = defaultLimit;
+  if (UA_StatusCode_isBad(status)) {
+    LOG(INFO) << "Could not read " << limitName << " (" << UA_StatusCode_name(status) << "), sending at most " << limit << " nodes per request";
+  } else if (UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_UINT32]) && *static_cast<UA_UInt32 *>(value.data) != 0) {
+    limit = std::min<std::size_t>(*static_cast<UA_UInt32 *>(value.data), defaultLimit);
+  }
+  UA_Variant_clear(&value);
+  return limit;
+}
+
 UA_NodeClass OpcUaClient::nodeClassFromNodeId(const open62541Cpp::UA_NodeId &typeDefinitionUaNodeId) {
   UA_NodeClass nodeClass = readNodeClass(typeDefinitionUaNodeId);
 
@@ -791,7 +1156,11 @@ std::list<ModelOpcUa::BrowseResult_t> OpcUaClient::BrowseWithContextAndFilter(
   std::list<ModelOpcUa::BrowseResult_t> browseResult;
   ReferenceDescriptionsToBrowseResults(referenceDescriptions, browseResult, filter);
 
-  handleContinuationPoint(continuationPoint);
+  if (uaResult.resultsSize > 0 && uaResult.results->continuationPoint.length > 0) {
+    UA_ByteString resultContinuationPoint;
+    UA_ByteString_copy(&uaResult.results->continuationPoint, &resultContinuationPoint);
+    browseNext({resultContinuationPoint}, {&browseResult}, filter);
+  }
 
   return browseResult;
 }
@@ -810,10 +1179,6 @@ void OpcUaClient::ReferenceDescriptionsToBrowseResults(
   }
 }
 
-void OpcUaClient::handleContinuationPoint(const UA_ByteString & /*continuationPoint*/) {
-  // LOG(DEBUG) << "Handling continuation point not yet implemented";
-}
-
 ModelOpcUa::BrowseResult_t OpcUaClient::ReferenceDescriptionToBrowseResult(const UA_ReferenceDescription &referenceDescription) {
   ModelOpcUa::BrowseResult_t entry;
 
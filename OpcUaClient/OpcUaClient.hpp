@@ -58,6 +58,10 @@ class OpcUaClient : public Dashboard::IDashboardDataClient {
   std::list<ModelOpcUa::BrowseResult_t> BrowseWithResultTypeFilter(
     ModelOpcUa::NodeId_t startNode, BrowseContext_t browseContext, ModelOpcUa::NodeId_t typeDefinition) override;
 
+  /// Sends the nodes in chunks of MaxNodesPerBrowse of the server
+  std::vector<std::list<ModelOpcUa::BrowseResult_t>> BrowseMultiple(
+    const std::vector<ModelOpcUa::NodeId_t> &startNodes, BrowseContext_t browseContext) override;
+
   ModelOpcUa::NodeId_t TranslateBrowsePathToNodeId(ModelOpcUa::NodeId_t startNode, ModelOpcUa::QualifiedName_t browseName) override;
 
   std::shared_ptr<ValueSubscriptionHandle> Subscribe(ModelOpcUa::NodeId_t nodeId, newValueCallbackFunction_t callback) override;
@@ -98,6 +102,20 @@ class OpcUaClient : public Dashboard::IDashboardDataClient {
 
   double m_maxAgeRead_ms = 100.0;
 
+  /// OperationLimits/MaxNodesPerBrowse of the server, read on first use after each connect, 0 if unknown
+  std::size_t m_maxNodesPerBrowse = 0;
+  std::size_t maxNodesPerBrowse();
+  /// OperationLimits/MaxNodesPerRead of the server, read on first use after each connect, 0 if unknown
+  std::size_t m_maxNodesPerRead = 0;
+  std::size_t maxNodesPerRead();
+  std::size_t readOperationLimit(UA_UInt32 limitNodeId, const char *limitName, std::size_t &limit);
+
+  /// Builds the TypeDictionaries from the DataTypeDefinition attributes (OPC UA 1.04) of the custom DataTypes.
+  /// Returns false without adding any if a type has no usable definition, e.g. as the server implements an older version of the specification.
+  bool readDataTypeDefinitions();
+  /// Parses the binary TypeDictionaries of the server
+  void readTypeDictionariesFromXml();
+
   void updateNamespaceCache();
   /// Ensure that the new namespace chache is compatible to the current class state.
   /// Verifies, that no namespace has been removed, or reordered.
@@ -182,7 +200,12 @@ class OpcUaClient : public Dashboard::IDashboardDataClient {
 
   UA_BrowseDescription prepareBrowseContext(ModelOpcUa::NodeId_t referenceTypeId);
 
-  static void handleContinuationPoint(const UA_ByteString & /*continuationPoint*/);
+  /// Reads the remaining references of each continuation point with BrowseNext and appends them to its browse result.
+  /// Takes ownership of the continuation points, they are released on the server if an error interrupts the reading.
+  void browseNext(
+    std::vector<UA_ByteString> continuationPoints,
+    std::vector<std::list<ModelOpcUa::BrowseResult_t> *> browseResults,
+    std::function<bool(const UA_ReferenceDescription &)> filter = [](const UA_ReferenceDescription &) { return true; });
 
   void ReferenceDescriptionsToBrowseResults(
     const std::vector<UA_ReferenceDescription> &referenceDescriptions,
@@ -54,6 +54,12 @@ class OpcUaInterface {
     UA_ByteString &continuationPoint,
     std::vector<UA_ReferenceDescription> &referenceDescriptions) = 0;
 
+  /// One Browse request for all nodesToBrowse of the request, the caller clears the response
+  virtual UA_BrowseResponse SessionBrowseRequest(UA_Client *client, const UA_BrowseRequest &browseRequest) = 0;
+
+  /// One BrowseNext request for all continuation points of the request, the caller clears the response
+  virtual UA_BrowseNextResponse SessionBrowseNextRequest(UA_Client *client, const UA_BrowseNextRequest &browseNextRequest) = 0;
+
   virtual UA_StatusCode SessionTranslateBrowsePathsToNodeIds(
     UA_Client *client, UA_BrowsePath &browsePaths, UA_BrowsePathResult &browsePathResults, UA_DiagnosticInfo &diagnosticInfos) = 0;
 
@@ -181,6 +187,14 @@ class OpcUaWrapper : public OpcUaInterface {
     return browseResponse;
   }
 
+  UA_BrowseResponse SessionBrowseRequest(UA_Client *client, const UA_BrowseRequest &browseRequest) override {
+    return UA_Client_Service_browse(client, browseRequest);
+  }
+
+  UA_BrowseNextResponse SessionBrowseNextRequest(UA_Client *client, const UA_BrowseNextRequest &browseNextRequest) override {
+    return UA_Client_Service_browseNext(client, browseNextRequest);
+  }
+
   UA_StatusCode SessionTranslateBrowsePathsToNodeIds(
     UA_Client *client, UA_BrowsePath &browsePaths, UA_BrowsePathResult &browsePathResults, UA_DiagnosticInfo &diagnosticInfos) override {
     UA_TranslateBrowsePathsToNodeIdsRequest request;
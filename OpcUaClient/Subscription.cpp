@@ -70,21 +70,35 @@ namespace Umati {
 			}
 		}
 
+		std::chrono::system_clock::time_point Subscription::sourceTimestamp(const UA_DataValue &dataValue) {
+			UA_DateTime dateTime;
+			if (dataValue.hasSourceTimestamp) {
+				dateTime = dataValue.sourceTimestamp;
+			} else if (dataValue.hasServerTimestamp) {
+				dateTime = dataValue.serverTimestamp;
+			} else {
+				return std::chrono::system_clock::now();
+			}
+			std::chrono::milliseconds sinceUnixEpoch((dateTime - UA_DATETIME_UNIX_EPOCH) / UA_DATETIME_MSEC);
+			return std::chrono::system_clock::time_point(
+				std::chrono::duration_cast<std::chrono::system_clock::duration>(sinceUnixEpoch));
+		}
+
 		void Subscription::dataChange(UA_Int32 /*clientSubscriptionHandle*/,
 									  const UA_DataChangeNotification &dataNotifications,
 									  const UA_DiagnosticInfo & /*diagnosticInfos*/, UA_Client *client, UA_NodeId nid) {
 			std::unique_lock<decltype(m_callbacks_mutex)> ul(m_callbacks_mutex);
 			for (UA_Int32 i = 0; i < dataNotifications.monitoredItemsSize; ++i) {
-				auto clientHandle = dataNotifications.monitoredItems->clientHandle;
-				auto it = m_callbacks.find(clientHandle);
+				const auto &monitoredItem = dataNotifications.monitoredItems[i];
+				auto it = m_callbacks.find(monitoredItem.clientHandle);
 				if (it == m_callbacks.end()) {
 					LOG(WARNING) << "Received Item with unknown client handle.";
 					continue;
 				}
 				
-				auto value = Converter::UaDataValueToJsonValue(UA_DataValue(dataNotifications.monitoredItems->value), client, nid, 
+				auto value = Converter::UaDataValueToJsonValue(UA_DataValue(monitoredItem.value), client, nid, 
 															   false).getValue();
-				it->second(value);
+				it->second(value, sourceTimestamp(monitoredItem.value));
 			}
 		}
 
@@ -19,6 +19,7 @@
 #include <IDashboardDataClient.hpp>
 #include "OpcUaSubscriptionInterface.hpp"
 #include <mutex>
+#include <chrono>
 
 namespace Umati {
 	namespace OpcUa  {
@@ -69,6 +70,8 @@ namespace Umati {
 			prepareMonItemCreateReq(const ModelOpcUa::NodeId_t &nodeId,
 									UA_MonitoredItemCreateRequest &monItemCreateReq) const;
 
+			static std::chrono::system_clock::time_point sourceTimestamp(const UA_DataValue &dataValue);
+
 			static void
 			validateMonitorItemResult(const UA_StatusCode &uaResult, UA_MonitoredItemCreateResult monItemCreateResult,
 									const ModelOpcUa::NodeId_t &nodeId);
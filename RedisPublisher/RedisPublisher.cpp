@@ -0,0 +1,198 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "RedisPublisher.hpp"
+
+#include <Iso8601.hpp>
+#include <easylogging++.h>
+
+#include <algorithm>
+
+namespace Umati {
+namespace RedisPublisher {
+RedisPublisher::RedisPublisher(const Umati::Util::RedisConfig &config)
+  : m_config(config), m_streamClasses(config.StreamClasses.begin(), config.StreamClasses.end()) {
+  try {
+    connect();
+  } catch (const cpp_redis::redis_error &ex) {
+    LOG(WARNING) << "Could not connect to redis " << m_config.Hostname << ":" << m_config.Port << ", retrying: " << ex.what();
+  }
+  m_flushThread = std::thread(&RedisPublisher::flushLoop, this);
+}
+
+RedisPublisher::~RedisPublisher() {
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    m_stopped = true;
+  }
+  m_cv.notify_all();
+  m_flushThread.join();
+  if (m_client.is_connected()) {
+    try {
+      m_client.sync_commit(std::chrono::seconds(1));
+    } catch (const cpp_redis::redis_error &ex) {
+      LOG(WARNING) << "Could not send the pending redis commands: " << ex.what();
+    }
+    m_client.disconnect(true);
+  }
+}
+
+void RedisPublisher::Publish(std::string channel, std::string message) {
+  Publish(std::move(channel), std::move(message), Umati::Dashboard::PublishOptions());
+}
+
+void RedisPublisher::Publish(std::string channel, std::string message, const Umati::Dashboard::PublishOptions &options) {
+  std::lock_guard<std::mutex> l(m_mutex);
+  ++m_statistics.messages;
+  if (m_connecting || !m_client.is_connected()) {
+    ++m_statistics.dropped;
+    if (!options.Retain) {
+      m_droppedChannels.insert(std::move(channel));
+    }
+    return;
+  }
+
+  std::string key = m_config.KeyPrefix + channel;
+  if (m_streamClasses.count(options.TopicClass) != 0) {
+    std::vector<std::string> command{"XADD", key + ":stream"};
+    if (m_config.StreamMaxLength != 0) {
+      command.insert(command.end(), {"MAXLEN", "~", std::to_string(m_config.StreamMaxLength)});
+    }
+    command.insert(command.end(), {"*", "payload", message});
+    send(std::move(command));
+  }
+  if (options.Retain) {
+    if (message.empty()) {
+      send({"DEL", key});
+      send({"HDEL", m_config.KeyPrefix + "$topics", channel});
+    } else {
+      send({"SET", key, std::move(message)});
+      send({"HSET", m_config.KeyPrefix + "$topics", std::move(channel), Umati::Util::ToIso8601(std::chrono::system_clock::now())});
+    }
+  }
+  if (m_pending >= m_config.BatchSize) {
+    commit();
+  }
+}
+
+bool RedisPublisher::TakeDropped(const std::string &channel) {
+  std::lock_guard<std::mutex> l(m_mutex);
+  return m_droppedChannels.erase(channel) > 0;
+}
+
+std::uint64_t RedisPublisher::DroppedMessages() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  return m_statistics.dropped;
+}
+
+std::uint64_t RedisPublisher::ConnectGeneration() { return m_connectGeneration; }
+
+RedisPublisher::Statistics_t RedisPublisher::GetStatistics() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  auto statistics = m_statistics;
+  statistics.errors = m_errors;
+  return statistics;
+}
+
+void RedisPublisher::connect() {
+  // After a connection was established, cpp_redis reconnects on its own and repeats AUTH and SELECT
+  m_client.connect(
+    m_config.Hostname,
+    m_config.Port,
+    [this](const std::string &host, std::size_t port, cpp_redis::connect_state state) {
+      if (state == cpp_redis::connect_state::dropped) {
+        LOG(WARNING) << "Connection to redis " << host << ":" << port << " lost";
+      } else if (state == cpp_redis::connect_state::ok) {
+        LOG(INFO) << "Connected to redis " << host << ":" << port;
+        // Keys might be lost, e.g. after a restart without persistence, and the messages dropped meanwhile are missing
+        ++m_connectGeneration;
+      }
+    },
+    0,
+    -1,
+    1000);
+  if (!m_config.Password.empty()) {
+    m_client.auth(m_config.Password, [](cpp_redis::reply &reply) {
+      if (reply.is_error()) {
+        LOG(ERROR) << "Redis authentication failed: " << reply.error();
+      }
+    });
+  }
+  if (m_config.Database != 0) {
+    m_client.select(static_cast<int>(m_config.Database));
+  }
+  m_client.commit();
+}
+
+void RedisPublisher::send(std::vector<std::string> command) {
+  m_client.send(command, [this](cpp_redis::reply &reply) {
+    if (reply.is_error() && m_errors++ == 0) {
+      // Further errors are only counted, as they usually have the same cause
+      LOG(ERROR) << "Redis command failed: " << reply.error();
+    }
+  });
+  ++m_pending;
+  ++m_statistics.commands;
+}
+
+void RedisPublisher::commit() {
+  if (m_pending == 0) {
+    return;
+  }
+  try {
+    m_client.commit();
+    ++m_statistics.pipelines;
+  } catch (const cpp_redis::redis_error &ex) {
+    LOG(WARNING) << "Could not send " << m_pending << " redis commands: " << ex.what();
+  }
+  m_pending = 0;
+}
+
+void RedisPublisher::flushLoop() {
+  const auto interval = std::chrono::milliseconds(std::max<std::uint32_t>(m_config.FlushInterval, 1));
+  auto lastStatistics = std::chrono::steady_clock::now();
+  auto lastConnect = lastStatistics;
+  Statistics_t lastTotals;
+
+  std::unique_lock<std::mutex> ul(m_mutex);
+  while (!m_stopped) {
+    m_cv.wait_for(ul, interval);
+    if (m_stopped) {
+      break;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (m_client.is_connected()) {
+      commit();
+    } else if (!m_client.is_reconnecting() && now - lastConnect >= std::chrono::seconds(1)) {
+      lastConnect = now;
+      // Connecting blocks up to the timeout, Publish drops the messages meanwhile instead of waiting for m_mutex
+      m_connecting = true;
+      ul.unlock();
+      try {
+        connect();
+      } catch (const cpp_redis::redis_error &) {
+        // Retried after a second
+      }
+      ul.lock();
+      m_connecting = false;
+      if (m_stopped) {
+        break;
+      }
+    }
+
+    if (now - lastStatistics >= std::chrono::minutes(1)) {
+      LOG(INFO) << "Redis sink: " << m_statistics.messages - lastTotals.messages << " messages, " << m_statistics.commands - lastTotals.commands
+                << " commands in " << m_statistics.pipelines - lastTotals.pipelines << " pipelines, " << m_statistics.dropped - lastTotals.dropped
+                << " dropped, " << m_errors << " errors in total";
+      lastStatistics = now;
+      lastTotals = m_statistics;
+    }
+  }
+  commit();
+}
+}  // namespace RedisPublisher
+}  // namespace Umati
@@ -0,0 +1,94 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <Configuration.hpp>
+#include <IPublisher.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cpp_redis/cpp_redis>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace Umati {
+namespace RedisPublisher {
+/**
+ * Writes the messages to Redis instead of an MQTT broker.
+ *
+ * - Retained messages are stored with SET <KeyPrefix><Topic>, an empty message deletes the key.
+ *   The hash <KeyPrefix>$topics maps each stored topic to the time of its last update, so consumers do not need to scan the keyspace.
+ * - Messages of the StreamClasses (by default machine documents and merge patches) are appended with
+ *   XADD <KeyPrefix><Topic>:stream MAXLEN ~ <StreamMaxLength> * payload <Message>.
+ *
+ * Commands are collected and sent as one pipeline every FlushInterval or once BatchSize commands are pending.
+ * While the connection is lost or being established messages are dropped without waiting for the connect.
+ * TakeDropped reports the channels of dropped not retained messages and each connect starts a new ConnectGeneration,
+ * so the DashboardClient resends the full documents.
+ */
+class RedisPublisher : public Umati::Dashboard::IPublisher {
+ public:
+  struct Statistics_t {
+    std::uint64_t messages = 0;
+    std::uint64_t commands = 0;
+    std::uint64_t pipelines = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t dropped = 0;
+  };
+
+  explicit RedisPublisher(const Umati::Util::RedisConfig &config);
+  /// Sends the pending commands
+  ~RedisPublisher() override;
+
+  RedisPublisher(const RedisPublisher &) = delete;
+  RedisPublisher &operator=(const RedisPublisher &) = delete;
+
+  void Publish(std::string channel, std::string message) override;
+
+  void Publish(std::string channel, std::string message, const Umati::Dashboard::PublishOptions &options) override;
+
+  bool TakeDropped(const std::string &channel) override;
+  std::uint64_t DroppedMessages() override;
+  /// Incremented by the connect callback, also for the automatic reconnects of cpp_redis
+  std::uint64_t ConnectGeneration() override;
+
+  /// Totals since the start
+  Statistics_t GetStatistics();
+
+ private:
+  /// Throws cpp_redis::redis_error, must not be called with m_mutex
+  void connect();
+  /// Requires m_mutex
+  void send(std::vector<std::string> command);
+  /// Requires m_mutex
+  void commit();
+  void flushLoop();
+
+  const Umati::Util::RedisConfig m_config;
+  const std::set<std::string> m_streamClasses;
+  cpp_redis::client m_client;
+
+  std::mutex m_mutex;
+  std::size_t m_pending = 0;
+  /// Set while the flush thread connects without m_mutex, Publish must not use m_client meanwhile
+  bool m_connecting = false;
+  Statistics_t m_statistics;
+  /// Channels of not retained messages dropped since the last TakeDropped
+  std::set<std::string> m_droppedChannels;
+  std::atomic<std::uint64_t> m_connectGeneration{0};
+  /// Updated from the reply callbacks
+  std::atomic<std::uint64_t> m_errors{0};
+
+  bool m_stopped = false;
+  std::condition_variable m_cv;
+  std::thread m_flushThread;
+};
+}  // namespace RedisPublisher
+}  // namespace Umati
@@ -0,0 +1,84 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <IPublisher.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Umati {
+namespace Tests {
+/**
+ * Publisher for the tests that keeps all messages in memory.
+ *
+ * Block lets Publish wait until Unblock is called, e.g. to simulate a slow sink.
+ * Channels in dropped are reported once by TakeDropped, connectGeneration is returned by ConnectGeneration.
+ * Read messages and retained only while no other thread publishes.
+ */
+class RecordingPublisher : public Dashboard::IPublisher {
+ public:
+  void Publish(std::string channel, std::string message) override { Publish(std::move(channel), std::move(message), Dashboard::PublishOptions()); }
+
+  void Publish(std::string channel, std::string message, const Dashboard::PublishOptions &options) override {
+    std::unique_lock<std::mutex> ul(m_mutex);
+    m_cv.wait(ul, [this]() { return !m_blocked; });
+    messages.emplace_back(std::move(channel), std::move(message));
+    retained.push_back(options.Retain);
+  }
+
+  bool TakeDropped(const std::string &channel) override {
+    std::lock_guard<std::mutex> l(m_mutex);
+    return dropped.erase(channel) > 0;
+  }
+
+  std::uint64_t ConnectGeneration() override { return connectGeneration; }
+
+  void Block() {
+    std::lock_guard<std::mutex> l(m_mutex);
+    m_blocked = true;
+  }
+
+  void Unblock() {
+    {
+      std::lock_guard<std::mutex> l(m_mutex);
+      m_blocked = false;
+    }
+    m_cv.notify_all();
+  }
+
+  std::size_t Count() {
+    std::lock_guard<std::mutex> l(m_mutex);
+    return messages.size();
+  }
+
+  /// Number of messages with this channel and payload
+  std::size_t Count(const std::string &channel, const std::string &message) {
+    std::lock_guard<std::mutex> l(m_mutex);
+    return static_cast<std::size_t>(std::count(messages.begin(), messages.end(), std::make_pair(channel, message)));
+  }
+
+  std::vector<std::pair<std::string, std::string>> messages;
+  /// Retain flag of each message
+  std::vector<bool> retained;
+  std::set<std::string> dropped;
+  std::atomic<std::uint64_t> connectGeneration{1};
+
+ private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_blocked = false;
+};
+}  // namespace Tests
+}  // namespace Umati
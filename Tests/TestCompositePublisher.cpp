@@ -0,0 +1,69 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <CompositePublisher.hpp>
+#include <chrono>
+#include <thread>
+
+#include "RecordingPublisher.hpp"
+
+namespace Umati {
+namespace Tests {
+TEST(CompositePublisher, BlockedSinkDoesNotDelayOthers) {
+  auto pFast = std::make_shared<RecordingPublisher>();
+  auto pBlocked = std::make_shared<RecordingPublisher>();
+  pBlocked->Block();
+  {
+    Umati::Dashboard::CompositePublisher composite;
+    composite.AddSink("fast", pFast, 100);
+    composite.AddSink("blocked", pBlocked, 2);
+
+    Umati::Dashboard::PublishOptions notRetained;
+    notRetained.Retain = false;
+    for (int i = 0; i < 10; ++i) {
+      composite.Publish("a", std::to_string(i), notRetained);
+    }
+    for (int i = 0; i < 1000 && pFast->Count() < 10; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(pFast->Count(), 10u);
+    EXPECT_EQ(pBlocked->Count(), 0u);
+
+    auto statistics = composite.GetStatistics();
+    ASSERT_EQ(statistics.size(), 2u);
+    EXPECT_EQ(statistics[1].first, "blocked");
+    EXPECT_GT(statistics[1].second.dropped, 0u);
+    pBlocked->Unblock();
+  }
+  // The newest messages are kept in order, the queue of the blocked sink dropped the oldest
+  ASSERT_FALSE(pBlocked->messages.empty());
+  EXPECT_EQ(pBlocked->messages.back().second, "9");
+  EXPECT_EQ(pFast->messages.front().second, "0");
+}
+
+TEST(CompositePublisher, ShutdownWithBlockedSink) {
+  auto pBlocked = std::make_shared<RecordingPublisher>();
+  pBlocked->Block();
+  auto start = std::chrono::steady_clock::now();
+  {
+    Umati::Dashboard::CompositePublisher composite(std::chrono::milliseconds(50));
+    composite.AddSink("blocked", pBlocked, 10);
+    composite.Publish("a", "1");
+    composite.Publish("b", "1");
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+
+  // The detached thread still owns the sink and sends the rest when it is unblocked
+  pBlocked->Unblock();
+  for (int i = 0; i < 1000 && pBlocked->Count() < 2; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(pBlocked->Count(), 2u);
+}
+}  // namespace Tests
+}  // namespace Umati
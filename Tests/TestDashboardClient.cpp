@@ -0,0 +1,342 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <DashboardClient.hpp>
+#include <algorithm>
+
+#include "RecordingPublisher.hpp"
+
+namespace Umati {
+namespace Tests {
+namespace {
+const std::string Uri = "http://example.com/UA/";
+
+class Client : public Dashboard::DashboardClient {
+ public:
+  using DashboardClient::DataSetStorage_t;
+  using DashboardClient::LastMessage_t;
+  using DashboardClient::Leaf_t;
+  using DashboardClient::findValue;
+  using DashboardClient::getJson;
+  using DashboardClient::m_dataSets;
+  using DashboardClient::m_publishConfig;
+  using DashboardClient::publishDelta;
+  using DashboardClient::setupRateGroups;
+
+  explicit Client(
+    Util::PublishConfig publishConfig = Util::PublishConfig(),
+    std::shared_ptr<Dashboard::IPublisher> pPublisher = nullptr,
+    std::shared_ptr<Dashboard::UadpWriterGroup> pUadpWriterGroup = nullptr)
+    : DashboardClient(nullptr, std::move(pPublisher), nullptr, std::move(publishConfig), nullptr, std::move(pUadpWriterGroup)) {}
+
+  std::vector<Leaf_t> CollectLeaves(const std::shared_ptr<const ModelOpcUa::Node> &pNode, const std::string &topic) {
+    std::vector<Leaf_t> leaves;
+    collectLeaves(pNode, topic, leaves);
+    return leaves;
+  }
+};
+
+std::shared_ptr<const ModelOpcUa::SimpleNode> node(
+  ModelOpcUa::NodeClass_t nodeClass,
+  const std::string &name,
+  const std::list<std::shared_ptr<const ModelOpcUa::Node>> &children = {},
+  ModelOpcUa::ModellingRule_t modellingRule = ModelOpcUa::Mandatory) {
+  ModelOpcUa::NodeDefinition definition(
+    nodeClass, modellingRule, ModelOpcUa::NodeId_t{Uri, "i=47"}, ModelOpcUa::NodeId_t{Uri, "i=63"}, ModelOpcUa::QualifiedName_t{Uri, name});
+  return std::make_shared<ModelOpcUa::SimpleNode>(ModelOpcUa::NodeId_t{Uri, "s=" + name}, ModelOpcUa::NodeId_t{Uri, "i=63"}, definition, children);
+}
+
+std::shared_ptr<ModelOpcUa::SimpleNode> baseDataVariable(const std::string &name, const std::list<std::shared_ptr<const ModelOpcUa::Node>> &children) {
+  auto pNode = std::const_pointer_cast<ModelOpcUa::SimpleNode>(node(ModelOpcUa::Variable, name, children));
+  pNode->ofBaseDataVariableType = true;
+  return pNode;
+}
+
+std::shared_ptr<const ModelOpcUa::Node> child(const std::shared_ptr<const ModelOpcUa::Node> &pNode, const std::string &name) {
+  for (const auto &pChild : std::dynamic_pointer_cast<const ModelOpcUa::SimpleNode>(pNode)->ChildNodes) {
+    if (pChild->SpecifiedBrowseName.Name == name) {
+      return pChild;
+    }
+  }
+  return nullptr;
+}
+
+Util::RateGroupConfig rateGroup(const std::string &name, const std::string &path, bool merged) {
+  Util::RateGroupConfig config;
+  config.Name = name;
+  config.Paths.push_back(path);
+  config.Interval = 0;
+  config.Merged = merged;
+  return config;
+}
+
+std::vector<std::string> topics(const std::vector<Client::Leaf_t> &leaves) {
+  std::vector<std::string> ret;
+  for (const auto &leaf : leaves) {
+    ret.push_back(leaf.topic);
+  }
+  return ret;
+}
+}  // namespace
+
+TEST(DashboardClient, CollectLeavesMirrorsTheDocument) {
+  auto speed = node(ModelOpcUa::Variable, "Speed", {node(ModelOpcUa::Variable, "EURange")});
+  auto identification = node(ModelOpcUa::Object, "Identification", {node(ModelOpcUa::Variable, "Serial Number")});
+  auto machine = node(ModelOpcUa::Object, "Machine", {identification, speed, node(ModelOpcUa::Variable, "Name", {}, ModelOpcUa::Optional)});
+
+  Client client;
+  auto leaves = client.CollectLeaves(machine, "umati/machine");
+  // Variables below variables are leaves of their own, names are encoded for the topic
+  EXPECT_EQ(
+    topics(leaves),
+    (std::vector<std::string>{
+      "umati/machine/Identification/Serial_20Number", "umati/machine/Speed", "umati/machine/Speed/EURange", "umati/machine/Name"}));
+  EXPECT_EQ(leaves[1].node, speed);
+  EXPECT_TRUE(leaves[1].lastValue.is_null());
+}
+
+TEST(DashboardClient, CollectLeavesOfPlaceholders) {
+  auto placeholder = std::make_shared<ModelOpcUa::PlaceholderNode>(
+    ModelOpcUa::NodeDefinition(
+      ModelOpcUa::Object,
+      ModelOpcUa::OptionalPlaceholder,
+      ModelOpcUa::NodeId_t{Uri, "i=47"},
+      ModelOpcUa::NodeId_t{Uri, "i=58"},
+      ModelOpcUa::QualifiedName_t{Uri, "<Tool>"}),
+    std::list<std::shared_ptr<const ModelOpcUa::Node>>{});
+  placeholder->addInstance(ModelOpcUa::PlaceholderElement{
+    node(ModelOpcUa::Object, "Tool1", {node(ModelOpcUa::Variable, "Length")}), ModelOpcUa::QualifiedName_t{Uri, "Tool1"}, ModelOpcUa::NodeId_t{}});
+  auto machine = node(ModelOpcUa::Object, "Machine", {placeholder, node(ModelOpcUa::Variable, "Skipped", {}, ModelOpcUa::None)});
+
+  Client client;
+  // Like in the document, the instances are nested below the placeholder
+  EXPECT_EQ(topics(client.CollectLeaves(machine, "m")), (std::vector<std::string>{"m/_3CTool_3E/Tool1/Length"}));
+}
+
+TEST(DashboardClient, SnapshotAfterDroppedPatch) {
+  Util::PublishConfig publishConfig;
+  publishConfig.DeltaMode = true;
+  publishConfig.SnapshotInterval = 60;
+  auto pPublisher = std::make_shared<RecordingPublisher>();
+  Client client(publishConfig, pPublisher);
+  auto pDataSetStorage = std::make_shared<Client::DataSetStorage_t>();
+  pDataSetStorage->channel = "m";
+  pDataSetStorage->deltaChannel = "m/$delta";
+  Client::LastMessage_t lastMessage;
+
+  client.publishDelta(pDataSetStorage, {{"a", 1}}, lastMessage, 100);
+  client.publishDelta(pDataSetStorage, {{"a", 2}}, lastMessage, 101);
+  pPublisher->dropped.insert("m/$delta");
+  client.publishDelta(pDataSetStorage, {{"a", 3}}, lastMessage, 102);
+  client.publishDelta(pDataSetStorage, {{"a", 4}}, lastMessage, 103);
+
+  ASSERT_EQ(pPublisher->messages.size(), 4u);
+  EXPECT_EQ(pPublisher->messages[0].first, "m");
+  EXPECT_EQ(pPublisher->messages[1].first, "m/$delta");
+  // The dropped patch contained a = 2, so the next message is the full document
+  EXPECT_EQ(pPublisher->messages[2].first, "m");
+  EXPECT_EQ(nlohmann::json::parse(pPublisher->messages[2].second), (nlohmann::json{{"a", 3}}));
+  EXPECT_EQ(pPublisher->messages[3].first, "m/$delta");
+}
+
+TEST(DashboardClient, RepublishOnlineAfterReconnect) {
+  auto pPublisher = std::make_shared<RecordingPublisher>();
+  Client client(Util::PublishConfig(), pPublisher);
+  auto name = node(ModelOpcUa::Variable, "Name");
+  auto pDataSetStorage = std::make_shared<Client::DataSetStorage_t>();
+  pDataSetStorage->channel = "m";
+  pDataSetStorage->onlineChannel = "m/online";
+  pDataSetStorage->node = node(ModelOpcUa::Object, "Machine", {name});
+  pDataSetStorage->fastNode = pDataSetStorage->node;
+  pDataSetStorage->values[name].value = "Machine 1";
+  client.m_dataSets.push_back(pDataSetStorage);
+
+  client.Publish();
+  client.Publish();
+  EXPECT_EQ(pPublisher->Count("m/online", "1"), 1u);
+
+  // Without StatusRefreshInterval, only a new connection republishes the retained state
+  ++pPublisher->connectGeneration;
+  client.Publish();
+  client.Publish();
+  EXPECT_EQ(pPublisher->Count("m/online", "1"), 2u);
+  EXPECT_EQ(pPublisher->Count("m", "{\n  \"Name\": \"Machine 1\"\n}"), 1u);
+}
+
+TEST(DashboardClient, SnapshotAfterReconnect) {
+  Util::PublishConfig publishConfig;
+  publishConfig.DeltaMode = true;
+  publishConfig.SnapshotInterval = 3600;
+  auto pPublisher = std::make_shared<RecordingPublisher>();
+  Client client(publishConfig, pPublisher);
+  auto name = node(ModelOpcUa::Variable, "Name");
+  auto pDataSetStorage = std::make_shared<Client::DataSetStorage_t>();
+  pDataSetStorage->channel = "m";
+  pDataSetStorage->deltaChannel = "m/$delta";
+  pDataSetStorage->node = node(ModelOpcUa::Object, "Machine", {name});
+  pDataSetStorage->fastNode = pDataSetStorage->node;
+  pDataSetStorage->values[name].value = "Machine 1";
+  client.m_dataSets.push_back(pDataSetStorage);
+
+  client.Publish();
+  pDataSetStorage->values[name].value = "Machine 2";
+  pDataSetStorage->valuesChanged = true;
+  client.Publish();
+  EXPECT_EQ(pPublisher->Count("m/$delta", "{\"Name\":\"Machine 2\"}"), 1u);
+
+  // Without a change of the values, the new connection gets the full document
+  ++pPublisher->connectGeneration;
+  client.Publish();
+  EXPECT_EQ(pPublisher->Count("m", "{\n  \"Name\": \"Machine 2\"\n}"), 1u);
+  EXPECT_EQ(pPublisher->Count("m/$delta", "{\"Name\":\"Machine 2\"}"), 1u);
+}
+
+TEST(DashboardClient, RepublishLeavesAfterReconnect) {
+  Util::PublishConfig publishConfig;
+  publishConfig.LeafTopics = true;
+  auto pPublisher = std::make_shared<RecordingPublisher>();
+  Client client(publishConfig, pPublisher);
+  auto name = node(ModelOpcUa::Variable, "Name");
+  auto pDataSetStorage = std::make_shared<Client::DataSetStorage_t>();
+  pDataSetStorage->channel = "m";
+  pDataSetStorage->node = node(ModelOpcUa::Object, "Machine", {name});
+  pDataSetStorage->fastNode = pDataSetStorage->node;
+  pDataSetStorage->leaves = client.CollectLeaves(pDataSetStorage->node, "m");
+  pDataSetStorage->values[name].value = "Machine 1";
+  client.m_dataSets.push_back(pDataSetStorage);
+  auto leafMessages = [&pPublisher]() {
+    return std::count_if(pPublisher->messages.begin(), pPublisher->messages.end(), [](const std::pair<std::string, std::string> &message) {
+      return message.first == "m/Name";
+    });
+  };
+
+  client.Publish();
+  pDataSetStorage->valuesChanged = true;
+  client.Publish();
+  EXPECT_EQ(leafMessages(), 1);
+
+  // The value is unchanged, but the retained leaf might be lost with a restarted broker
+  ++pPublisher->connectGeneration;
+  client.Publish();
+  EXPECT_EQ(leafMessages(), 2);
+}
+
+TEST(DashboardClient, RepublishUadpMetaDataAfterReconnect) {
+  auto pPublisher = std::make_shared<RecordingPublisher>();
+  Util::UadpConfig uadp;
+  uadp.Enabled = true;
+  auto pWriterGroup = std::make_shared<Dashboard::UadpWriterGroup>(uadp, "p");
+  Client client(Util::PublishConfig(), pPublisher, pWriterGroup);
+  auto name = node(ModelOpcUa::Variable, "Name");
+  auto pDataSetStorage = std::make_shared<Client::DataSetStorage_t>();
+  pDataSetStorage->channel = "m";
+  pDataSetStorage->node = node(ModelOpcUa::Object, "Machine", {name});
+  pDataSetStorage->fastNode = pDataSetStorage->node;
+  pDataSetStorage->values[name].value = "Machine 1";
+  pDataSetStorage->uadpWriter = "m";
+  pDataSetStorage->uadpWriterId = pWriterGroup->AllocateDataSetWriterId();
+  pDataSetStorage->uadpFields.push_back({name, nullptr});
+  pDataSetStorage->uadpMetaData.fields.resize(1);
+  client.m_dataSets.push_back(pDataSetStorage);
+
+  const auto metaDataTopic = pWriterGroup->MetaDataTopic("m");
+  auto countTopic = [&pPublisher](const std::string &topic) {
+    return std::count_if(
+      pPublisher->messages.begin(), pPublisher->messages.end(), [&topic](const std::pair<std::string, std::string> &message) { return message.first == topic; });
+  };
+  client.Publish();
+  client.Publish();
+  EXPECT_EQ(countTopic(metaDataTopic), 1);
+  auto version = pDataSetStorage->uadpMetaData.configurationVersion;
+
+  ++pPublisher->connectGeneration;
+  client.Publish();
+  EXPECT_EQ(countTopic(metaDataTopic), 2);
+  EXPECT_EQ(pDataSetStorage->uadpMetaData.configurationVersion.major, version.major);
+  EXPECT_EQ(pDataSetStorage->uadpMetaData.configurationVersion.minor, version.minor);
+
+  // The next DataSetMessage is a key frame, which resets the count of delta frames
+  pDataSetStorage->values[name].value = "Machine 2";
+  pDataSetStorage->valuesChanged = true;
+  client.Publish();
+  EXPECT_EQ(pDataSetStorage->uadpDeltaFrames, 0u);
+  EXPECT_EQ(countTopic(metaDataTopic), 2);
+}
+
+TEST(DashboardClient, RateGroupPrunesOnlyTheAncestors) {
+  auto speed = node(ModelOpcUa::Variable, "Speed");
+  auto identification = node(ModelOpcUa::Object, "Identification", {node(ModelOpcUa::Variable, "SerialNumber")});
+  auto spindle = node(ModelOpcUa::Object, "Spindle", {speed, node(ModelOpcUa::Variable, "Override")});
+  auto machine = node(ModelOpcUa::Object, "Machine", {identification, node(ModelOpcUa::Object, "Monitoring", {spindle})});
+
+  Util::PublishConfig publishConfig;
+  publishConfig.RateGroups.push_back(rateGroup("speed", "Monitoring/Spindle/Speed", false));
+  Client client(publishConfig);
+  auto pDataSetStorage = std::make_shared<Client::DataSetStorage_t>();
+  pDataSetStorage->channel = "m";
+  pDataSetStorage->node = machine;
+  client.setupRateGroups(pDataSetStorage, "MachineTool");
+  // The group keeps its configuration when the one of the client changes
+  client.m_publishConfig.RateGroups.clear();
+
+  ASSERT_EQ(pDataSetStorage->rateGroups.size(), 1u);
+  EXPECT_EQ(pDataSetStorage->rateGroups[0].config.Name, "speed");
+  EXPECT_EQ(pDataSetStorage->rateGroups[0].channel, "m/$group/speed");
+  ASSERT_EQ(pDataSetStorage->rateGroups[0].nodes.size(), 1u);
+  EXPECT_EQ(pDataSetStorage->rateGroups[0].nodes[0].node, speed);
+  EXPECT_EQ(pDataSetStorage->rateGroups[0].nodes[0].path, (std::vector<std::string>{"Monitoring", "Spindle", "Speed"}));
+
+  auto fastNode = pDataSetStorage->fastNode;
+  EXPECT_NE(fastNode, machine);
+  EXPECT_EQ(child(fastNode, "Identification"), identification);
+  auto prunedSpindle = child(child(fastNode, "Monitoring"), "Spindle");
+  EXPECT_NE(prunedSpindle, spindle);
+  EXPECT_EQ(child(prunedSpindle, "Speed"), nullptr);
+  EXPECT_NE(child(prunedSpindle, "Override"), nullptr);
+  // Machine, Monitoring and Spindle are copied, each mapped to its original
+  EXPECT_EQ(pDataSetStorage->prunedCopies.size(), 3u);
+  EXPECT_EQ(pDataSetStorage->prunedCopies.at(prunedSpindle), spindle);
+}
+
+TEST(DashboardClient, MergedGroupBelowBaseDataVariable) {
+  auto range = node(ModelOpcUa::Variable, "EURange");
+  auto speed = baseDataVariable("Speed", {range});
+  auto machine = node(ModelOpcUa::Object, "Machine", {speed});
+
+  Util::PublishConfig publishConfig;
+  publishConfig.RateGroups.push_back(rateGroup("range", "Speed/EURange", true));
+  auto pPublisher = std::make_shared<RecordingPublisher>();
+  Client client(publishConfig, pPublisher);
+  auto pDataSetStorage = std::make_shared<Client::DataSetStorage_t>();
+  pDataSetStorage->channel = "m";
+  pDataSetStorage->onlineChannel = "m/online";
+  pDataSetStorage->node = machine;
+  pDataSetStorage->values[speed].value = 5;
+  pDataSetStorage->values[range].value = nlohmann::json{{"low", 0}, {"high", 100}};
+  client.setupRateGroups(pDataSetStorage, "MachineTool");
+  ASSERT_EQ(pDataSetStorage->rateGroups[0].nodes[0].path, (std::vector<std::string>{"Speed", "properties", "EURange"}));
+
+  // The copy of Speed has no children left, its value is found through the original
+  auto prunedSpeed = child(pDataSetStorage->fastNode, "Speed");
+  ASSERT_NE(prunedSpeed, speed);
+  {
+    std::lock_guard<std::mutex> l(pDataSetStorage->values_mutex);
+    EXPECT_EQ(client.findValue(pDataSetStorage, prunedSpeed), &pDataSetStorage->values[speed]);
+  }
+  EXPECT_EQ(client.getJson(pDataSetStorage, pDataSetStorage->fastNode), (nlohmann::json{{"Speed", 5}}));
+
+  client.m_dataSets.push_back(pDataSetStorage);
+  client.Publish();
+  ASSERT_FALSE(pPublisher->messages.empty());
+  EXPECT_EQ(pPublisher->messages[0].first, "m");
+  // The merged document equals the one without rate groups, the value of Speed is kept
+  EXPECT_EQ(nlohmann::json::parse(pPublisher->messages[0].second), client.getJson(pDataSetStorage, machine));
+  EXPECT_EQ(nlohmann::json::parse(pPublisher->messages[0].second)["Speed"]["value"], 5);
+}
+}  // namespace Tests
+}  // namespace Umati
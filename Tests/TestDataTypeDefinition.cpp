@@ -0,0 +1,123 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <TypeDictionary/DataTypeDefinition.hpp>
+
+namespace Umati {
+namespace Tests {
+namespace {
+const std::string Ns0 = "http://opcfoundation.org/UA/";
+const std::string Uri = "http://example.com/UA/";
+const std::string OtherUri = "http://example.com/Other/";
+
+ModelOpcUa::BrowseResult_t dataType(const std::string &uri, const std::string &id, const std::string &name) {
+  return ModelOpcUa::BrowseResult_t{ModelOpcUa::DataType, ModelOpcUa::NodeId_t{uri, id}, {}, {}, ModelOpcUa::QualifiedName_t{uri, name}};
+}
+
+/// Server with the structures PartType and ToolType and the enumeration ModeEnum of another namespace
+TypeDictionary::DataTypeDefinitionConverter converter() {
+  std::map<ModelOpcUa::NodeId_t, ModelOpcUa::BrowseResult_t> customTypes;
+  for (const auto &type : {dataType(Uri, "i=1", "PartType"), dataType(Uri, "i=2", "ToolType"), dataType(OtherUri, "i=1", "ModeEnum")}) {
+    customTypes.emplace(type.NodeId, type);
+  }
+  return TypeDictionary::DataTypeDefinitionConverter(
+    customTypes, {ModelOpcUa::NodeId_t{OtherUri, "i=1"}}, [](const ModelOpcUa::NodeId_t &nodeId) {
+      return nodeId.Id == "i=6" ? std::string("opc:Int32") : nodeId.Id == "i=12" ? std::string("opc:String") : std::string();
+    });
+}
+
+TypeDictionary::StructureDefinition_t structure(std::vector<TypeDictionary::StructureFieldDefinition_t> fields) {
+  TypeDictionary::StructureDefinition_t ret;
+  ret.BaseDataType = ModelOpcUa::NodeId_t{Ns0, "i=22"};
+  ret.DefaultEncodingId = ModelOpcUa::NodeId_t{Uri, "i=100"};
+  ret.Fields = std::move(fields);
+  return ret;
+}
+}  // namespace
+
+TEST(DataTypeDefinition, ConvertsStructureDefinition) {
+  auto definitions = converter();
+  auto definition = structure({
+    {"Name", ModelOpcUa::NodeId_t{Ns0, "i=12"}, -1, false},
+    {"Counts", ModelOpcUa::NodeId_t{Ns0, "i=6"}, 1, false},
+    {"Value", ModelOpcUa::NodeId_t{Ns0, "i=24"}, -1, false},
+    {"Tool", ModelOpcUa::NodeId_t{Uri, "i=2"}, -1, false},
+    {"Mode", ModelOpcUa::NodeId_t{OtherUri, "i=1"}, -1, false},
+  });
+  ASSERT_TRUE(definitions.AddStructuredType(dataType(Uri, "i=1", "PartType"), definition));
+
+  auto dictionaries = definitions.TakeDictionaries();
+  ASSERT_EQ(dictionaries.size(), 1u);
+  EXPECT_EQ(dictionaries.front().TargetNamespace, Uri);
+  ASSERT_EQ(dictionaries.front().StructuredTypes.size(), 1u);
+  const auto &partType = dictionaries.front().StructuredTypes.front();
+  EXPECT_EQ(partType.Name, "PartType");
+  EXPECT_EQ(partType.NodeId, (ModelOpcUa::NodeId_t{Uri, "i=1"}));
+  EXPECT_EQ(partType.BinaryNodeId, (ModelOpcUa::NodeId_t{Uri, "i=100"}));
+  std::vector<std::string> typeNames;
+  for (const auto &field : partType.Fields) {
+    typeNames.push_back(field.TypeName);
+  }
+  EXPECT_EQ(typeNames, (std::vector<std::string>{"opc:String", "opc:Int32", "ua:Variant", "tns:ToolType", "opc:Int32"}));
+  EXPECT_EQ(partType.Fields[1].LengthField, "NoOfCounts");
+  EXPECT_TRUE(partType.Fields[0].LengthField.empty());
+}
+
+TEST(DataTypeDefinition, OptionalFieldsGetSwitchBits) {
+  auto definitions = converter();
+  auto definition = structure({{"Name", ModelOpcUa::NodeId_t{Ns0, "i=12"}, -1, true}, {"Count", ModelOpcUa::NodeId_t{Ns0, "i=6"}, -1, false}});
+  definition.StructureType = TypeDictionary::StructureDefinition_t::StructureType_t::StructureWithOptionalFields;
+  ASSERT_TRUE(definitions.AddStructuredType(dataType(Uri, "i=1", "PartType"), definition));
+
+  auto dictionaries = definitions.TakeDictionaries();
+  ASSERT_EQ(dictionaries.size(), 1u);
+  const auto &fields = dictionaries.front().StructuredTypes.front().Fields;
+  ASSERT_EQ(fields.size(), 3u);
+  EXPECT_EQ(fields[0].TypeName, "opc:Bit");
+  EXPECT_EQ(fields[0].Name, "NameSpecified");
+  EXPECT_EQ(fields[1].SwitchField, "NameSpecified");
+  EXPECT_TRUE(fields[2].SwitchField.empty());
+}
+
+TEST(DataTypeDefinition, SkipsUnionsAndAbstractTypes) {
+  auto definitions = converter();
+  auto unionDefinition = structure({{"Name", ModelOpcUa::NodeId_t{Ns0, "i=12"}, -1, false}});
+  unionDefinition.StructureType = TypeDictionary::StructureDefinition_t::StructureType_t::Union;
+  EXPECT_TRUE(definitions.AddStructuredType(dataType(Uri, "i=1", "PartType"), unionDefinition));
+  auto abstractDefinition = structure({});
+  abstractDefinition.DefaultEncodingId = ModelOpcUa::NodeId_t{};
+  EXPECT_TRUE(definitions.AddStructuredType(dataType(Uri, "i=2", "ToolType"), abstractDefinition));
+  EXPECT_TRUE(definitions.TakeDictionaries().empty());
+}
+
+TEST(DataTypeDefinition, RejectsUnknownFieldTypes) {
+  auto definitions = converter();
+  EXPECT_FALSE(definitions.AddStructuredType(
+    dataType(Uri, "i=1", "PartType"), structure({{"Unknown", ModelOpcUa::NodeId_t{Uri, "i=99"}, -1, false}})));
+  EXPECT_FALSE(definitions.AddStructuredType(
+    dataType(Uri, "i=1", "PartType"), structure({{"Unknown", ModelOpcUa::NodeId_t{Ns0, "i=99"}, -1, false}})));
+  EXPECT_TRUE(definitions.TakeDictionaries().empty());
+}
+
+TEST(DataTypeDefinition, ConvertsEnumDefinition) {
+  auto definitions = converter();
+  definitions.AddEnumeratedType(dataType(OtherUri, "i=1", "ModeEnum"), {{"Manual", 0}, {"Automatic", 1}});
+
+  auto dictionaries = definitions.TakeDictionaries();
+  ASSERT_EQ(dictionaries.size(), 1u);
+  EXPECT_EQ(dictionaries.front().TargetNamespace, OtherUri);
+  ASSERT_EQ(dictionaries.front().EnumeratedTypes.size(), 1u);
+  const auto &modeEnum = dictionaries.front().EnumeratedTypes.front();
+  EXPECT_EQ(modeEnum.LengthInBits, 32u);
+  EXPECT_EQ(modeEnum.NodeId, (ModelOpcUa::NodeId_t{OtherUri, "i=1"}));
+  ASSERT_EQ(modeEnum.EnumeratedValues.size(), 2u);
+  EXPECT_EQ(modeEnum.EnumeratedValues[1].Name, "Automatic");
+  EXPECT_EQ(modeEnum.EnumeratedValues[1].Value, 1);
+}
+}  // namespace Tests
+}  // namespace Umati
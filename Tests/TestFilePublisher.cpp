@@ -0,0 +1,103 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <FilePublisher.hpp>
+#include <cstdio>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+namespace Umati {
+namespace Tests {
+namespace {
+std::string readFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+std::uint64_t readLittleEndian(const std::string &data, std::size_t offset, std::size_t bytes) {
+  std::uint64_t value = 0;
+  for (std::size_t i = 0; i < bytes; ++i) {
+    value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(data[offset + i])) << (8 * i);
+  }
+  return value;
+}
+}  // namespace
+
+TEST(FilePublisher, NdjsonRecords) {
+  Umati::Util::FileSinkConfig config;
+  config.Prefix = "TestFilePublisherNdjson";
+  std::vector<std::string> files;
+  {
+    Umati::Dashboard::FilePublisher publisher(config);
+    Umati::Dashboard::PublishOptions notRetained;
+    notRetained.Retain = false;
+    publisher.Publish("umati/v2/a", "{\"Value\":1}");
+    publisher.Publish("umati/v2/a/$cbor", std::string("\xA1\x00\xFF", 3), notRetained);
+    files = publisher.GetFiles();
+  }
+  ASSERT_EQ(files.size(), 1u);
+  std::stringstream content(readFile(files.front()));
+  std::string line;
+
+  ASSERT_TRUE(std::getline(content, line));
+  auto first = nlohmann::json::parse(line);
+  EXPECT_EQ(first["topic"], "umati/v2/a");
+  EXPECT_EQ(first["retain"], true);
+  EXPECT_EQ(first["payload"], "{\"Value\":1}");
+  EXPECT_TRUE(first.contains("timestamp"));
+
+  ASSERT_TRUE(std::getline(content, line));
+  auto second = nlohmann::json::parse(line);
+  EXPECT_EQ(second["retain"], false);
+  EXPECT_FALSE(second.contains("payload"));
+  EXPECT_EQ(second["payloadBase64"], "oQD/");
+
+  EXPECT_FALSE(std::getline(content, line));
+  std::remove(files.front().c_str());
+}
+
+TEST(FilePublisher, BinaryRotation) {
+  Umati::Util::FileSinkConfig config;
+  config.Prefix = "TestFilePublisherBinary";
+  config.Format = "binary";
+  config.MaxFileSize = 124;
+  config.MaxFiles = 2;
+  config.BufferSize = 16;
+  std::vector<std::string> files;
+  Umati::Dashboard::FilePublisher::Statistics_t statistics;
+  {
+    Umati::Dashboard::FilePublisher publisher(config);
+    // Each record has 17 bytes of header, 1 byte topic and 40 bytes payload, so two fit into a file after the magic
+    for (int i = 0; i < 10; ++i) {
+      publisher.Publish(std::to_string(i), std::string(40, 'x'));
+    }
+    files = publisher.GetFiles();
+    statistics = publisher.GetStatistics();
+  }
+  EXPECT_EQ(statistics.records, 10u);
+  EXPECT_EQ(statistics.files, 5u);
+  ASSERT_EQ(files.size(), 2u);
+
+  auto content = readFile(files.back());
+  ASSERT_EQ(content.size(), 8u + 2 * 58u);
+  EXPECT_EQ(content.substr(0, 8), "UMATIREC");
+  EXPECT_EQ(static_cast<std::uint8_t>(content[16]), 1u);
+  EXPECT_EQ(readLittleEndian(content, 17, 4), 1u);
+  EXPECT_EQ(readLittleEndian(content, 21, 4), 40u);
+  EXPECT_EQ(content.substr(25, 1), "8");
+  EXPECT_EQ(content.substr(8 + 58 + 17, 1), "9");
+
+  for (const auto &file : files) {
+    std::remove(file.c_str());
+  }
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,34 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <Iso8601.hpp>
+
+namespace Umati {
+namespace Tests {
+namespace {
+std::chrono::system_clock::time_point fromUnixMilliseconds(std::int64_t milliseconds) {
+  return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds(milliseconds)));
+}
+}  // namespace
+
+TEST(Iso8601, Epoch) { EXPECT_EQ(Util::ToIso8601(fromUnixMilliseconds(0)), "1970-01-01T00:00:00.000Z"); }
+
+TEST(Iso8601, MillisecondsArePadded) {
+  // 2023-06-01T12:00:00Z
+  EXPECT_EQ(Util::ToIso8601(fromUnixMilliseconds(1685620800000 + 7)), "2023-06-01T12:00:00.007Z");
+  EXPECT_EQ(Util::ToIso8601(fromUnixMilliseconds(1685620800000 + 123)), "2023-06-01T12:00:00.123Z");
+}
+
+TEST(Iso8601, SubMillisecondsAreTruncated) {
+  auto timePoint = fromUnixMilliseconds(1685620800999) + std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(999));
+  EXPECT_EQ(Util::ToIso8601(timePoint), "2023-06-01T12:00:00.999Z");
+}
+
+TEST(Iso8601, LeapDay) { EXPECT_EQ(Util::ToIso8601(fromUnixMilliseconds(951782400000)), "2000-02-29T00:00:00.000Z"); }
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,36 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <JsonMergePatch.hpp>
+
+namespace Umati {
+namespace Tests {
+TEST(JsonMergePatch, EqualDocuments) {
+  auto doc = nlohmann::json::parse(R"({"Identification": {"SerialNumber": "42"}, "Override": 100})");
+  EXPECT_EQ(Umati::Util::CreateMergePatch(doc, doc), nlohmann::json::object());
+}
+
+TEST(JsonMergePatch, OnlyChangedMembers) {
+  auto source = nlohmann::json::parse(R"({"Identification": {"SerialNumber": "42", "Name": "A"}, "Override": 100, "Tools": [1, 2]})");
+  auto target = nlohmann::json::parse(R"({"Identification": {"SerialNumber": "42", "Name": "B"}, "Override": 100, "Tools": [1]})");
+  auto patch = Umati::Util::CreateMergePatch(source, target);
+  EXPECT_EQ(patch, nlohmann::json::parse(R"({"Identification": {"Name": "B"}, "Tools": [1]})"));
+}
+
+TEST(JsonMergePatch, RemovedAndAddedMembers) {
+  auto source = nlohmann::json::parse(R"({"Spindle": {"Override": 100}, "Removed": {"A": 1}})");
+  auto target = nlohmann::json::parse(R"({"Spindle": {"Override": 100, "Speed": 12.5}, "Added": "x"})");
+  auto patch = Umati::Util::CreateMergePatch(source, target);
+  EXPECT_EQ(patch, nlohmann::json::parse(R"({"Spindle": {"Speed": 12.5}, "Removed": null, "Added": "x"})"));
+
+  auto applied = source;
+  applied.merge_patch(patch);
+  EXPECT_EQ(applied, target);
+}
+}  // namespace Tests
+}  // namespace Umati
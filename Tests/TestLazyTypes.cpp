@@ -0,0 +1,161 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <OpcUaTypeReader.hpp>
+
+#include <algorithm>
+
+namespace Umati {
+namespace Tests {
+namespace {
+const std::string Ns0 = "http://opcfoundation.org/UA/";
+const std::string Uri = "http://example.com/UA/";
+
+/// Address space of a few types, answers the browse requests of the type reader
+class TypeServer : public Dashboard::IDashboardDataClient {
+ public:
+  TypeServer() {
+    addNode(ModelOpcUa::Object, Dashboard::NodeId_ModellingRule_Mandatory, "Mandatory");
+    addNode(ModelOpcUa::ObjectType, Dashboard::NodeId_BaseObjectType, "BaseObjectType");
+    addNode(ModelOpcUa::VariableType, Dashboard::NodeId_BaseVariableType, "BaseDataVariableType");
+    addType("MachineType", Dashboard::NodeId_BaseObjectType);
+    addChild("MachineType", ModelOpcUa::Object, "Identification", ModelOpcUa::NodeId_t{Uri, "s=IdentificationType"});
+    addChild("MachineType", ModelOpcUa::Variable, "Speed", Dashboard::NodeId_BaseVariableType);
+    addType("IdentificationType", Dashboard::NodeId_BaseObjectType);
+    addChild("IdentificationType", ModelOpcUa::Variable, "Manufacturer", Dashboard::NodeId_BaseVariableType);
+    // Sorted before MachineType, with children equal to the ones of MachineType
+    addType("BasicMachineType", Dashboard::NodeId_BaseObjectType);
+    addChild("BasicMachineType", ModelOpcUa::Object, "Identification", ModelOpcUa::NodeId_t{Uri, "s=IdentificationType"});
+    addChild("BasicMachineType", ModelOpcUa::Variable, "Speed", Dashboard::NodeId_BaseVariableType);
+    addType("OtherMachineType", Dashboard::NodeId_BaseObjectType);
+    addChild("OtherMachineType", ModelOpcUa::Variable, "Temperature", Dashboard::NodeId_BaseVariableType);
+  }
+
+  std::list<ModelOpcUa::BrowseResult_t> Browse(ModelOpcUa::NodeId_t startNode, BrowseContext_t browseContext) override {
+    BrowsedNodes.push_back(startNode);
+    std::list<ModelOpcUa::BrowseResult_t> ret;
+    for (const auto &reference : m_references) {
+      bool forward = browseContext.browseDirection == BrowseContext_t::BrowseDirection::FORWARD;
+      if (!((forward ? reference.Source : reference.Target) == startNode)) {
+        continue;
+      }
+      bool hierarchical = !(reference.ReferenceType == Dashboard::NodeId_HasModellingRule);
+      if (!(browseContext.referenceTypeId == reference.ReferenceType ||
+            (browseContext.referenceTypeId == Dashboard::NodeId_HierarchicalReferences && hierarchical))) {
+        continue;
+      }
+      auto result = m_nodes.at(forward ? reference.Target : reference.Source);
+      if (browseContext.nodeClassMask != 0 && (browseContext.nodeClassMask & result.NodeClass) == 0) {
+        continue;
+      }
+      result.ReferenceTypeId = reference.ReferenceType;
+      ret.push_back(result);
+    }
+    return ret;
+  }
+
+  bool isSameOrSubtype(const ModelOpcUa::NodeId_t &, const ModelOpcUa::NodeId_t &, std::size_t) override { return false; }
+  std::list<ModelOpcUa::BrowseResult_t> BrowseWithResultTypeFilter(ModelOpcUa::NodeId_t, BrowseContext_t, ModelOpcUa::NodeId_t) override {
+    return {};
+  }
+  ModelOpcUa::NodeId_t TranslateBrowsePathToNodeId(ModelOpcUa::NodeId_t, ModelOpcUa::QualifiedName_t) override { return {}; }
+  void updateCustomTypes() override {}
+  void readTypeDictionaries() override {}
+  void buildCustomDataTypes() override {}
+  std::string readNodeBrowseName(const ModelOpcUa::NodeId_t &nodeId) override { return nodeId.Uri + ";" + m_nodes.at(nodeId).BrowseName.Name; }
+  std::string getTypeName(const ModelOpcUa::NodeId_t &nodeId) override { return readNodeBrowseName(nodeId); }
+  std::shared_ptr<ValueSubscriptionHandle> Subscribe(ModelOpcUa::NodeId_t, newValueCallbackFunction_t) override { return nullptr; }
+  void Unsubscribe(std::vector<int32_t>, std::vector<int32_t>) override {}
+  std::vector<nlohmann::json> ReadeNodeValues(std::list<ModelOpcUa::NodeId_t>) override { return {}; }
+  std::vector<std::string> Namespaces() override { return {Ns0, Uri}; }
+  bool VerifyConnection() override { return true; }
+
+  std::vector<ModelOpcUa::NodeId_t> BrowsedNodes;
+
+ private:
+  struct Reference_t {
+    ModelOpcUa::NodeId_t Source;
+    ModelOpcUa::NodeId_t ReferenceType;
+    ModelOpcUa::NodeId_t Target;
+  };
+
+  void addNode(ModelOpcUa::NodeClass_t nodeClass, const ModelOpcUa::NodeId_t &nodeId, const std::string &name,
+               const ModelOpcUa::NodeId_t &typeDefinition = ModelOpcUa::NodeId_t{}) {
+    m_nodes[nodeId] = ModelOpcUa::BrowseResult_t{nodeClass, nodeId, typeDefinition, ModelOpcUa::NodeId_t{}, ModelOpcUa::QualifiedName_t{nodeId.Uri, name}};
+  }
+
+  void addType(const std::string &name, const ModelOpcUa::NodeId_t &supertype) {
+    ModelOpcUa::NodeId_t nodeId{Uri, "s=" + name};
+    addNode(ModelOpcUa::ObjectType, nodeId, name);
+    m_references.push_back({supertype, Dashboard::NodeId_HasSubtype, nodeId});
+  }
+
+  void addChild(const std::string &type, ModelOpcUa::NodeClass_t nodeClass, const std::string &name, const ModelOpcUa::NodeId_t &typeDefinition) {
+    ModelOpcUa::NodeId_t nodeId{Uri, "s=" + type + "." + name};
+    addNode(nodeClass, nodeId, name, typeDefinition);
+    m_references.push_back({ModelOpcUa::NodeId_t{Uri, "s=" + type}, Dashboard::NodeId_HasComponent, nodeId});
+    m_references.push_back({nodeId, Dashboard::NodeId_HasModellingRule, Dashboard::NodeId_ModellingRule_Mandatory});
+  }
+
+  std::map<ModelOpcUa::NodeId_t, ModelOpcUa::BrowseResult_t> m_nodes;
+  std::vector<Reference_t> m_references;
+};
+
+bool browsed(const TypeServer &server, const std::string &id) {
+  return std::find(server.BrowsedNodes.begin(), server.BrowsedNodes.end(), ModelOpcUa::NodeId_t{Uri, id}) != server.BrowsedNodes.end();
+}
+}  // namespace
+
+TEST(LazyTypes, ReadsTypesOnFirstUse) {
+  auto server = std::make_shared<TypeServer>();
+  Dashboard::OpcUaTypeReader reader(server, {Uri}, {}, "", {}, true);
+  reader.readTypes();
+  EXPECT_TRUE(reader.m_typeMap->empty());
+  EXPECT_FALSE(browsed(*server, "s=MachineType"));
+
+  auto machineType = reader.typeDefinitionToStructureNode(ModelOpcUa::NodeId_t{Uri, "s=MachineType"});
+  EXPECT_EQ(machineType->SpecifiedBrowseName.Name, "MachineType");
+  ASSERT_EQ(machineType->SpecifiedChildNodes->size(), 2u);
+  // The type of a child is read with the type and the child refers to its children
+  auto identification = machineType->SpecifiedChildNodes->front();
+  EXPECT_EQ(identification->ModellingRule, ModelOpcUa::Mandatory);
+  ASSERT_EQ(reader.m_typeMap->count(ModelOpcUa::NodeId_t{Uri, "s=IdentificationType"}), 1u);
+  EXPECT_EQ(identification->SpecifiedChildNodes, reader.m_typeMap->at(ModelOpcUa::NodeId_t{Uri, "s=IdentificationType"})->SpecifiedChildNodes);
+  EXPECT_EQ(identification->SpecifiedChildNodes->front()->SpecifiedBrowseName.Name, "Manufacturer");
+  EXPECT_EQ(reader.m_nameToId->count(Uri + ";IdentificationType"), 1u);
+
+  EXPECT_EQ(reader.m_typeMap->size(), 2u);
+  EXPECT_FALSE(browsed(*server, "s=OtherMachineType"));
+  EXPECT_EQ(reader.findTypeDefinition(ModelOpcUa::NodeId_t{Uri, "s=Unknown"}), nullptr);
+}
+
+TEST(LazyTypes, ResolvingKeepsTheTypesInUse) {
+  auto server = std::make_shared<TypeServer>();
+  Dashboard::OpcUaTypeReader reader(server, {Uri}, {}, "", {}, true);
+  reader.readTypes();
+  auto machineType = reader.typeDefinitionToStructureNode(ModelOpcUa::NodeId_t{Uri, "s=MachineType"});
+  std::vector<std::shared_ptr<ModelOpcUa::StructureNode>> children(machineType->SpecifiedChildNodes->begin(), machineType->SpecifiedChildNodes->end());
+  auto identificationChildren = children.front()->SpecifiedChildNodes;
+
+  // Like a placeholder in DashboardClient::TransformToNodeIds, a new type is resolved while the children of MachineType are walked
+  std::size_t i = 0;
+  for (const auto &child : *machineType->SpecifiedChildNodes) {
+    if (i == 0) {
+      ASSERT_NE(reader.findTypeDefinition(ModelOpcUa::NodeId_t{Uri, "s=BasicMachineType"}), nullptr);
+    }
+    EXPECT_EQ(child, children[i++]);
+  }
+  EXPECT_EQ(i, 2u);
+  EXPECT_EQ(children.front()->SpecifiedChildNodes, identificationChildren);
+
+  // The equal children of the new type are shared with the existing ones
+  auto basicMachineType = reader.m_typeMap->at(ModelOpcUa::NodeId_t{Uri, "s=BasicMachineType"});
+  EXPECT_EQ(std::vector<std::shared_ptr<ModelOpcUa::StructureNode>>(basicMachineType->SpecifiedChildNodes->begin(), basicMachineType->SpecifiedChildNodes->end()), children);
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,211 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <NodeSetReader.hpp>
+#include <OpcUaTypeReader.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+namespace Umati {
+namespace Tests {
+namespace {
+const std::string Ns0 = "http://opcfoundation.org/UA/";
+const std::string Uri = "http://example.com/UA/";
+const std::string DiUri = "http://opcfoundation.org/UA/DI/";
+const std::string NodeSetFile = "TestNodeSetReader.xml";
+
+/// MachineType with a mandatory component Speed and an optional property Name, which is only referenced from the property
+void writeNodeSet() {
+  std::ofstream file(NodeSetFile);
+  file << R"(<?xml version="1.0" encoding="utf-8"?>
+<UANodeSet xmlns="http://opcfoundation.org/UA/2011/03/UANodeSet.xsd">
+  <NamespaceUris><Uri>http://example.com/UA/</Uri></NamespaceUris>
+  <Models><Model ModelUri="http://example.com/UA/" Version="1.01.0" PublicationDate="2023-01-01T00:00:00Z" /></Models>
+  <Aliases>
+    <Alias Alias="HasComponent">i=47</Alias>
+    <Alias Alias="HasProperty">i=46</Alias>
+    <Alias Alias="HasSubtype">i=45</Alias>
+    <Alias Alias="HasTypeDefinition">i=40</Alias>
+    <Alias Alias="HasModellingRule">i=37</Alias>
+  </Aliases>
+  <UAObjectType NodeId="ns=1;i=1" BrowseName="1:MachineType">
+    <References>
+      <Reference ReferenceType="HasSubtype" IsForward="false">i=58</Reference>
+      <Reference ReferenceType="HasComponent">ns=1;i=2</Reference>
+    </References>
+  </UAObjectType>
+  <UAVariable NodeId="ns=1;i=2" BrowseName="1:Speed" ParentNodeId="ns=1;i=1">
+    <References>
+      <Reference ReferenceType="HasTypeDefinition">i=63</Reference>
+      <Reference ReferenceType="HasModellingRule">i=78</Reference>
+      <Reference ReferenceType="HasComponent" IsForward="false">ns=1;i=1</Reference>
+    </References>
+  </UAVariable>
+  <UAVariable NodeId="ns=1;i=3" BrowseName="Name" ParentNodeId="ns=1;i=1">
+    <References>
+      <Reference ReferenceType="HasTypeDefinition">i=68</Reference>
+      <Reference ReferenceType="HasModellingRule">i=80</Reference>
+      <Reference ReferenceType="HasProperty" IsForward="false">ns=1;i=1</Reference>
+    </References>
+  </UAVariable>
+  <UAMethod NodeId="ns=1;i=4" BrowseName="1:Start">
+    <References><Reference ReferenceType="HasComponent" IsForward="false">ns=1;i=1</Reference></References>
+  </UAMethod>
+</UANodeSet>
+)";
+}
+
+void writeFile(const std::string &path, const std::string &content) {
+  std::ofstream file(path);
+  file << content;
+}
+
+/// Address space with DeviceType of DI in version 1.04.0 and MachineType as its subtype, answers the browse requests of the type reader
+class DeviceServer : public Dashboard::IDashboardDataClient {
+ public:
+  DeviceServer() {
+    const ModelOpcUa::NodeId_t namespaceObject{Uri, "s=Namespaces.DI"};
+    const ModelOpcUa::NodeId_t namespaceVersion{Uri, "s=Namespaces.DI.NamespaceVersion"};
+    add(Dashboard::NodeId_Server_Namespaces, Dashboard::NodeId_HasComponent, {ModelOpcUa::Object, namespaceObject, {}, {}, {Ns0, DiUri}});
+    add(namespaceObject, Dashboard::NodeId_HasProperty, {ModelOpcUa::Variable, namespaceVersion, {}, {}, {Ns0, "NamespaceVersion"}});
+    add(Dashboard::NodeId_BaseObjectType, Dashboard::NodeId_HasSubtype, {ModelOpcUa::ObjectType, {DiUri, "i=1001"}, {}, {}, {DiUri, "DeviceType"}});
+    add({DiUri, "i=1001"}, Dashboard::NodeId_HasSubtype, {ModelOpcUa::ObjectType, {Uri, "i=1"}, {}, {}, {Uri, "MachineType"}});
+  }
+
+  std::list<ModelOpcUa::BrowseResult_t> Browse(ModelOpcUa::NodeId_t startNode, BrowseContext_t browseContext) override {
+    std::list<ModelOpcUa::BrowseResult_t> ret;
+    auto references = m_references.find(startNode);
+    if (references == m_references.end() || browseContext.browseDirection != BrowseContext_t::BrowseDirection::FORWARD) {
+      return ret;
+    }
+    for (auto result : references->second) {
+      if ((browseContext.referenceTypeId == result.ReferenceTypeId || browseContext.referenceTypeId == Dashboard::NodeId_HierarchicalReferences) &&
+          (browseContext.nodeClassMask == 0 || (browseContext.nodeClassMask & result.NodeClass) != 0)) {
+        ret.push_back(result);
+      }
+    }
+    return ret;
+  }
+
+  bool isSameOrSubtype(const ModelOpcUa::NodeId_t &, const ModelOpcUa::NodeId_t &, std::size_t) override { return false; }
+  std::list<ModelOpcUa::BrowseResult_t> BrowseWithResultTypeFilter(ModelOpcUa::NodeId_t, BrowseContext_t, ModelOpcUa::NodeId_t) override {
+    return {};
+  }
+  ModelOpcUa::NodeId_t TranslateBrowsePathToNodeId(ModelOpcUa::NodeId_t, ModelOpcUa::QualifiedName_t) override { return {}; }
+  void updateCustomTypes() override {}
+  void readTypeDictionaries() override {}
+  void buildCustomDataTypes() override {}
+  std::string readNodeBrowseName(const ModelOpcUa::NodeId_t &nodeId) override { return static_cast<std::string>(nodeId); }
+  std::string getTypeName(const ModelOpcUa::NodeId_t &nodeId) override { return readNodeBrowseName(nodeId); }
+  std::shared_ptr<ValueSubscriptionHandle> Subscribe(ModelOpcUa::NodeId_t, newValueCallbackFunction_t) override { return nullptr; }
+  void Unsubscribe(std::vector<int32_t>, std::vector<int32_t>) override {}
+  std::vector<nlohmann::json> ReadeNodeValues(std::list<ModelOpcUa::NodeId_t> nodeIds) override {
+    return std::vector<nlohmann::json>(nodeIds.size(), "1.04.0");
+  }
+  std::vector<std::string> Namespaces() override { return {Ns0, Uri, DiUri}; }
+  bool VerifyConnection() override { return true; }
+
+ private:
+  void add(const ModelOpcUa::NodeId_t &source, const ModelOpcUa::NodeId_t &referenceType, ModelOpcUa::BrowseResult_t target) {
+    target.ReferenceTypeId = referenceType;
+    m_references[source].push_back(target);
+  }
+
+  std::map<ModelOpcUa::NodeId_t, std::list<ModelOpcUa::BrowseResult_t>> m_references;
+};
+}  // namespace
+
+TEST(NodeSetReader, BrowsesTypesAndChildren) {
+  writeNodeSet();
+  Umati::Dashboard::NodeSetReader reader;
+  reader.Load(NodeSetFile);
+  std::remove(NodeSetFile.c_str());
+
+  ASSERT_EQ(reader.Models().size(), 1u);
+  EXPECT_EQ(reader.Models().front().Version, "1.01.0");
+  EXPECT_TRUE(reader.IsType(ModelOpcUa::NodeId_t{Uri, "i=1"}));
+  EXPECT_FALSE(reader.Contains(ModelOpcUa::NodeId_t{Uri, "i=4"}));
+
+  auto subtypes = reader.Browse(ModelOpcUa::NodeId_t{Ns0, "i=58"}, ModelOpcUa::NodeId_t{Ns0, "i=45"}, ModelOpcUa::ObjectType);
+  ASSERT_EQ(subtypes.size(), 1u);
+  EXPECT_EQ(subtypes.front().BrowseName, (ModelOpcUa::QualifiedName_t{Uri, "MachineType"}));
+
+  auto children = reader.Browse(ModelOpcUa::NodeId_t{Uri, "i=1"}, ModelOpcUa::NodeId_t{Ns0, "i=33"}, 0);
+  ASSERT_EQ(children.size(), 2u);
+  EXPECT_EQ(children.front().NodeId, (ModelOpcUa::NodeId_t{Uri, "i=2"}));
+  EXPECT_EQ(children.front().NodeClass, ModelOpcUa::Variable);
+  EXPECT_EQ(children.front().TypeDefinition, (ModelOpcUa::NodeId_t{Ns0, "i=63"}));
+  EXPECT_EQ(children.front().ReferenceTypeId, (ModelOpcUa::NodeId_t{Ns0, "i=47"}));
+  EXPECT_EQ(children.back().BrowseName, (ModelOpcUa::QualifiedName_t{Ns0, "Name"}));
+  EXPECT_EQ(reader.ModellingRule(ModelOpcUa::NodeId_t{Uri, "i=2"}), ModelOpcUa::Mandatory);
+  EXPECT_EQ(reader.ModellingRule(ModelOpcUa::NodeId_t{Uri, "i=3"}), ModelOpcUa::Optional);
+  EXPECT_EQ(reader.Browse(ModelOpcUa::NodeId_t{Uri, "i=1"}, ModelOpcUa::NodeId_t{Ns0, "i=46"}, 0).size(), 1u);
+
+  reader.RemoveNamespace(Uri);
+  EXPECT_FALSE(reader.Contains(ModelOpcUa::NodeId_t{Uri, "i=1"}));
+  EXPECT_TRUE(reader.Models().empty());
+  EXPECT_TRUE(reader.Browse(ModelOpcUa::NodeId_t{Ns0, "i=58"}, ModelOpcUa::NodeId_t{Ns0, "i=45"}, 0).empty());
+}
+
+TEST(NodeSetReader, BrowsesSubtypesOfDroppedNamespacesOnTheServer) {
+  // BaseObjectType is read from the file of namespace 0, DeviceType only from the server as the DI file has another version
+  writeFile("TestNodeSetReader.Ns0.xml", R"(<?xml version="1.0" encoding="utf-8"?>
+<UANodeSet xmlns="http://opcfoundation.org/UA/2011/03/UANodeSet.xsd">
+  <Models><Model ModelUri="http://opcfoundation.org/UA/" Version="1.05.02" /></Models>
+  <UAObjectType NodeId="i=58" BrowseName="BaseObjectType" />
+</UANodeSet>
+)");
+  writeFile("TestNodeSetReader.Di.xml", R"(<?xml version="1.0" encoding="utf-8"?>
+<UANodeSet xmlns="http://opcfoundation.org/UA/2011/03/UANodeSet.xsd">
+  <NamespaceUris><Uri>http://opcfoundation.org/UA/DI/</Uri></NamespaceUris>
+  <Models><Model ModelUri="http://opcfoundation.org/UA/DI/" Version="1.03.0" /></Models>
+  <UAObjectType NodeId="ns=1;i=1001" BrowseName="1:DeviceType">
+    <References><Reference ReferenceType="HasSubtype" IsForward="false">i=58</Reference></References>
+  </UAObjectType>
+</UANodeSet>
+)");
+  writeFile("TestNodeSetReader.Machine.xml", R"(<?xml version="1.0" encoding="utf-8"?>
+<UANodeSet xmlns="http://opcfoundation.org/UA/2011/03/UANodeSet.xsd">
+  <NamespaceUris><Uri>http://opcfoundation.org/UA/DI/</Uri><Uri>http://example.com/UA/</Uri></NamespaceUris>
+  <Models><Model ModelUri="http://example.com/UA/" Version="1.00.0" /></Models>
+  <UAObjectType NodeId="ns=2;i=1" BrowseName="2:MachineType">
+    <References>
+      <Reference ReferenceType="HasSubtype" IsForward="false">ns=1;i=1001</Reference>
+      <Reference ReferenceType="HasComponent">ns=2;i=2</Reference>
+    </References>
+  </UAObjectType>
+  <UAVariable NodeId="ns=2;i=2" BrowseName="2:Speed" ParentNodeId="ns=2;i=1">
+    <References>
+      <Reference ReferenceType="HasTypeDefinition">i=63</Reference>
+      <Reference ReferenceType="HasModellingRule">i=78</Reference>
+    </References>
+  </UAVariable>
+</UANodeSet>
+)");
+  Dashboard::OpcUaTypeReader reader(std::make_shared<DeviceServer>(), {Uri}, {}, "",
+                                    {"TestNodeSetReader.Ns0.xml", "TestNodeSetReader.Di.xml", "TestNodeSetReader.Machine.xml"});
+  reader.readTypes();
+  std::remove("TestNodeSetReader.Ns0.xml");
+  std::remove("TestNodeSetReader.Di.xml");
+  std::remove("TestNodeSetReader.Machine.xml");
+
+  ASSERT_EQ(reader.m_typeMap->count(ModelOpcUa::NodeId_t{Uri, "i=1"}), 1u);
+  auto machineType = reader.m_typeMap->at(ModelOpcUa::NodeId_t{Uri, "i=1"});
+  ASSERT_EQ(machineType->SpecifiedChildNodes->size(), 1u);
+  EXPECT_EQ(machineType->SpecifiedChildNodes->front()->SpecifiedBrowseName.Name, "Speed");
+  EXPECT_EQ(machineType->SpecifiedChildNodes->front()->ModellingRule, ModelOpcUa::Mandatory);
+}
+
+TEST(NodeSetReader, RejectsOtherFiles) {
+  Umati::Dashboard::NodeSetReader reader;
+  EXPECT_THROW(reader.Load("missing.xml"), std::runtime_error);
+}
+}  // namespace Tests
+}  // namespace Umati
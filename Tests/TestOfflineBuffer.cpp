@@ -0,0 +1,118 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <OfflineBuffer.hpp>
+#include <cstdio>
+#include <vector>
+
+namespace Umati {
+namespace Tests {
+namespace {
+const char *BufferFile = "TestOfflineBuffer.bin";
+
+std::vector<std::string> Drain(Umati::Dashboard::OfflineBuffer &buffer) {
+  std::vector<std::string> messages;
+  Umati::Dashboard::OfflineBuffer::Record_t record;
+  while (buffer.Peek(record)) {
+    messages.push_back(record.channel + "=" + record.message);
+    buffer.Pop(record.sequence);
+  }
+  return messages;
+}
+}  // namespace
+
+TEST(OfflineBuffer, LatestPerChannel) {
+  std::remove(BufferFile);
+  Umati::Dashboard::OfflineBuffer buffer(BufferFile, 4096, false);
+  EXPECT_TRUE(buffer.Append("a", "1", true));
+  EXPECT_TRUE(buffer.Append("b", "1", true));
+  EXPECT_FALSE(buffer.Append("a/$delta", "x", false));
+  EXPECT_TRUE(buffer.Append("a", "2", true));
+
+  EXPECT_EQ(Drain(buffer), (std::vector<std::string>{"b=1", "a=2"}));
+  EXPECT_TRUE(buffer.Empty());
+  std::remove(BufferFile);
+}
+
+TEST(OfflineBuffer, KeepsOptions) {
+  std::remove(BufferFile);
+  {
+    Umati::Dashboard::OfflineBuffer buffer(BufferFile, 4096, true);
+    Umati::Dashboard::PublishOptions options;
+    options.Retain = false;
+    options.ContentType = "application/zstd";
+    options.TopicClass = "delta";
+    options.UserProperties = {{"Specification", "MachineTool"}, {"ContentEncoding", "zstd"}};
+    buffer.Append("a/$delta/$zstd/0", std::string("\x28\xB5\x2F\xFD", 4), options);
+    buffer.Append("b", "1", true);
+  }
+
+  // Restored after a restart
+  Umati::Dashboard::OfflineBuffer buffer(BufferFile, 4096, true);
+  Umati::Dashboard::OfflineBuffer::Record_t record;
+  ASSERT_TRUE(buffer.Peek(record));
+  EXPECT_EQ(record.message, std::string("\x28\xB5\x2F\xFD", 4));
+  EXPECT_FALSE(record.options.Retain);
+  EXPECT_EQ(record.options.ContentType, "application/zstd");
+  EXPECT_EQ(
+    record.options.UserProperties,
+    (std::vector<std::pair<std::string, std::string>>{{"Specification", "MachineTool"}, {"ContentEncoding", "zstd"}}));
+  buffer.Pop(record.sequence);
+
+  ASSERT_TRUE(buffer.Peek(record));
+  EXPECT_EQ(record.message, "1");
+  EXPECT_TRUE(record.options.Retain);
+  EXPECT_TRUE(record.options.ContentType.empty());
+  EXPECT_TRUE(record.options.UserProperties.empty());
+  std::remove(BufferFile);
+}
+
+TEST(OfflineBuffer, HistoryKeepsOrder) {
+  std::remove(BufferFile);
+  Umati::Dashboard::OfflineBuffer buffer(BufferFile, 4096, true);
+  buffer.Append("a", "1", true);
+  buffer.Append("a/$delta", "x", false);
+  buffer.Append("a", "2", true);
+
+  EXPECT_EQ(Drain(buffer), (std::vector<std::string>{"a=1", "a/$delta=x", "a=2"}));
+  std::remove(BufferFile);
+}
+
+TEST(OfflineBuffer, OverwritesOldestWhenFull) {
+  std::remove(BufferFile);
+  Umati::Dashboard::OfflineBuffer buffer(BufferFile, 4096, true);
+  const std::string payload(1000, 'x');
+  for (int i = 0; i < 10; ++i) {
+    buffer.Append(std::to_string(i), payload, true);
+  }
+  auto statistics = buffer.GetStatistics();
+  EXPECT_EQ(statistics.stored, 10u);
+  EXPECT_EQ(statistics.records + statistics.dropped, 10u);
+  EXPECT_LE(statistics.usedBytes, 4096u);
+
+  auto messages = Drain(buffer);
+  ASSERT_EQ(messages.size(), statistics.records);
+  EXPECT_EQ(messages.back(), "9=" + payload);
+  std::remove(BufferFile);
+}
+
+TEST(OfflineBuffer, SurvivesReopen) {
+  std::remove(BufferFile);
+  {
+    Umati::Dashboard::OfflineBuffer buffer(BufferFile, 4096, false);
+    buffer.Append("a", "1", true);
+    buffer.Append("b", "1", true);
+    buffer.Append("a", "2", true);
+  }
+  Umati::Dashboard::OfflineBuffer buffer(BufferFile, 4096, false);
+  buffer.Append("b", "2", true);
+  EXPECT_EQ(Drain(buffer), (std::vector<std::string>{"a=2", "b=2"}));
+  std::remove(BufferFile);
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,98 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <PayloadCompressor.hpp>
+#include <zstd.h>
+#include <cstdio>
+#include <nlohmann/json.hpp>
+
+namespace Umati {
+namespace Tests {
+namespace {
+std::string MachineDocument(int i) {
+  nlohmann::json doc;
+  doc["Identification"]["SerialNumber"] = std::to_string(i);
+  for (int tool = 0; tool < 200; ++tool) {
+    doc["ToolList"]["Tool" + std::to_string(tool)] = {{"Name", "Drill " + std::to_string(tool + i)}, {"Length", tool * 0.5 + i}, {"Locked", tool % 2 == 0}};
+  }
+  return doc.dump(2);
+}
+
+Umati::Util::CompressionConfig TestConfig() {
+  Umati::Util::CompressionConfig config;
+  config.Enabled = true;
+  config.Threshold = 1024;
+  config.DictionarySamples = 0;
+  return config;
+}
+}  // namespace
+
+TEST(PayloadCompressor, BelowThreshold) {
+  Umati::Util::PayloadCompressor compressor(TestConfig());
+  std::string payload("1");
+  EXPECT_FALSE(compressor.Compress("MachineTool", payload));
+  EXPECT_EQ(payload, "1");
+}
+
+TEST(PayloadCompressor, RoundTrip) {
+  Umati::Util::PayloadCompressor compressor(TestConfig());
+  auto original = MachineDocument(1);
+  auto payload = original;
+  std::uint32_t dictionaryId = 42;
+  ASSERT_TRUE(compressor.Compress("MachineTool", payload, &dictionaryId));
+  EXPECT_LT(payload.size(), original.size());
+  EXPECT_EQ(dictionaryId, 0u);
+
+  std::string decompressed(ZSTD_getFrameContentSize(payload.data(), payload.size()), '\0');
+  auto size = ZSTD_decompress(&decompressed[0], decompressed.size(), payload.data(), payload.size());
+  ASSERT_FALSE(ZSTD_isError(size));
+  EXPECT_EQ(decompressed, original);
+}
+
+TEST(PayloadCompressor, TrainedDictionary) {
+  auto config = TestConfig();
+  config.DictionarySamples = 30;
+  config.DictionarySize = 16384;
+  std::remove((config.DictionaryDirectory + "/MachineTool.zdict").c_str());
+
+  std::uint32_t dictionaryId = 0;
+  std::string dictionary;
+  {
+    Umati::Util::PayloadCompressor compressor(config, [&](std::uint32_t id, const std::string &content) {
+      dictionaryId = id;
+      dictionary = content;
+    });
+    for (int i = 0; i < 30; ++i) {
+      auto payload = MachineDocument(i);
+      compressor.Compress("MachineTool", payload);
+    }
+    compressor.WaitForTraining();
+  }
+  ASSERT_NE(dictionaryId, 0u);
+
+  // A new instance loads the stored dictionary
+  std::uint32_t loadedId = 0;
+  Umati::Util::PayloadCompressor compressor(config, [&](std::uint32_t id, const std::string &) { loadedId = id; });
+  auto original = MachineDocument(42);
+  auto payload = original;
+  std::uint32_t usedId = 0;
+  ASSERT_TRUE(compressor.Compress("MachineTool", payload, &usedId));
+  EXPECT_EQ(loadedId, dictionaryId);
+  EXPECT_EQ(usedId, dictionaryId);
+  EXPECT_EQ(ZSTD_getDictID_fromFrame(payload.data(), payload.size()), dictionaryId);
+
+  auto dctx = ZSTD_createDCtx();
+  std::string decompressed(original.size(), '\0');
+  auto size = ZSTD_decompress_usingDict(dctx, &decompressed[0], decompressed.size(), payload.data(), payload.size(), dictionary.data(), dictionary.size());
+  ZSTD_freeDCtx(dctx);
+  ASSERT_FALSE(ZSTD_isError(size));
+  EXPECT_EQ(decompressed, original);
+  std::remove((config.DictionaryDirectory + "/MachineTool.zdict").c_str());
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,37 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <PayloadEncoding.hpp>
+#include <Exceptions/ConfigurationException.hpp>
+
+namespace Umati {
+namespace Tests {
+TEST(PayloadEncoding, FromString) {
+  EXPECT_EQ(Umati::Util::PayloadEncodingFromString("json"), Umati::Util::PayloadEncoding_t::Json);
+  EXPECT_EQ(Umati::Util::PayloadEncodingFromString("cbor"), Umati::Util::PayloadEncoding_t::Cbor);
+  EXPECT_EQ(Umati::Util::PayloadEncodingFromString("msgpack"), Umati::Util::PayloadEncoding_t::MessagePack);
+  EXPECT_THROW(Umati::Util::PayloadEncodingFromString("xml"), Umati::Util::Exception::ConfigurationException);
+}
+
+TEST(PayloadEncoding, RoundTrip) {
+  auto doc = nlohmann::json::parse(R"({"Identification": {"SerialNumber": "42"}, "Override": 100.5, "Tools": [1, 2]})");
+  auto cbor = Umati::Util::EncodePayload(doc, Umati::Util::PayloadEncoding_t::Cbor);
+  EXPECT_EQ(nlohmann::json::from_cbor(cbor), doc);
+  auto msgpack = Umati::Util::EncodePayload(doc, Umati::Util::PayloadEncoding_t::MessagePack);
+  EXPECT_EQ(nlohmann::json::from_msgpack(msgpack), doc);
+  EXPECT_LT(cbor.size(), doc.dump().size());
+  EXPECT_EQ(Umati::Util::EncodePayload(doc, Umati::Util::PayloadEncoding_t::Json), doc.dump());
+}
+
+TEST(PayloadEncoding, TopicSuffix) {
+  EXPECT_EQ(Umati::Util::PayloadEncodingTopicSuffix(Umati::Util::PayloadEncoding_t::Json), "");
+  EXPECT_EQ(Umati::Util::PayloadEncodingTopicSuffix(Umati::Util::PayloadEncoding_t::Cbor), "/$cbor");
+  EXPECT_EQ(Umati::Util::PayloadEncodingTopicSuffix(Umati::Util::PayloadEncoding_t::MessagePack), "/$msgpack");
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,148 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <PublishQueue.hpp>
+#include <thread>
+
+namespace Umati {
+namespace Tests {
+TEST(PublishQueue, RetainedMessagesAreCoalesced) {
+  Umati::Dashboard::PublishQueue queue(10);
+  Umati::Dashboard::PublishOptions retained;
+  queue.Push("a", "1", retained);
+  queue.Push("b", "1", retained);
+  queue.Push("a", "2", retained);
+
+  Umati::Dashboard::PublishQueue::Message_t message;
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.channel, "b");
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.channel, "a");
+  EXPECT_EQ(message.message, "2");
+
+  auto statistics = queue.GetStatistics();
+  EXPECT_EQ(statistics.pushed, 3u);
+  EXPECT_EQ(statistics.coalesced, 1u);
+  EXPECT_EQ(statistics.popped, 2u);
+  EXPECT_EQ(statistics.depth, 0u);
+}
+
+TEST(PublishQueue, CoalescedSnapshotFollowsThePatches) {
+  Umati::Dashboard::PublishQueue queue(10);
+  Umati::Dashboard::PublishOptions retained;
+  Umati::Dashboard::PublishOptions notRetained;
+  notRetained.Retain = false;
+  queue.Push("a", "{\"x\":1}", retained);
+  queue.Push("a/$delta", "{\"x\":2}", notRetained);
+  queue.Push("a", "{\"x\":3}", retained);
+
+  // Otherwise the older patch would be applied on top of the newer snapshot
+  Umati::Dashboard::PublishQueue::Message_t message;
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.channel, "a/$delta");
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.channel, "a");
+  EXPECT_EQ(message.message, "{\"x\":3}");
+  EXPECT_EQ(queue.GetStatistics().depth, 0u);
+}
+
+TEST(PublishQueue, NotRetainedMessagesAreKept) {
+  Umati::Dashboard::PublishQueue queue(10);
+  Umati::Dashboard::PublishOptions notRetained;
+  notRetained.Retain = false;
+  queue.Push("a/$delta", "1", notRetained);
+  queue.Push("a/$delta", "2", notRetained);
+
+  Umati::Dashboard::PublishQueue::Message_t message;
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.message, "1");
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.message, "2");
+}
+
+TEST(PublishQueue, DropsOldestWhenFull) {
+  Umati::Dashboard::PublishQueue queue(2);
+  Umati::Dashboard::PublishOptions retained;
+  queue.Push("a", "1", retained);
+  queue.Push("b", "1", retained);
+  queue.Push("c", "1", retained);
+  // "a" was dropped, so it is queued again instead of being coalesced
+  queue.Push("a", "2", retained);
+
+  auto statistics = queue.GetStatistics();
+  EXPECT_EQ(statistics.dropped, 2u);
+  EXPECT_EQ(statistics.maxDepth, 2u);
+
+  Umati::Dashboard::PublishQueue::Message_t message;
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.channel, "c");
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.channel, "a");
+  EXPECT_EQ(message.message, "2");
+}
+
+TEST(PublishQueue, RemembersDroppedPatches) {
+  Umati::Dashboard::PublishQueue queue(1);
+  Umati::Dashboard::PublishOptions notRetained;
+  notRetained.Retain = false;
+  queue.Push("a/$delta", "1", notRetained);
+  queue.Push("b", "1", Umati::Dashboard::PublishOptions());
+  queue.Push("c", "1", Umati::Dashboard::PublishOptions());
+
+  auto statistics = queue.GetStatistics(true);
+  EXPECT_EQ(statistics.dropped, 2u);
+  EXPECT_EQ(statistics.droppedNotRetained, 1u);
+  EXPECT_EQ(queue.GetStatistics().dropped, 0u);
+  // Not affected by the reset
+  EXPECT_EQ(queue.DroppedMessages(), 2u);
+
+  // A dropped retained message is replaced by the next one, only patches need the full state again
+  EXPECT_FALSE(queue.TakeDropped("b"));
+  EXPECT_TRUE(queue.TakeDropped("a/$delta"));
+  EXPECT_FALSE(queue.TakeDropped("a/$delta"));
+}
+
+TEST(PublishQueue, DropsSequencedMessagesLast) {
+  Umati::Dashboard::PublishQueue queue(2);
+  Umati::Dashboard::PublishOptions sequenced;
+  sequenced.Retain = false;
+  sequenced.Sequenced = true;
+  queue.Push("node/DDATA", "1", sequenced);
+  queue.Push("a", "1", Umati::Dashboard::PublishOptions());
+  queue.Push("node/DDATA", "2", sequenced);
+  EXPECT_FALSE(queue.TakeDroppedSequenced());
+
+  // Only sequenced messages are queued, so the oldest of them has to go
+  queue.Push("node/DDATA", "3", sequenced);
+  EXPECT_TRUE(queue.TakeDroppedSequenced());
+  EXPECT_FALSE(queue.TakeDroppedSequenced());
+
+  Umati::Dashboard::PublishQueue::Message_t message;
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.message, "2");
+  ASSERT_TRUE(queue.Pop(message));
+  EXPECT_EQ(message.message, "3");
+  EXPECT_EQ(queue.DroppedMessages(), 2u);
+}
+
+TEST(PublishQueue, CloseWakesUpConsumer) {
+  Umati::Dashboard::PublishQueue queue(10);
+  std::thread consumer([&queue]() {
+    Umati::Dashboard::PublishQueue::Message_t message;
+    std::size_t count = 0;
+    while (queue.Pop(message)) {
+      ++count;
+    }
+    EXPECT_EQ(count, 1u);
+  });
+  queue.Push("a", "1", Umati::Dashboard::PublishOptions());
+  queue.Close();
+  consumer.join();
+}
+}  // namespace Tests
+}  // namespace Umati
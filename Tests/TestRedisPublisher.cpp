@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <RedisPublisher.hpp>
+
+namespace Umati {
+namespace Tests {
+TEST(RedisPublisher, RetainedAndStream) {
+  cpp_redis::client client;
+  try {
+    client.connect("localhost", 6379);
+  } catch (const cpp_redis::redis_error &) {
+    GTEST_SKIP() << "No redis-server on localhost:6379";
+  }
+  const std::string prefix = "TestRedisPublisher:";
+  client.del({prefix + "machine", prefix + "machine:stream", prefix + "$topics"});
+  client.sync_commit();
+
+  Umati::Util::RedisConfig config;
+  config.KeyPrefix = prefix;
+  config.StreamMaxLength = 10;
+  {
+    Umati::RedisPublisher::RedisPublisher publisher(config);
+    Umati::Dashboard::PublishOptions options;
+    options.TopicClass = "machine";
+    for (int i = 0; i < 1000; ++i) {
+      publisher.Publish("machine", std::to_string(i), options);
+    }
+    auto statistics = publisher.GetStatistics();
+    EXPECT_EQ(statistics.messages, 1000u);
+    EXPECT_EQ(statistics.dropped, 0u);
+  }
+
+  auto latest = client.get(prefix + "machine");
+  auto topics = client.hexists(prefix + "$topics", "machine");
+  auto length = client.xlen(prefix + "machine:stream");
+  client.sync_commit();
+  EXPECT_EQ(latest.get().as_string(), "999");
+  EXPECT_EQ(topics.get().as_integer(), 1);
+  // MAXLEN ~ only trims whole nodes of the stream, so more entries may be kept
+  EXPECT_GE(length.get().as_integer(), 10);
+  EXPECT_LT(length.get().as_integer(), 1000);
+
+  client.del({prefix + "machine", prefix + "machine:stream", prefix + "$topics"});
+  client.sync_commit();
+}
+
+TEST(RedisPublisher, ReportsDroppedMessages) {
+  Umati::Util::RedisConfig config;
+  // Nothing listens on the port, so all messages are dropped
+  config.Port = 1;
+  Umati::RedisPublisher::RedisPublisher publisher(config);
+  Umati::Dashboard::PublishOptions retained;
+  Umati::Dashboard::PublishOptions notRetained;
+  notRetained.Retain = false;
+  publisher.Publish("machine", "{}", retained);
+  publisher.Publish("machine/$delta", "{}", notRetained);
+
+  EXPECT_EQ(publisher.DroppedMessages(), 2u);
+  EXPECT_EQ(publisher.ConnectGeneration(), 0u);
+  // Retained messages are sent again with the next ConnectGeneration
+  EXPECT_FALSE(publisher.TakeDropped("machine"));
+  EXPECT_TRUE(publisher.TakeDropped("machine/$delta"));
+  EXPECT_FALSE(publisher.TakeDropped("machine/$delta"));
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,136 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <OpcUaTypeReader.hpp>
+
+#include <chrono>
+#include <iostream>
+
+namespace Umati {
+namespace Tests {
+namespace {
+const std::string BaseUri = "http://example.com/Base/";
+const std::string Uri = "http://example.com/UA/";
+
+class TypeReader : public Umati::Dashboard::OpcUaTypeReader {
+ public:
+  TypeReader() : OpcUaTypeReader(nullptr, {Uri}, {}) {}
+
+  void SetupTypeMap(BiDirTypeMap_t bidirectionalTypeMap) {
+    setupTypeMap(bidirectionalTypeMap, Uri);
+    m_mergedChildren.clear();
+  }
+};
+
+std::shared_ptr<ModelOpcUa::StructureBiNode> addNode(
+  const std::shared_ptr<ModelOpcUa::StructureBiNode> &parent,
+  ModelOpcUa::NodeClass_t nodeClass,
+  const std::string &uri,
+  const std::string &name,
+  ModelOpcUa::ModellingRule_t modellingRule = ModelOpcUa::Mandatory) {
+  ModelOpcUa::BrowseResult_t browseResult{
+    nodeClass, ModelOpcUa::NodeId_t{uri, "s=" + name}, ModelOpcUa::NodeId_t{uri, "i=0"}, ModelOpcUa::NodeId_t{uri, "i=47"}, ModelOpcUa::QualifiedName_t{uri, name}};
+  auto node = std::make_shared<ModelOpcUa::StructureBiNode>(
+    browseResult, false, std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>>(), parent, uri, modellingRule);
+  node->isType = nodeClass == ModelOpcUa::ObjectType;
+  if (parent != nullptr) {
+    parent->SpecifiedBiChildNodes->emplace_back(node);
+  }
+  return node;
+}
+
+std::vector<std::string> names(const std::shared_ptr<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>> &nodes) {
+  std::vector<std::string> ret;
+  for (const auto &node : *nodes) {
+    ret.push_back(node->SpecifiedBrowseName.Name);
+  }
+  return ret;
+}
+}  // namespace
+
+TEST(SetupTypeMap, MergesChildrenOfSupertypes) {
+  auto bidirectionalTypeMap = std::make_shared<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
+  auto baseType = addNode(nullptr, ModelOpcUa::ObjectType, BaseUri, "BaseType");
+  addNode(addNode(baseType, ModelOpcUa::Object, BaseUri, "Optional", ModelOpcUa::Optional), ModelOpcUa::Variable, BaseUri, "A");
+  addNode(addNode(baseType, ModelOpcUa::Object, BaseUri, "Mandatory"), ModelOpcUa::Variable, BaseUri, "B");
+  auto type = addNode(baseType, ModelOpcUa::ObjectType, Uri, "Type");
+  addNode(type, ModelOpcUa::Object, BaseUri, "Optional");
+  addNode(addNode(type, ModelOpcUa::Object, BaseUri, "Mandatory"), ModelOpcUa::Variable, BaseUri, "C");
+  addNode(type, ModelOpcUa::Variable, Uri, "Own");
+  auto subType = addNode(type, ModelOpcUa::ObjectType, Uri, "SubType");
+  (*bidirectionalTypeMap)[ModelOpcUa::NodeId_t{BaseUri, "s=BaseType"}] = baseType;
+  (*bidirectionalTypeMap)[ModelOpcUa::NodeId_t{Uri, "s=Type"}] = type;
+  (*bidirectionalTypeMap)[ModelOpcUa::NodeId_t{Uri, "s=SubType"}] = subType;
+
+  TypeReader reader;
+  reader.SetupTypeMap(bidirectionalTypeMap);
+  EXPECT_EQ(reader.m_typeMap->count(ModelOpcUa::NodeId_t{BaseUri, "s=BaseType"}), 0u);
+
+  // The mandatory child of the supertype stays and gets the children of the subtype's child, the optional one is replaced
+  auto typeChildren = reader.m_typeMap->at(ModelOpcUa::NodeId_t{Uri, "s=Type"})->SpecifiedChildNodes;
+  EXPECT_EQ(names(typeChildren), (std::vector<std::string>{"Mandatory", "Optional", "Own"}));
+  EXPECT_EQ(names(typeChildren->front()->SpecifiedChildNodes), (std::vector<std::string>{"B", "C"}));
+  EXPECT_TRUE(std::next(typeChildren->begin())->get()->SpecifiedChildNodes->empty());
+  EXPECT_EQ(names(reader.m_typeMap->at(ModelOpcUa::NodeId_t{Uri, "s=SubType"})->SpecifiedChildNodes), names(typeChildren));
+  for (auto &entry : *bidirectionalTypeMap) {
+    entry.second->SpecifiedBiChildNodes->clear();
+  }
+}
+
+TEST(SetupTypeMap, SubtypeKeepsGrandchildrenToItself) {
+  auto bidirectionalTypeMap = std::make_shared<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
+  auto type = addNode(nullptr, ModelOpcUa::ObjectType, Uri, "Type");
+  addNode(addNode(type, ModelOpcUa::Object, Uri, "Mandatory"), ModelOpcUa::Variable, Uri, "A");
+  auto subType = addNode(type, ModelOpcUa::ObjectType, Uri, "SubType");
+  addNode(addNode(subType, ModelOpcUa::Object, Uri, "Mandatory"), ModelOpcUa::Variable, Uri, "B");
+  (*bidirectionalTypeMap)[ModelOpcUa::NodeId_t{Uri, "s=Type"}] = type;
+  (*bidirectionalTypeMap)[ModelOpcUa::NodeId_t{Uri, "s=SubType"}] = subType;
+
+  TypeReader reader;
+  reader.SetupTypeMap(bidirectionalTypeMap);
+
+  // The merged Mandatory of SubType starts as the one of Type, adding B must not add it to Type
+  auto typeChildren = reader.m_typeMap->at(ModelOpcUa::NodeId_t{Uri, "s=Type"})->SpecifiedChildNodes;
+  auto subTypeChildren = reader.m_typeMap->at(ModelOpcUa::NodeId_t{Uri, "s=SubType"})->SpecifiedChildNodes;
+  ASSERT_EQ(names(typeChildren), (std::vector<std::string>{"Mandatory"}));
+  ASSERT_EQ(names(subTypeChildren), (std::vector<std::string>{"Mandatory"}));
+  EXPECT_EQ(names(typeChildren->front()->SpecifiedChildNodes), (std::vector<std::string>{"A"}));
+  EXPECT_EQ(names(subTypeChildren->front()->SpecifiedChildNodes), (std::vector<std::string>{"A", "B"}));
+  for (auto &entry : *bidirectionalTypeMap) {
+    entry.second->SpecifiedBiChildNodes->clear();
+  }
+}
+
+/// Micro-benchmark: a chain of types each adding some children, each type used to merge its whole bloodline again
+TEST(SetupTypeMap, DeepHierarchy) {
+  const std::size_t depth = 400;
+  const std::size_t childrenPerType = 10;
+  auto bidirectionalTypeMap = std::make_shared<std::map<ModelOpcUa::NodeId_t, std::shared_ptr<ModelOpcUa::StructureBiNode>>>();
+  std::shared_ptr<ModelOpcUa::StructureBiNode> type;
+  for (std::size_t i = 0; i < depth; ++i) {
+    type = addNode(type, ModelOpcUa::ObjectType, Uri, "Type" + std::to_string(i));
+    for (std::size_t j = 0; j < childrenPerType; ++j) {
+      addNode(type, ModelOpcUa::Variable, Uri, "Child" + std::to_string(i) + "_" + std::to_string(j));
+    }
+    (*bidirectionalTypeMap)[ModelOpcUa::NodeId_t{Uri, "s=Type" + std::to_string(i)}] = type;
+  }
+
+  TypeReader reader;
+  auto start = std::chrono::steady_clock::now();
+  reader.SetupTypeMap(bidirectionalTypeMap);
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  std::cout << "setupTypeMap of " << depth << " types: " << duration.count() << " ms" << std::endl;
+
+  EXPECT_EQ(reader.m_typeMap->size(), depth);
+  EXPECT_EQ(reader.m_typeMap->at(ModelOpcUa::NodeId_t{Uri, "s=Type" + std::to_string(depth - 1)})->SpecifiedChildNodes->size(), depth * childrenPerType);
+  for (auto &entry : *bidirectionalTypeMap) {
+    entry.second->SpecifiedBiChildNodes->clear();
+  }
+}
+}  // namespace Tests
+}  // namespace Umati
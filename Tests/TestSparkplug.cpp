@@ -0,0 +1,160 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <SparkplugB.hpp>
+#include <SparkplugNode.hpp>
+
+#include "RecordingPublisher.hpp"
+
+namespace Umati {
+namespace Tests {
+TEST(SparkplugB, EncodePayload) {
+  Umati::Util::SparkplugB::Payload_t payload;
+  payload.timestamp = 1;
+  payload.seq = 3;
+  Umati::Util::SparkplugB::Metric_t metric;
+  metric.alias = 2;
+  metric.dataType = Umati::Util::SparkplugB::DataType_t::Boolean;
+  metric.booleanValue = true;
+  payload.metrics.push_back(metric);
+  Umati::Util::SparkplugB::Metric_t named;
+  named.name = "a";
+  named.alias = 300;
+  named.dataType = Umati::Util::SparkplugB::DataType_t::String;
+  named.stringValue = "b";
+  payload.metrics.push_back(named);
+
+  const std::string expected(
+    "\x08\x01"
+    "\x12\x06\x10\x02\x20\x0B\x70\x01"
+    "\x12\x0B\x0A\x01"
+    "a"
+    "\x10\xAC\x02\x20\x0C\x7A\x01"
+    "b"
+    "\x18\x03",
+    25);
+  EXPECT_EQ(Umati::Util::SparkplugB::Encode(payload), expected);
+}
+
+TEST(SparkplugB, DecodeSkipsUnknownFields) {
+  Umati::Util::SparkplugB::Payload_t payload;
+  payload.timestamp = 1700000000000;
+  payload.seq = 7;
+  Umati::Util::SparkplugB::Metric_t metric;
+  metric.name = "Node Control/Rebirth";
+  metric.dataType = Umati::Util::SparkplugB::DataType_t::Boolean;
+  metric.booleanValue = true;
+  payload.metrics.push_back(metric);
+  Umati::Util::SparkplugB::Metric_t number;
+  number.alias = 5;
+  number.dataType = Umati::Util::SparkplugB::DataType_t::Double;
+  number.doubleValue = 2.5;
+  payload.metrics.push_back(number);
+  // uuid (field 4) and body (field 5) are not used by the client
+  auto encoded = Umati::Util::SparkplugB::Encode(payload) + std::string("\x22\x01x\x2A\x00", 5);
+
+  Umati::Util::SparkplugB::Payload_t decoded;
+  ASSERT_TRUE(Umati::Util::SparkplugB::Decode(encoded, decoded));
+  EXPECT_EQ(decoded.timestamp, payload.timestamp);
+  EXPECT_EQ(decoded.seq, 7u);
+  ASSERT_EQ(decoded.metrics.size(), 2u);
+  EXPECT_EQ(decoded.metrics[0].name, "Node Control/Rebirth");
+  EXPECT_EQ(decoded.metrics[0].dataType, Umati::Util::SparkplugB::DataType_t::Boolean);
+  EXPECT_TRUE(decoded.metrics[0].booleanValue);
+  EXPECT_EQ(decoded.metrics[1].alias, 5u);
+  EXPECT_EQ(decoded.metrics[1].doubleValue, 2.5);
+
+  EXPECT_FALSE(Umati::Util::SparkplugB::Decode(encoded.substr(0, encoded.size() - 4), decoded));
+}
+
+TEST(SparkplugB, SetValueChecksDataType) {
+  Umati::Util::SparkplugB::Metric_t metric;
+  metric.dataType = Umati::Util::SparkplugB::DataTypeOf(nlohmann::json(5u));
+  EXPECT_EQ(metric.dataType, Umati::Util::SparkplugB::DataType_t::UInt64);
+  EXPECT_FALSE(Umati::Util::SparkplugB::SetValue(metric, -1));
+  EXPECT_FALSE(Umati::Util::SparkplugB::SetValue(metric, 1.5));
+
+  metric.dataType = Umati::Util::SparkplugB::DataType_t::Double;
+  EXPECT_TRUE(Umati::Util::SparkplugB::SetValue(metric, 5));
+  EXPECT_EQ(metric.doubleValue, 5.0);
+
+  metric.dataType = Umati::Util::SparkplugB::DataTypeOf(nlohmann::json{{"Text", "mm"}});
+  EXPECT_EQ(metric.dataType, Umati::Util::SparkplugB::DataType_t::String);
+  EXPECT_TRUE(Umati::Util::SparkplugB::SetValue(metric, nlohmann::json{{"Text", "mm"}}));
+  EXPECT_EQ(metric.stringValue, "{\"Text\":\"mm\"}");
+  EXPECT_TRUE(Umati::Util::SparkplugB::SetValue(metric, nullptr));
+  EXPECT_TRUE(metric.isNull);
+}
+
+TEST(SparkplugNode, SequenceAndBirthGeneration) {
+  RecordingPublisher publisher;
+  Umati::Dashboard::SparkplugNode node("group", "edge");
+  EXPECT_EQ(node.DeviceTopic("DDATA", "machine"), "spBv1.0/group/DDATA/edge/machine");
+  EXPECT_EQ(node.BirthGeneration(), 0u);
+  EXPECT_EQ(node.AllocateAliases(3), 1u);
+  EXPECT_EQ(node.AllocateAliases(1), 4u);
+
+  node.PublishBirth(publisher);
+  auto generation = node.BirthGeneration();
+  EXPECT_TRUE(node.Publish(publisher, node.DeviceTopic("DBIRTH", "machine"), {}, {}, generation));
+  ASSERT_EQ(publisher.messages.size(), 2u);
+  EXPECT_EQ(publisher.messages[0].first, "spBv1.0/group/NBIRTH/edge");
+  // seq is the last field
+  EXPECT_EQ(publisher.messages[0].second.substr(publisher.messages[0].second.size() - 2), std::string("\x18\x00", 2));
+  EXPECT_EQ(publisher.messages[1].second.substr(publisher.messages[1].second.size() - 2), std::string("\x18\x01", 2));
+
+  node.PublishBirth(publisher);
+  EXPECT_FALSE(node.Publish(publisher, node.DeviceTopic("DDATA", "machine"), {}, {}, generation));
+  EXPECT_EQ(publisher.messages.size(), 3u);
+}
+TEST(SparkplugNode, BdSeqPerConnect) {
+  RecordingPublisher publisher;
+  Umati::Dashboard::SparkplugNode node("group", "edge");
+  Umati::Util::SparkplugB::Payload_t first;
+  Umati::Util::SparkplugB::Payload_t second;
+  ASSERT_TRUE(Umati::Util::SparkplugB::Decode(node.NextDeathPayload(), first));
+  ASSERT_TRUE(Umati::Util::SparkplugB::Decode(node.NextDeathPayload(), second));
+  ASSERT_EQ(first.metrics.size(), 1u);
+  ASSERT_EQ(second.metrics.size(), 1u);
+  EXPECT_EQ(second.metrics[0].name, "bdSeq");
+  EXPECT_EQ(second.metrics[0].longValue, (first.metrics[0].longValue + 1) % 256);
+
+  // The NBIRTH carries the bdSeq of the last will
+  node.PublishBirth(publisher);
+  Umati::Util::SparkplugB::Payload_t birth;
+  ASSERT_EQ(publisher.messages.size(), 1u);
+  ASSERT_TRUE(Umati::Util::SparkplugB::Decode(publisher.messages[0].second, birth));
+  ASSERT_FALSE(birth.metrics.empty());
+  EXPECT_EQ(birth.metrics[0].name, "bdSeq");
+  EXPECT_EQ(birth.metrics[0].longValue, second.metrics[0].longValue);
+}
+
+TEST(SparkplugNode, RebirthCommand) {
+  RecordingPublisher publisher;
+  Umati::Dashboard::SparkplugNode node("group", "edge");
+  node.PublishBirth(publisher);
+  auto generation = node.BirthGeneration();
+
+  Umati::Util::SparkplugB::Payload_t command;
+  Umati::Util::SparkplugB::Metric_t rebirth;
+  rebirth.name = "Node Control/Rebirth";
+  rebirth.dataType = Umati::Util::SparkplugB::DataType_t::Boolean;
+  command.metrics.push_back(rebirth);
+  EXPECT_TRUE(node.HandleCommand(publisher, Umati::Util::SparkplugB::Encode(command)));
+  EXPECT_EQ(node.BirthGeneration(), generation);
+
+  command.metrics[0].booleanValue = true;
+  EXPECT_TRUE(node.HandleCommand(publisher, Umati::Util::SparkplugB::Encode(command)));
+  EXPECT_EQ(node.BirthGeneration(), generation + 1);
+  ASSERT_EQ(publisher.messages.size(), 2u);
+  EXPECT_EQ(publisher.messages[1].first, "spBv1.0/group/NBIRTH/edge");
+
+  EXPECT_FALSE(node.HandleCommand(publisher, std::string("\x12\x05", 2)));
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,87 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <TimerWheel.hpp>
+#include <map>
+#include <random>
+
+namespace Umati {
+namespace Tests {
+using Umati::Util::TimerWheel;
+using std::chrono::milliseconds;
+
+TEST(TimerWheel, ExpiresNotBeforeDeadline) {
+  auto start = TimerWheel::Clock_t::now();
+  TimerWheel wheel(milliseconds(10), start);
+  auto id = wheel.Add(start + milliseconds(25));
+  EXPECT_EQ(wheel.NextDeadline(), start + milliseconds(30));
+
+  std::vector<TimerWheel::TimerId_t> expired;
+  wheel.Advance(start + milliseconds(29), expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Advance(start + milliseconds(30), expired);
+  ASSERT_EQ(expired.size(), 1u);
+  EXPECT_EQ(expired[0], id);
+  EXPECT_EQ(wheel.Size(), 0u);
+  EXPECT_EQ(wheel.NextDeadline(), TimerWheel::Clock_t::time_point::max());
+}
+
+TEST(TimerWheel, PeriodicTimerKeepsPhase) {
+  auto start = TimerWheel::Clock_t::now();
+  TimerWheel wheel(milliseconds(10), start);
+  auto id = wheel.Add(start + milliseconds(300), milliseconds(1000));
+
+  std::vector<TimerWheel::TimerId_t> expired;
+  wheel.Advance(start + milliseconds(300), expired);
+  EXPECT_EQ(expired.size(), 1u);
+  EXPECT_EQ(wheel.NextDeadline(), start + milliseconds(1300));
+
+  // Missed periods are skipped instead of expiring several times
+  expired.clear();
+  wheel.Advance(start + milliseconds(3500), expired);
+  EXPECT_EQ(expired.size(), 1u);
+  expired.clear();
+  wheel.Advance(start + milliseconds(4299), expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Advance(start + milliseconds(4300), expired);
+  EXPECT_EQ(expired.size(), 1u);
+
+  wheel.Remove(id);
+  wheel.Advance(start + milliseconds(10000), expired);
+  EXPECT_EQ(expired.size(), 1u);
+  EXPECT_EQ(wheel.Size(), 0u);
+}
+
+TEST(TimerWheel, MatchesOrderedReference) {
+  auto start = TimerWheel::Clock_t::now();
+  TimerWheel wheel(milliseconds(1), start);
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> delays(0, 300000);
+
+  std::map<TimerWheel::TimerId_t, milliseconds> deadlines;
+  for (int i = 0; i < 2000; ++i) {
+    milliseconds deadline(delays(random));
+    deadlines[wheel.Add(start + deadline)] = deadline;
+  }
+
+  std::vector<TimerWheel::TimerId_t> expired;
+  for (milliseconds now(0); now <= milliseconds(300000); now += milliseconds(7)) {
+    expired.clear();
+    wheel.Advance(start + now, expired);
+    ASSERT_GT(wheel.NextDeadline(), start + now);
+    for (auto id : expired) {
+      auto deadline = deadlines.at(id);
+      EXPECT_LE(deadline, now);
+      EXPECT_GT(deadline, now - milliseconds(7));
+      deadlines.erase(id);
+    }
+  }
+  EXPECT_TRUE(deadlines.empty());
+}
+}  // namespace Tests
+}  // namespace Umati
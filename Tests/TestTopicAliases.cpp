@@ -0,0 +1,76 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <TopicAliases.hpp>
+
+namespace Umati {
+namespace Tests {
+TEST(TopicAliases, HotTopicsGetAnAlias) {
+  Umati::MqttPublisher_Paho::TopicAliases aliases(2);
+  aliases.Reset(10);
+  bool established = true;
+  EXPECT_EQ(aliases.Get("a", established), 0u);
+  EXPECT_FALSE(established);
+  // The second message carries topic and alias
+  EXPECT_EQ(aliases.Get("a", established), 1u);
+  EXPECT_FALSE(established);
+  aliases.Sent("a");
+  EXPECT_EQ(aliases.Get("a", established), 1u);
+  EXPECT_TRUE(established);
+}
+
+TEST(TopicAliases, FailedPublishSendsTheTopicAgain) {
+  Umati::MqttPublisher_Paho::TopicAliases aliases(1);
+  aliases.Reset(10);
+  bool established;
+  EXPECT_EQ(aliases.Get("a", established), 1u);
+  // The publish threw, the broker does not know the alias yet
+  EXPECT_EQ(aliases.Get("a", established), 1u);
+  EXPECT_FALSE(established);
+  aliases.Sent("a");
+  EXPECT_EQ(aliases.Get("a", established), 1u);
+  EXPECT_TRUE(established);
+  // Topics without an alias are not affected
+  aliases.Reset(0);
+  aliases.Get("b", established);
+  aliases.Sent("b");
+  EXPECT_EQ(aliases.Get("b", established), 0u);
+  EXPECT_FALSE(established);
+}
+
+TEST(TopicAliases, BrokerMaximum) {
+  Umati::MqttPublisher_Paho::TopicAliases aliases(1);
+  aliases.Reset(1);
+  bool established;
+  EXPECT_EQ(aliases.Get("a", established), 1u);
+  EXPECT_EQ(aliases.Get("b", established), 0u);
+
+  // Without a maximum in the CONNACK, no aliases are used
+  aliases.Reset(0);
+  EXPECT_EQ(aliases.Get("a", established), 0u);
+  EXPECT_FALSE(established);
+}
+
+TEST(TopicAliases, ResetOnReconnect) {
+  Umati::MqttPublisher_Paho::TopicAliases aliases(1);
+  aliases.Reset(2);
+  bool established;
+  aliases.Get("a", established);
+  aliases.Get("b", established);
+  aliases.Sent("b");
+  EXPECT_EQ(aliases.Get("b", established), 2u);
+  EXPECT_TRUE(established);
+
+  // The new connection has its own, possibly smaller, maximum and the topic has to be sent again
+  aliases.Reset(1);
+  EXPECT_EQ(aliases.Get("b", established), 1u);
+  EXPECT_FALSE(established);
+  EXPECT_EQ(aliases.Get("a", established), 0u);
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,99 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <TypeCache.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+namespace Umati {
+namespace Tests {
+namespace {
+const std::string Uri = "http://example.com/UA/";
+const std::string CacheFile = "TestTypeCache.bin";
+
+std::shared_ptr<ModelOpcUa::StructureNode> makeNode(
+  ModelOpcUa::NodeClass_t nodeClass, const std::string &id, const std::string &name, std::shared_ptr<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>> children) {
+  return std::make_shared<ModelOpcUa::StructureNode>(
+    nodeClass, ModelOpcUa::Mandatory, ModelOpcUa::NodeId_t{Uri, "i=47"}, ModelOpcUa::NodeId_t{Uri, id}, ModelOpcUa::QualifiedName_t{Uri, name}, false, children);
+}
+
+/// Type A with a variable Value, type B with a component of type B, sharing the child list of B like OpcUaTypeReader::updateTypeMap does
+Umati::Dashboard::TypeCache::TypeMap_t makeTypeMap() {
+  auto pValue = makeNode(ModelOpcUa::Variable, "i=63", "Value", std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>>());
+  pValue->ofBaseDataVariableType = true;
+  auto pTypeA = makeNode(ModelOpcUa::ObjectType, "i=1", "A", std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>>());
+  pTypeA->SpecifiedChildNodes->push_back(pValue);
+  auto pTypeB = makeNode(ModelOpcUa::ObjectType, "i=2", "B", std::make_shared<std::list<std::shared_ptr<ModelOpcUa::StructureNode>>>());
+  pTypeB->SpecifiedChildNodes->push_back(makeNode(ModelOpcUa::Object, "i=2", "Child", pTypeB->SpecifiedChildNodes));
+  return {{ModelOpcUa::NodeId_t{Uri, "i=1"}, pTypeA}, {ModelOpcUa::NodeId_t{Uri, "i=2"}, pTypeB}};
+}
+
+void breakCycles(Umati::Dashboard::TypeCache::TypeMap_t &typeMap) {
+  for (auto &type : typeMap) {
+    type.second->SpecifiedChildNodes->clear();
+  }
+}
+}  // namespace
+
+TEST(TypeCache, RoundTrip) {
+  auto typeMap = makeTypeMap();
+  Umati::Dashboard::TypeCache::NameToId_t nameToId{{Uri + ";A", ModelOpcUa::NodeId_t{Uri, "i=1"}}};
+  Umati::Dashboard::TypeCache::Store(CacheFile, "key", typeMap, nameToId);
+
+  Umati::Dashboard::TypeCache::TypeMap_t loadedTypeMap;
+  Umati::Dashboard::TypeCache::NameToId_t loadedNameToId;
+  ASSERT_TRUE(Umati::Dashboard::TypeCache::Load(CacheFile, "key", loadedTypeMap, loadedNameToId));
+  ASSERT_EQ(loadedTypeMap.size(), 2u);
+  EXPECT_EQ(loadedNameToId, nameToId);
+
+  auto pTypeA = loadedTypeMap.at(ModelOpcUa::NodeId_t{Uri, "i=1"});
+  EXPECT_EQ(pTypeA->NodeClass, ModelOpcUa::ObjectType);
+  EXPECT_EQ(pTypeA->SpecifiedBrowseName.Name, "A");
+  ASSERT_EQ(pTypeA->SpecifiedChildNodes->size(), 1u);
+  auto pValue = pTypeA->SpecifiedChildNodes->front();
+  EXPECT_EQ(pValue->NodeClass, ModelOpcUa::Variable);
+  EXPECT_EQ(pValue->ModellingRule, ModelOpcUa::Mandatory);
+  EXPECT_EQ(pValue->ReferenceType, (ModelOpcUa::NodeId_t{Uri, "i=47"}));
+  EXPECT_EQ(pValue->SpecifiedTypeNodeId, (ModelOpcUa::NodeId_t{Uri, "i=63"}));
+  EXPECT_TRUE(pValue->ofBaseDataVariableType);
+
+  auto pTypeB = loadedTypeMap.at(ModelOpcUa::NodeId_t{Uri, "i=2"});
+  ASSERT_EQ(pTypeB->SpecifiedChildNodes->size(), 1u);
+  EXPECT_EQ(pTypeB->SpecifiedChildNodes->front()->SpecifiedChildNodes, pTypeB->SpecifiedChildNodes);
+
+  breakCycles(typeMap);
+  breakCycles(loadedTypeMap);
+  std::remove(CacheFile.c_str());
+}
+
+TEST(TypeCache, RejectsOtherKeyAndDamagedFile) {
+  auto typeMap = makeTypeMap();
+  Umati::Dashboard::TypeCache::Store(CacheFile, "key", typeMap, Umati::Dashboard::TypeCache::NameToId_t());
+  breakCycles(typeMap);
+
+  Umati::Dashboard::TypeCache::TypeMap_t loadedTypeMap;
+  Umati::Dashboard::TypeCache::NameToId_t loadedNameToId;
+  EXPECT_FALSE(Umati::Dashboard::TypeCache::Load(CacheFile, "other key", loadedTypeMap, loadedNameToId));
+  EXPECT_FALSE(Umati::Dashboard::TypeCache::Load("missing.bin", "key", loadedTypeMap, loadedNameToId));
+
+  std::string content;
+  {
+    std::ifstream file(CacheFile, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream file(CacheFile, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), static_cast<std::streamsize>(content.size() / 2));
+  }
+  EXPECT_FALSE(Umati::Dashboard::TypeCache::Load(CacheFile, "key", loadedTypeMap, loadedNameToId));
+  EXPECT_TRUE(loadedTypeMap.empty());
+  std::remove(CacheFile.c_str());
+}
+}  // namespace Tests
+}  // namespace Umati
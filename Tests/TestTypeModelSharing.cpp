@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <TypeModelSharing.hpp>
+
+#include <iostream>
+
+namespace Umati {
+namespace Tests {
+namespace {
+const std::string Uri = "http://example.com/UA/";
+
+std::shared_ptr<ModelOpcUa::StructureNode> addNode(
+  const std::shared_ptr<ModelOpcUa::StructureNode> &parent, ModelOpcUa::NodeClass_t nodeClass, const std::string &name, const std::string &type) {
+  auto node = std::make_shared<ModelOpcUa::StructureNode>(
+    nodeClass,
+    ModelOpcUa::Mandatory,
+    ModelOpcUa::NodeId_t{"http://opcfoundation.org/UA/", "i=47"},
+    ModelOpcUa::NodeId_t{Uri, type},
+    ModelOpcUa::QualifiedName_t{Uri, name},
+    false);
+  if (parent != nullptr) {
+    parent->SpecifiedChildNodes->emplace_back(node);
+  }
+  return node;
+}
+
+/// Machine type with an identification of some properties, each type declares its own instance of it
+std::shared_ptr<ModelOpcUa::StructureNode> addMachineType(Dashboard::TypeModelSharing::TypeMap_t &typeMap, const std::string &name) {
+  auto type = addNode(nullptr, ModelOpcUa::ObjectType, name, "s=" + name);
+  auto identification = addNode(type, ModelOpcUa::Object, "Identification", "s=IdentificationType");
+  for (const auto &property : {"Manufacturer", "SerialNumber", "YearOfConstruction", "ProductInstanceUri"}) {
+    addNode(identification, ModelOpcUa::Variable, property, "i=68");
+  }
+  addNode(type, ModelOpcUa::Object, name + "Specific", "i=58");
+  typeMap[ModelOpcUa::NodeId_t{Uri, "s=" + name}] = type;
+  return type;
+}
+}  // namespace
+
+TEST(TypeModelSharing, SharesIdenticalSubtrees) {
+  Dashboard::TypeModelSharing::TypeMap_t typeMap;
+  auto machine = addMachineType(typeMap, "MachineType");
+  auto otherMachine = addMachineType(typeMap, "OtherMachineType");
+  // A child of the type itself refers to the list of the type, like after OpcUaTypeReader::updateTypeMap
+  addNode(machine, ModelOpcUa::Object, "SubMachine", "s=MachineType")->SpecifiedChildNodes = machine->SpecifiedChildNodes;
+
+  auto before = Dashboard::TypeModelSharing::Measure(typeMap);
+  EXPECT_EQ(before.Nodes, 2u + 2 * 6 + 1);
+  Dashboard::TypeModelSharing::Share(typeMap);
+  auto after = Dashboard::TypeModelSharing::Measure(typeMap);
+  EXPECT_EQ(after.Nodes, 2u + 6 + 2);
+  EXPECT_LT(after.Bytes, before.Bytes);
+
+  EXPECT_EQ(machine->SpecifiedChildNodes->front(), otherMachine->SpecifiedChildNodes->front());
+  EXPECT_EQ(machine->SpecifiedChildNodes->front()->SpecifiedChildNodes->size(), 4u);
+  EXPECT_NE(machine->SpecifiedChildNodes, otherMachine->SpecifiedChildNodes);
+  EXPECT_NE(*std::next(machine->SpecifiedChildNodes->begin()), *std::next(otherMachine->SpecifiedChildNodes->begin()));
+  EXPECT_EQ(machine->SpecifiedChildNodes->back()->SpecifiedChildNodes, machine->SpecifiedChildNodes);
+
+  // Leaves share their empty child list
+  auto identification = machine->SpecifiedChildNodes->front();
+  EXPECT_EQ(identification->SpecifiedChildNodes->front()->SpecifiedChildNodes, identification->SpecifiedChildNodes->back()->SpecifiedChildNodes);
+
+  for (auto &entry : typeMap) {
+    entry.second->SpecifiedChildNodes->clear();
+  }
+}
+
+/// Reports the memory of many types declaring the same identification
+TEST(TypeModelSharing, ManyTypes) {
+  const std::size_t typeCount = 1000;
+  Dashboard::TypeModelSharing::TypeMap_t typeMap;
+  for (std::size_t i = 0; i < typeCount; ++i) {
+    addMachineType(typeMap, "MachineType" + std::to_string(i));
+  }
+  auto before = Dashboard::TypeModelSharing::Measure(typeMap);
+  Dashboard::TypeModelSharing::Share(typeMap);
+  auto after = Dashboard::TypeModelSharing::Measure(typeMap);
+  std::cout << typeCount << " types: " << before.Nodes << " nodes, " << before.ChildLists << " child lists, " << before.Bytes / 1024
+            << " KiB before sharing, " << after.Nodes << " nodes, " << after.ChildLists << " child lists, " << after.Bytes / 1024
+            << " KiB after" << std::endl;
+  EXPECT_EQ(after.Nodes, 2 * typeCount + 5);
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -0,0 +1,79 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <Uadp.hpp>
+#include <UadpWriterGroup.hpp>
+
+#include "RecordingPublisher.hpp"
+
+namespace Umati {
+namespace Tests {
+TEST(Uadp, EncodeDeltaFrame) {
+  Umati::Util::Uadp::NetworkMessageHeader_t header;
+  header.publisherId = "p";
+  header.writerGroupId = 1;
+  header.sequenceNumber = 2;
+  Umati::Util::Uadp::DataSetMessage_t message;
+  message.type = Umati::Util::Uadp::DataSetMessageType_t::DeltaFrame;
+  message.sequenceNumber = 4;
+  message.configurationVersion.major = 5;
+  message.configurationVersion.minor = 6;
+  Umati::Util::Uadp::Field_t field;
+  field.index = 7;
+  field.builtInType = Umati::Util::Uadp::BuiltInType_t::Boolean;
+  field.value = true;
+  message.fields.push_back(field);
+
+  const unsigned char expected[] = {
+    0xF1, 0x04, 0x01, 0x00, 0x00, 0x00, 'p',                    // Flags, ExtendedFlags1, PublisherId
+    0x09, 0x01, 0x00, 0x02, 0x00,                               // Group header
+    0x01, 0x03, 0x00,                                           // Payload header
+    0xED, 0x11, 0x04, 0x00,                                     // DataSetFlags1, DataSetFlags2, sequence number
+    0x00, 0x80, 0x3E, 0xD5, 0xDE, 0xB1, 0x9D, 0x01,             // Timestamp 1970-01-01
+    0x05, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,             // ConfigurationVersion
+    0x01, 0x00, 0x07, 0x00, 0x01, 0x01, 0x01};                  // Field count, index, DataValue
+  EXPECT_EQ(Umati::Util::Uadp::EncodeDataSetMessage(header, 3, message), std::string(reinterpret_cast<const char *>(expected), sizeof(expected)));
+}
+
+TEST(Uadp, FieldTypes) {
+  using Umati::Util::Uadp::BuiltInType_t;
+  EXPECT_EQ(Umati::Util::Uadp::BuiltInTypeOf(nlohmann::json(5u)), BuiltInType_t::UInt64);
+  EXPECT_EQ(Umati::Util::Uadp::BuiltInTypeOf(nlohmann::json::object()), BuiltInType_t::String);
+  EXPECT_TRUE(Umati::Util::Uadp::Fits(BuiltInType_t::Int64, nlohmann::json(5u)));
+  EXPECT_TRUE(Umati::Util::Uadp::Fits(BuiltInType_t::Double, nlohmann::json(5)));
+  EXPECT_TRUE(Umati::Util::Uadp::Fits(BuiltInType_t::Boolean, nlohmann::json()));
+  EXPECT_FALSE(Umati::Util::Uadp::Fits(BuiltInType_t::UInt64, nlohmann::json(-1)));
+  EXPECT_FALSE(Umati::Util::Uadp::Fits(BuiltInType_t::String, nlohmann::json(true)));
+  EXPECT_GT(Umati::Util::Uadp::VersionTime(UINT32_MAX - 1), UINT32_MAX - 1);
+}
+
+TEST(Uadp, WriterGroupTopics) {
+  Umati::Util::UadpConfig config;
+  config.WriterGroup = "group";
+  Umati::Dashboard::UadpWriterGroup writerGroup(config, "client");
+  EXPECT_EQ(writerGroup.DataTopic("machine"), "opcua/uadp/data/client/group/machine");
+  EXPECT_EQ(writerGroup.MetaDataTopic("machine"), "opcua/uadp/metadata/client/group/machine");
+  EXPECT_EQ(writerGroup.AllocateDataSetWriterId(), 1);
+  EXPECT_EQ(writerGroup.AllocateDataSetWriterId(), 2);
+
+  RecordingPublisher publisher;
+  Umati::Util::Uadp::DataSetMetaData_t metaData;
+  writerGroup.PublishMetaData(publisher, "machine", 1, metaData);
+  writerGroup.PublishDataSetMessage(publisher, "machine", 1, Umati::Util::Uadp::DataSetMessage_t());
+  writerGroup.PublishDataSetMessage(publisher, "machine", 1, Umati::Util::Uadp::DataSetMessage_t());
+  ASSERT_EQ(publisher.messages.size(), 3u);
+  EXPECT_TRUE(publisher.retained[0]);
+  EXPECT_FALSE(publisher.retained[1]);
+  // Discovery response with DataSetMetaData
+  EXPECT_EQ(publisher.messages[0].second.substr(0, 3), std::string("\x91\x84\x08", 3));
+  // NetworkMessage sequence numbers
+  EXPECT_EQ(publisher.messages[1].second.substr(15, 2), std::string("\x00\x00", 2));
+  EXPECT_EQ(publisher.messages[2].second.substr(15, 2), std::string("\x01\x00", 2));
+}
+}  // namespace Tests
+}  // namespace Umati
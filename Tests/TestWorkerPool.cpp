@@ -0,0 +1,37 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include <gtest/gtest.h>
+#include <WorkerPool.hpp>
+#include <atomic>
+#include <stdexcept>
+
+namespace Umati {
+namespace Tests {
+TEST(WorkerPool, ExecutesAllTasksBeforeDestruction) {
+  std::atomic<int> executed{0};
+  {
+    Umati::Util::WorkerPool pool(4);
+    EXPECT_EQ(pool.Size(), 4u);
+    for (int i = 0; i < 1000; ++i) {
+      pool.Post([&executed]() { ++executed; });
+    }
+  }
+  EXPECT_EQ(executed, 1000);
+}
+
+TEST(WorkerPool, ContinuesAfterFailedTask) {
+  std::atomic<int> executed{0};
+  {
+    Umati::Util::WorkerPool pool(1);
+    pool.Post([]() { throw std::runtime_error("failed"); });
+    pool.Post([&executed]() { ++executed; });
+  }
+  EXPECT_EQ(executed, 1);
+}
+}  // namespace Tests
+}  // namespace Umati
@@ -24,6 +24,8 @@ TEST(ConfigurationJsonFile, NormalConfiguration) {
   EXPECT_EQ(conf.getMqtt().Port, 1883);
   EXPECT_EQ(conf.getMqtt().Username, "MyUser");
   EXPECT_EQ(conf.getMqtt().Password, "MyPassword");
+  EXPECT_TRUE(conf.getPublish().DeltaMode);
+  EXPECT_EQ(conf.getPublish().SnapshotInterval, 60);
 }
 
 TEST(ConfigurationJsonFile, WithoutNamespaces) {
@@ -39,6 +41,7 @@ TEST(ConfigurationJsonFile, WithoutNamespaces) {
   EXPECT_EQ(conf.getMqtt().ClientId, "test/test");
   EXPECT_EQ(conf.getMqtt().Username, "MyUser");
   EXPECT_EQ(conf.getMqtt().Password, "MyPassword");
+  EXPECT_FALSE(conf.getPublish().DeltaMode);
 }
 
 TEST(ConfigurationJsonFile, FileNotFound) {
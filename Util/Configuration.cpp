@@ -8,6 +8,9 @@
 
 #include "Configuration.hpp"
 #include "Exceptions/ConfigurationException.hpp"
+#include "PayloadEncoding.hpp"
+
+#include <set>
 
 namespace Umati {
 namespace Util {
@@ -28,6 +31,85 @@ void Configuration::Verify() {
   if (opcua.Endpoint.empty()) {
     throw Exception::ConfigurationException("OPC UA endpoint is not specified.");
   }
+  auto publish = this->getPublish();
+  PayloadEncodingFromString(publish.Encoding.Machine);
+  PayloadEncodingFromString(publish.Encoding.List);
+  PayloadEncodingFromString(publish.Encoding.Online);
+  if (publish.Interval == 0) {
+    throw Exception::ConfigurationException("Publish Interval must not be 0.");
+  }
+  for (const auto &interval : publish.Intervals) {
+    if (interval.second == 0) {
+      throw Exception::ConfigurationException("Publish Interval of " + interval.first + " must not be 0.");
+    }
+  }
+  std::set<std::string> rateGroupNames;
+  for (const auto &rateGroup : publish.RateGroups) {
+    if (rateGroup.Name.empty() || !rateGroupNames.insert(rateGroup.Name).second) {
+      throw Exception::ConfigurationException("Each rate group requires a unique Name.");
+    }
+    if (rateGroup.Interval == 0) {
+      throw Exception::ConfigurationException("Interval of rate group " + rateGroup.Name + " must not be 0.");
+    }
+  }
+  if (publish.Sinks.empty()) {
+    throw Exception::ConfigurationException("No publish sink is specified.");
+  }
+  std::set<std::string> sinks;
+  for (const auto &sink : publish.Sinks) {
+    if (sink != "mqtt" && sink != "file" && sink != "redis") {
+      throw Exception::ConfigurationException("Unknown publish sink '" + sink + "'.");
+    }
+    if (!sinks.insert(sink).second) {
+      throw Exception::ConfigurationException("Publish sink '" + sink + "' is specified twice.");
+    }
+  }
+  if (sinks.count("file") != 0) {
+    if (publish.File.Format != "ndjson" && publish.File.Format != "binary") {
+      throw Exception::ConfigurationException("Unknown file sink format '" + publish.File.Format + "'.");
+    }
+    if (publish.File.MaxFileSize == 0) {
+      throw Exception::ConfigurationException("MaxFileSize of the file sink must not be 0.");
+    }
+  }
+  if (publish.Sparkplug.Enabled) {
+    // Sequence numbers of the sink queues would diverge, as each sink drops messages on its own
+    if (sinks.size() != 1 || sinks.count("mqtt") == 0) {
+      throw Exception::ConfigurationException("Sparkplug requires the mqtt sink as the only sink.");
+    }
+    if (publish.Sparkplug.GroupId.empty() || publish.Sparkplug.GroupId.find_first_of("/+#") != std::string::npos) {
+      throw Exception::ConfigurationException("Sparkplug GroupId must not be empty or contain '/', '+' or '#'.");
+    }
+    if (publish.Sparkplug.Will != "NDEATH" && publish.Sparkplug.Will != "clientOnline") {
+      throw Exception::ConfigurationException("Sparkplug Will must be NDEATH or clientOnline.");
+    }
+  }
+  if (publish.Uadp.Enabled) {
+    if (publish.Uadp.TopicPrefix.empty()) {
+      throw Exception::ConfigurationException("Uadp TopicPrefix must not be empty.");
+    }
+    for (const auto &level : {publish.Uadp.PublisherId, publish.Uadp.WriterGroup}) {
+      if (level.find_first_of("/+#") != std::string::npos) {
+        throw Exception::ConfigurationException("Uadp PublisherId and WriterGroup must not contain '/', '+' or '#'.");
+      }
+    }
+    if (publish.Uadp.WriterGroup.empty()) {
+      throw Exception::ConfigurationException("Uadp WriterGroup must not be empty.");
+    }
+    if (publish.Uadp.KeyFrameCount == 0) {
+      throw Exception::ConfigurationException("Uadp KeyFrameCount must not be 0.");
+    }
+  }
+#ifndef UMATI_WITH_REDIS
+  if (sinks.count("redis") != 0) {
+    throw Exception::ConfigurationException("The redis sink is configured, but the client was built without it (DASHBOARD_PUBLISHER=REDIS).");
+  }
+#endif
+#ifndef UMATI_WITH_ZSTD
+  if (publish.Compression.Enabled) {
+    throw Exception::ConfigurationException("Compression is enabled, but the client was built without zstd (DASHBOARD_WITH_ZSTD).");
+  }
+#endif
 }
 }  // namespace Util
 }  // namespace Umati
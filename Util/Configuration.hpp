@@ -11,12 +11,34 @@
 
 #include <string>
 #include <cstdint>
+#include <map>
 #include <vector>
 #include <stdexcept>
 #include "../ModelOpcUa/src/ModelOpcUa/ModelDefinition.hpp"
 
 namespace Umati {
 namespace Util {
+/// Store-and-forward of messages during broker outages
+struct OfflineBufferConfig {
+  /// Memory mapped ring file, store-and-forward is disabled if empty
+  std::string File;
+  /// Size of the ring in bytes, the oldest messages are overwritten if it is full
+  std::uint64_t Size = 16 * 1024 * 1024;
+  /// Replay all messages in order, otherwise only the latest retained message per topic is kept
+  bool History = false;
+  /// Messages per second sent from the buffer after a reconnect, 0 for no limit
+  std::uint32_t ReplayRate = 100;
+};
+
+struct MqttV5Config {
+  /// Connect with MQTT v5 instead of v3.1.1
+  bool Enabled = false;
+  /// Upper limit of topic aliases, the lower maximum of the broker is used if it announces one
+  std::uint16_t TopicAliasMaximum = 100;
+  /// Seconds not retained messages are kept by the broker for offline subscribers, 0 for no expiry
+  std::uint32_t MessageExpiry = 60;
+};
+
 struct MqttConfig {
   ///  Hostname or IP-Address
   std::string Hostname;
@@ -29,6 +51,10 @@ struct MqttConfig {
   /// Must be provided
   std::string ClientId;
   std::string Protocol = "tcp";
+  /// Maximal number of messages waiting to be sent, the oldest one is dropped if it is exceeded
+  std::uint32_t QueueSize = 1000;
+  OfflineBufferConfig OfflineBuffer;
+  MqttV5Config V5;
 #ifndef WIN32
   std::string CaCertPath = "/etc/ssl/certs/";
   std::string CaTrustStorePath = "";
@@ -46,6 +72,140 @@ struct OpcUaConfig {
   /// 1 = None, 2 Sign, 3 = Sign&Encrypt
   std::uint8_t Security = 1;
   bool ByPassCertVerification = false;
+  /// File the browsed type model is stored in and loaded from on the next start, empty disables the cache
+  std::string TypeCacheFile;
+  /// NodeSet2 XML files the type model is read from, types not defined in them are browsed from the server
+  std::vector<std::string> NodeSetFiles;
+  /// Read each type when the first machine using it is found instead of all types of the ObjectTypeNamespaces at startup
+  bool LazyTypes = false;
+};
+
+/// Encoding per topic class: "json", "cbor" or "msgpack"
+struct PayloadEncodingConfig {
+  /// Machine documents, merge patches and leaf topics
+  std::string Machine = "json";
+  /// Machine list and error list
+  std::string List = "json";
+  /// Online status of the machines
+  std::string Online = "json";
+};
+
+/// zstd compression of large payloads, requires a build with DASHBOARD_WITH_ZSTD
+struct CompressionConfig {
+  bool Enabled = false;
+  /// Payloads smaller than this number of bytes are sent uncompressed
+  std::uint32_t Threshold = 16384;
+  /// zstd compression level, 1 (fast) to 19 (small)
+  int Level = 3;
+  /// Number of payloads per companion specification a dictionary is trained on, 0 disables dictionaries
+  std::uint32_t DictionarySamples = 50;
+  /// Maximal size of a trained dictionary in bytes
+  std::uint32_t DictionarySize = 65536;
+  /// Existing directory the trained dictionaries are stored in and loaded from on startup
+  std::string DictionaryDirectory = ".";
+};
+
+/// Part of a machine document that is serialized with its own interval
+struct RateGroupConfig {
+  /// Unique name, used as topic level
+  std::string Name;
+  /// Only apply to machines of this companion specification (SpecifiedBrowseName of the type), empty for all
+  std::string Specification;
+  /// BrowseName paths below the machine, levels separated by '/', e.g. "Monitoring/Spindle"
+  std::vector<std::string> Paths;
+  /// Children of these types at any depth below the machine, placeholders are not searched
+  std::vector<ModelOpcUa::NodeId_t> Types;
+  /// Milliseconds between two serializations of the group, rounded up to the publish interval of the machine
+  std::uint32_t Interval = 60000;
+  /// Keep the group in the machine document instead of publishing it on its own topic
+  bool Merged = false;
+};
+
+/// Sink appending all messages to local files
+struct FileSinkConfig {
+  /// Existing directory the files are written to
+  std::string Directory = ".";
+  /// File names start with this prefix, followed by the start time of the client and a sequence number
+  std::string Prefix = "messages";
+  /// "ndjson" for one JSON object per line or "binary" for length prefixed records
+  std::string Format = "ndjson";
+  /// A new file is started once a file reaches this size in bytes
+  std::uint64_t MaxFileSize = 64 * 1024 * 1024;
+  /// Files of this run that are kept, the oldest are deleted, 0 keeps all
+  std::uint32_t MaxFiles = 10;
+  /// Records are collected in memory and written with a single call once this many bytes are buffered
+  std::uint32_t BufferSize = 1024 * 1024;
+  /// Milliseconds between writing the buffer and syncing the file to disk, 0 syncs only when a file is closed
+  std::uint32_t SyncInterval = 1000;
+};
+
+/// Sink writing to Redis, only available if the client is built with DASHBOARD_PUBLISHER=REDIS
+struct RedisConfig {
+  std::string Hostname = "localhost";
+  std::uint16_t Port = 6379;
+  std::string Password;
+  std::uint32_t Database = 0;
+  /// Prepended to all keys
+  std::string KeyPrefix;
+  /// Messages of these topic classes are appended to the stream <KeyPrefix><Topic>:stream
+  std::vector<std::string> StreamClasses = {"machine", "delta"};
+  /// Approximate number of entries kept per stream, 0 for no limit
+  std::uint32_t StreamMaxLength = 1000;
+  /// Milliseconds between sending the collected commands as one pipeline
+  std::uint32_t FlushInterval = 100;
+  /// Collected commands after which the pipeline is sent before FlushInterval elapsed
+  std::uint32_t BatchSize = 1000;
+};
+
+/// Additionally publish the machines as devices of a Sparkplug B edge node
+struct SparkplugConfig {
+  bool Enabled = false;
+  std::string GroupId = "umati";
+  /// Empty uses the ClientId of the MQTT configuration
+  std::string EdgeNodeId;
+  /// Last will of the MQTT connection, "NDEATH" or "clientOnline", a connection can only have one
+  std::string Will = "NDEATH";
+};
+
+/// Additionally publish the machines as OPC UA PubSub DataSets in UADP NetworkMessages
+struct UadpConfig {
+  bool Enabled = false;
+  std::string TopicPrefix = "opcua";
+  /// Sent as String PublisherId, empty uses the ClientId of the MQTT configuration
+  std::string PublisherId;
+  std::string WriterGroup = "umati";
+  std::uint16_t WriterGroupId = 1;
+  /// DataSetMessages between two key frames including the key frame, 1 sends only key frames
+  std::uint32_t KeyFrameCount = 10;
+};
+
+struct PublishConfig {
+  /// Additionally publish RFC 7386 merge patches of the changed fields on Topics::MachineDelta
+  bool DeltaMode = false;
+  /// Seconds between two full retained snapshots on Topics::Machine, only used in DeltaMode
+  std::uint32_t SnapshotInterval = 60;
+  /// Additionally publish every subscribed variable on its own topic below the machine topic
+  bool LeafTopics = false;
+  PayloadEncodingConfig Encoding;
+  CompressionConfig Compression;
+  /// Seconds between two republications of unchanged online states, machine lists and error lists, 0 publishes them only on changes
+  std::uint32_t StatusRefreshInterval = 0;
+  /// Milliseconds between two publications of a machine
+  std::uint32_t Interval = 1000;
+  /// Interval per companion specification (SpecifiedBrowseName of the type), overrides Interval
+  std::map<std::string, std::uint32_t> Intervals;
+  /// Parts of the machine documents with their own interval, a node is assigned to the first matching group
+  std::vector<RateGroupConfig> RateGroups;
+  /// Threads building the payloads of the machines, 0 builds them on the OPC UA thread
+  std::uint32_t Workers = 0;
+  /// Publishers all messages are sent to, "mqtt", "file" and "redis"
+  std::vector<std::string> Sinks = {"mqtt"};
+  /// Messages queued per sink if there are several sinks, the oldest are dropped if a sink can not keep up
+  std::uint32_t SinkQueueSize = 1000;
+  FileSinkConfig File;
+  RedisConfig Redis;
+  SparkplugConfig Sparkplug;
+  UadpConfig Uadp;
 };
 
 /**
@@ -70,6 +230,8 @@ class Configuration {
 
   virtual OpcUaConfig getOpcUa() = 0;
 
+  virtual PublishConfig getPublish() = 0;
+
   virtual bool hasMachinesFilter() = 0;
 
   virtual std::vector<ModelOpcUa::NodeId_t> getMachinesFilter() = 0;
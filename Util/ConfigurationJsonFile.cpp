@@ -27,6 +27,7 @@ ConfigurationJsonFile::ConfigurationJsonFile(const std::string &filename) {
   try {
     i >> j;
     from_json(j, *this);
+    Publish = j.value("Publish", PublishConfig());
     Verify();
   } catch (nlohmann::json_abi_v3_11_2::detail::parse_error &ex) {
     std::stringstream ss;
@@ -39,6 +40,8 @@ MqttConfig ConfigurationJsonFile::getMqtt() { return Mqtt; }
 
 OpcUaConfig ConfigurationJsonFile::getOpcUa() { return OpcUa; }
 
+PublishConfig ConfigurationJsonFile::getPublish() { return Publish; }
+
 std::vector<NamespaceInformation> ConfigurationJsonFile::getNamespaceInformations() { return NamespaceInformations; }
 
 std::vector<std::string> ConfigurationJsonFile::getObjectTypeNamespaces() { return ObjectTypeNamespaces; }
@@ -18,8 +18,18 @@ namespace ModelOpcUa
 }
 namespace Umati {
 	namespace Util {
-		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(MqttConfig, Hostname, Port, Username, Password, Prefix, ClientId, Protocol, CaCertPath, CaTrustStorePath);
-		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(OpcUaConfig, Endpoint, Username, Password, Security, ByPassCertVerification);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(OfflineBufferConfig, File, Size, History, ReplayRate);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(MqttV5Config, Enabled, TopicAliasMaximum, MessageExpiry);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(MqttConfig, Hostname, Port, Username, Password, Prefix, ClientId, Protocol, CaCertPath, CaTrustStorePath, QueueSize, OfflineBuffer, V5);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(OpcUaConfig, Endpoint, Username, Password, Security, ByPassCertVerification, TypeCacheFile, NodeSetFiles, LazyTypes);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(PayloadEncodingConfig, Machine, List, Online);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(CompressionConfig, Enabled, Threshold, Level, DictionarySamples, DictionarySize, DictionaryDirectory);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(RateGroupConfig, Name, Specification, Paths, Types, Interval, Merged);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(FileSinkConfig, Directory, Prefix, Format, MaxFileSize, MaxFiles, BufferSize, SyncInterval);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(RedisConfig, Hostname, Port, Password, Database, KeyPrefix, StreamClasses, StreamMaxLength, FlushInterval, BatchSize);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(SparkplugConfig, Enabled, GroupId, EdgeNodeId, Will);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(UadpConfig, Enabled, TopicPrefix, PublisherId, WriterGroup, WriterGroupId, KeyFrameCount);
+		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(PublishConfig, DeltaMode, SnapshotInterval, LeafTopics, Encoding, Compression, StatusRefreshInterval, Interval, Intervals, RateGroups, Workers, Sinks, SinkQueueSize, File, Redis, Sparkplug, Uadp);
 		NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(NamespaceInformation, Namespace, Types, IdentificationType);
 
 		class ConfigurationJsonFile : public Configuration {
@@ -28,6 +38,7 @@ namespace Umati {
 			// Inherit from Configuration
 			OpcUaConfig getOpcUa() override;
 			MqttConfig getMqtt() override;
+			PublishConfig getPublish() override;
 			bool hasMachinesFilter() override;
 			std::vector<ModelOpcUa::NodeId_t> getMachinesFilter() override;
 			std::vector<NamespaceInformation> getNamespaceInformations() override;
@@ -41,6 +52,8 @@ namespace Umati {
 			std::vector<ModelOpcUa::NodeId_t> MachinesFilter;
 			std::vector<NamespaceInformation> NamespaceInformations;
 			MqttConfig Mqtt;
+			/// Optional section, defaults are used if it is missing
+			PublishConfig Publish;
 		};
 	}
 }
@@ -0,0 +1,29 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "Iso8601.hpp"
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+namespace Umati {
+namespace Util {
+std::string ToIso8601(std::chrono::system_clock::time_point timePoint) {
+  auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(timePoint.time_since_epoch()).count() % 1000;
+  std::time_t time = std::chrono::system_clock::to_time_t(timePoint);
+  std::tm utc{};
+#ifdef _WIN32
+  gmtime_s(&utc, &time);
+#else
+  gmtime_r(&time, &utc);
+#endif
+  std::stringstream ss;
+  ss << std::put_time(&utc, "%Y-%m-%dT%H:%M:%S") << "." << std::setw(3) << std::setfill('0') << milliseconds << "Z";
+  return ss.str();
+}
+}  // namespace Util
+}  // namespace Umati
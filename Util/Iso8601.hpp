@@ -0,0 +1,18 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+namespace Umati {
+namespace Util {
+/// Formats a point in time as UTC with millisecond precision, e.g. 2023-06-01T12:00:00.123Z
+std::string ToIso8601(std::chrono::system_clock::time_point timePoint);
+}  // namespace Util
+}  // namespace Umati
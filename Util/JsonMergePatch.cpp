@@ -0,0 +1,46 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "JsonMergePatch.hpp"
+
+namespace Umati {
+namespace Util {
+nlohmann::json CreateMergePatch(const nlohmann::json &source, const nlohmann::json &target) {
+  if (!source.is_object() || !target.is_object()) {
+    // Non object values can only be replaced as a whole
+    if (source == target) {
+      return nlohmann::json::object();
+    }
+    return target;
+  }
+
+  nlohmann::json patch = nlohmann::json::object();
+  for (auto it = source.begin(); it != source.end(); ++it) {
+    if (target.find(it.key()) == target.end()) {
+      patch[it.key()] = nullptr;
+    }
+  }
+
+  for (auto it = target.begin(); it != target.end(); ++it) {
+    auto itSource = source.find(it.key());
+    if (itSource == source.end()) {
+      patch[it.key()] = it.value();
+      continue;
+    }
+    if (*itSource == it.value()) {
+      continue;
+    }
+    if (itSource->is_object() && it.value().is_object()) {
+      patch[it.key()] = CreateMergePatch(*itSource, it.value());
+    } else {
+      patch[it.key()] = it.value();
+    }
+  }
+  return patch;
+}
+}  // namespace Util
+}  // namespace Umati
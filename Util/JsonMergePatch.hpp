@@ -0,0 +1,23 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+namespace Umati {
+namespace Util {
+/**
+ * Create a JSON merge patch (RFC 7386) that transforms source into target.
+ *
+ * Applying the result with nlohmann::json::merge_patch to source yields target. Removed members are set to null,
+ * arrays are always replaced as a whole. An empty object is returned if both documents are equal.
+ * As null marks a removal, null values inside target can not be expressed and are treated as removed members.
+ */
+nlohmann::json CreateMergePatch(const nlohmann::json &source, const nlohmann::json &target);
+}  // namespace Util
+}  // namespace Umati
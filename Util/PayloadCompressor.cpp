@@ -0,0 +1,179 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "PayloadCompressor.hpp"
+#include "IdEncode.hpp"
+
+#include <easylogging++.h>
+#include <fstream>
+#include <iterator>
+
+#ifdef UMATI_WITH_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+namespace Umati {
+namespace Util {
+struct PayloadCompressor::Dictionary_t {
+  std::uint32_t id = 0;
+  std::string content;
+#ifdef UMATI_WITH_ZSTD
+  ZSTD_CDict *cdict = nullptr;
+  ~Dictionary_t() { ZSTD_freeCDict(cdict); }
+#endif
+};
+
+PayloadCompressor::PayloadCompressor(CompressionConfig config, newDictionaryCallback_t newDictionaryCallback)
+  : m_config(std::move(config)), m_newDictionaryCallback(std::move(newDictionaryCallback)) {
+#ifdef UMATI_WITH_ZSTD
+  m_context = std::shared_ptr<ZSTD_CCtx>(ZSTD_createCCtx(), ZSTD_freeCCtx);
+#endif
+}
+
+PayloadCompressor::~PayloadCompressor() { WaitForTraining(); }
+
+bool PayloadCompressor::Compress(const std::string &group, std::string &payload, std::uint32_t *dictionaryId) {
+#ifdef UMATI_WITH_ZSTD
+  if (!m_config.Enabled || payload.size() < m_config.Threshold) {
+    return false;
+  }
+
+  std::shared_ptr<Dictionary_t> dictionary;
+  std::shared_ptr<Dictionary_t> loadedDictionary;
+  if (!group.empty() && m_config.DictionarySamples > 0) {
+    std::lock_guard<std::mutex> l(m_mutex);
+    auto it = m_groups.find(group);
+    if (it == m_groups.end()) {
+      it = m_groups.emplace(group, Group_t()).first;
+      loadedDictionary = loadDictionary(group);
+      if (loadedDictionary) {
+        it->second.dictionary = loadedDictionary;
+        it->second.collectSamples = false;
+      }
+    }
+    auto &groupData = it->second;
+    dictionary = groupData.dictionary;
+    if (groupData.collectSamples) {
+      groupData.samples.push_back(payload);
+      if (groupData.samples.size() >= m_config.DictionarySamples) {
+        groupData.collectSamples = false;
+        m_trainings.remove_if([](const std::future<void> &f) { return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+        m_trainings.push_back(std::async(std::launch::async, &PayloadCompressor::train, this, group, std::move(groupData.samples)));
+        groupData.samples.clear();
+      }
+    }
+  }
+  if (loadedDictionary && m_newDictionaryCallback) {
+    m_newDictionaryCallback(loadedDictionary->id, loadedDictionary->content);
+  }
+
+  std::string compressed(ZSTD_compressBound(payload.size()), '\0');
+  std::size_t size;
+  {
+    std::lock_guard<std::mutex> l(m_contextMutex);
+    if (dictionary) {
+      size = ZSTD_compress_usingCDict(m_context.get(), &compressed[0], compressed.size(), payload.data(), payload.size(), dictionary->cdict);
+    } else {
+      size = ZSTD_compressCCtx(m_context.get(), &compressed[0], compressed.size(), payload.data(), payload.size(), m_config.Level);
+    }
+  }
+  if (ZSTD_isError(size)) {
+    LOG(ERROR) << "Compression failed: " << ZSTD_getErrorName(size);
+    return false;
+  }
+  compressed.resize(size);
+  payload.swap(compressed);
+  if (dictionaryId) {
+    *dictionaryId = dictionary ? dictionary->id : 0;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void PayloadCompressor::WaitForTraining() {
+  std::list<std::future<void>> trainings;
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    trainings.swap(m_trainings);
+  }
+  for (auto &training : trainings) {
+    training.wait();
+  }
+}
+
+void PayloadCompressor::train(const std::string &group, std::vector<std::string> samples) {
+#ifdef UMATI_WITH_ZSTD
+  std::string samplesBuffer;
+  std::vector<std::size_t> sampleSizes;
+  for (const auto &sample : samples) {
+    samplesBuffer += sample;
+    sampleSizes.push_back(sample.size());
+  }
+  samples.clear();
+
+  std::string content(m_config.DictionarySize, '\0');
+  auto size = ZDICT_trainFromBuffer(&content[0], content.size(), samplesBuffer.data(), sampleSizes.data(), static_cast<unsigned>(sampleSizes.size()));
+  if (ZDICT_isError(size)) {
+    LOG(WARNING) << "Could not train compression dictionary for " << group << ": " << ZDICT_getErrorName(size);
+    return;
+  }
+  content.resize(size);
+  auto dictionary = createDictionary(std::move(content));
+  if (!dictionary) {
+    return;
+  }
+
+  std::ofstream file(dictionaryPath(group), std::ios::binary | std::ios::trunc);
+  file.write(dictionary->content.data(), static_cast<std::streamsize>(dictionary->content.size()));
+  if (!file) {
+    LOG(WARNING) << "Could not store compression dictionary " << dictionaryPath(group);
+  }
+
+  LOG(INFO) << "Trained compression dictionary " << dictionary->id << " for " << group << " (" << dictionary->content.size() << " bytes)";
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    m_groups[group].dictionary = dictionary;
+  }
+  if (m_newDictionaryCallback) {
+    m_newDictionaryCallback(dictionary->id, dictionary->content);
+  }
+#endif
+}
+
+std::shared_ptr<PayloadCompressor::Dictionary_t> PayloadCompressor::createDictionary(std::string content) const {
+  auto dictionary = std::make_shared<Dictionary_t>();
+#ifdef UMATI_WITH_ZSTD
+  dictionary->cdict = ZSTD_createCDict(content.data(), content.size(), m_config.Level);
+  if (dictionary->cdict == nullptr) {
+    LOG(WARNING) << "Invalid compression dictionary";
+    return nullptr;
+  }
+  dictionary->id = ZSTD_getDictID_fromDict(content.data(), content.size());
+#endif
+  dictionary->content = std::move(content);
+  return dictionary;
+}
+
+std::shared_ptr<PayloadCompressor::Dictionary_t> PayloadCompressor::loadDictionary(const std::string &group) const {
+  std::ifstream file(dictionaryPath(group), std::ios::binary);
+  if (!file) {
+    return nullptr;
+  }
+  std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  auto dictionary = createDictionary(std::move(content));
+  if (dictionary) {
+    LOG(INFO) << "Loaded compression dictionary " << dictionary->id << " for " << group;
+  }
+  return dictionary;
+}
+
+std::string PayloadCompressor::dictionaryPath(const std::string &group) const { return m_config.DictionaryDirectory + "/" + IdEncode(group) + ".zdict"; }
+}  // namespace Util
+}  // namespace Umati
@@ -0,0 +1,82 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Configuration.hpp"
+
+struct ZSTD_CCtx_s;
+
+namespace Umati {
+namespace Util {
+/**
+ * Compresses payloads above a size threshold as zstd frames.
+ *
+ * Payloads are grouped (e.g. by companion specification). Per group the first DictionarySamples payloads are
+ * collected and a dictionary is trained on them in the background, further payloads of the group are then compressed
+ * with it. The dictionary id is part of every zstd frame header, so a consumer can pick the matching dictionary.
+ * Trained dictionaries are stored in DictionaryDirectory and reused after a restart.
+ *
+ * Without zstd support (UMATI_WITH_ZSTD) payloads are never compressed.
+ */
+class PayloadCompressor {
+ public:
+  /// Called with the id and content of a dictionary as soon as it is used for compression
+  typedef std::function<void(std::uint32_t dictionaryId, const std::string &dictionary)> newDictionaryCallback_t;
+
+  explicit PayloadCompressor(CompressionConfig config, newDictionaryCallback_t newDictionaryCallback = newDictionaryCallback_t());
+  /// Waits for running dictionary trainings
+  ~PayloadCompressor();
+
+  PayloadCompressor(const PayloadCompressor &) = delete;
+  PayloadCompressor &operator=(const PayloadCompressor &) = delete;
+
+  /**
+   * Replaces payload by its compressed form and returns true if it reached the threshold, an empty group uses no dictionary.
+   * If set, dictionaryId receives the id of the used dictionary, 0 without one.
+   */
+  bool Compress(const std::string &group, std::string &payload, std::uint32_t *dictionaryId = nullptr);
+
+  /// Wait until all started dictionary trainings are finished
+  void WaitForTraining();
+
+ private:
+  struct Dictionary_t;
+
+  struct Group_t {
+    std::vector<std::string> samples;
+    /// Cleared once the training started or a stored dictionary was loaded
+    bool collectSamples = true;
+    std::shared_ptr<Dictionary_t> dictionary;
+  };
+
+  void train(const std::string &group, std::vector<std::string> samples);
+  std::shared_ptr<Dictionary_t> createDictionary(std::string content) const;
+  std::shared_ptr<Dictionary_t> loadDictionary(const std::string &group) const;
+  std::string dictionaryPath(const std::string &group) const;
+
+  CompressionConfig m_config;
+  newDictionaryCallback_t m_newDictionaryCallback;
+  std::mutex m_mutex;
+  std::map<std::string, Group_t> m_groups;
+  std::list<std::future<void>> m_trainings;
+  /// Reused for all payloads, only used while m_contextMutex is locked
+  std::mutex m_contextMutex;
+  std::shared_ptr<ZSTD_CCtx_s> m_context;
+};
+}  // namespace Util
+}  // namespace Umati
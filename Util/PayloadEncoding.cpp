@@ -0,0 +1,68 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "PayloadEncoding.hpp"
+#include "Exceptions/ConfigurationException.hpp"
+
+namespace Umati {
+namespace Util {
+PayloadEncoding_t PayloadEncodingFromString(const std::string &name) {
+  if (name == "json") {
+    return PayloadEncoding_t::Json;
+  }
+  if (name == "cbor") {
+    return PayloadEncoding_t::Cbor;
+  }
+  if (name == "msgpack") {
+    return PayloadEncoding_t::MessagePack;
+  }
+  throw Exception::ConfigurationException(("Unknown payload encoding '" + name + "', expected json, cbor or msgpack.").c_str());
+}
+
+std::string EncodePayload(const nlohmann::json &document, PayloadEncoding_t encoding, int indent) {
+  switch (encoding) {
+    case PayloadEncoding_t::Cbor: {
+      std::string payload;
+      nlohmann::json::to_cbor(document, payload);
+      return payload;
+    }
+    case PayloadEncoding_t::MessagePack: {
+      std::string payload;
+      nlohmann::json::to_msgpack(document, payload);
+      return payload;
+    }
+    case PayloadEncoding_t::Json:
+    default:
+      return document.dump(indent);
+  }
+}
+
+std::string PayloadEncodingTopicSuffix(PayloadEncoding_t encoding) {
+  switch (encoding) {
+    case PayloadEncoding_t::Cbor:
+      return "/$cbor";
+    case PayloadEncoding_t::MessagePack:
+      return "/$msgpack";
+    case PayloadEncoding_t::Json:
+    default:
+      return std::string();
+  }
+}
+
+std::string PayloadEncodingContentType(PayloadEncoding_t encoding) {
+  switch (encoding) {
+    case PayloadEncoding_t::Cbor:
+      return "application/cbor";
+    case PayloadEncoding_t::MessagePack:
+      return "application/msgpack";
+    case PayloadEncoding_t::Json:
+    default:
+      return "application/json";
+  }
+}
+}  // namespace Util
+}  // namespace Umati
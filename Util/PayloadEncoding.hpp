@@ -0,0 +1,30 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace Umati {
+namespace Util {
+/// Serialisation of a published document, the structure is the same for all encodings
+enum class PayloadEncoding_t { Json, Cbor, MessagePack };
+
+/// Parses "json", "cbor" or "msgpack", throws a ConfigurationException for other names
+PayloadEncoding_t PayloadEncodingFromString(const std::string &name);
+
+/// indent is only used by Json, see nlohmann::json::dump
+std::string EncodePayload(const nlohmann::json &document, PayloadEncoding_t encoding, int indent = -1);
+
+/// Topic level appended to signal a binary encoding, e.g. "/$cbor". Empty for Json to keep the existing topics.
+std::string PayloadEncodingTopicSuffix(PayloadEncoding_t encoding);
+
+/// MIME type of the encoding, e.g. for the MQTT v5 content type
+std::string PayloadEncodingContentType(PayloadEncoding_t encoding);
+}  // namespace Util
+}  // namespace Umati
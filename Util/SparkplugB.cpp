@@ -0,0 +1,321 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "SparkplugB.hpp"
+
+#include <cstring>
+
+namespace Umati {
+namespace Util {
+namespace SparkplugB {
+namespace {
+enum WireType_t : std::uint32_t { Varint = 0, Fixed64 = 1, LengthDelimited = 2, Fixed32 = 5 };
+
+namespace PayloadField {
+const std::uint32_t Timestamp = 1;
+const std::uint32_t Metrics = 2;
+const std::uint32_t Seq = 3;
+}  // namespace PayloadField
+
+namespace MetricField {
+const std::uint32_t Name = 1;
+const std::uint32_t Alias = 2;
+const std::uint32_t Timestamp = 3;
+const std::uint32_t DataType = 4;
+const std::uint32_t IsNull = 7;
+const std::uint32_t LongValue = 11;
+const std::uint32_t DoubleValue = 13;
+const std::uint32_t BooleanValue = 14;
+const std::uint32_t StringValue = 15;
+}  // namespace MetricField
+
+void appendVarint(std::string &target, std::uint64_t value) {
+  while (value >= 0x80) {
+    target.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  target.push_back(static_cast<char>(value));
+}
+
+void appendTag(std::string &target, std::uint32_t field, WireType_t wireType) { appendVarint(target, (field << 3) | wireType); }
+
+void appendVarintField(std::string &target, std::uint32_t field, std::uint64_t value) {
+  appendTag(target, field, Varint);
+  appendVarint(target, value);
+}
+
+void appendBytesField(std::string &target, std::uint32_t field, const std::string &value) {
+  appendTag(target, field, LengthDelimited);
+  appendVarint(target, value.size());
+  target.append(value);
+}
+
+void appendDoubleField(std::string &target, std::uint32_t field, double value) {
+  std::uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(value), "double must have 64 bits");
+  std::memcpy(&bits, &value, sizeof(bits));
+  appendTag(target, field, Fixed64);
+  for (int i = 0; i < 8; ++i) {
+    target.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+  }
+}
+
+std::string encodeMetric(const Metric_t &metric) {
+  std::string encoded;
+  if (!metric.name.empty()) {
+    appendBytesField(encoded, MetricField::Name, metric.name);
+  }
+  if (metric.alias != 0) {
+    appendVarintField(encoded, MetricField::Alias, metric.alias);
+  }
+  if (metric.timestamp != 0) {
+    appendVarintField(encoded, MetricField::Timestamp, metric.timestamp);
+  }
+  appendVarintField(encoded, MetricField::DataType, static_cast<std::uint32_t>(metric.dataType));
+  if (metric.isNull) {
+    appendVarintField(encoded, MetricField::IsNull, 1);
+    return encoded;
+  }
+  switch (metric.dataType) {
+    case DataType_t::Int64:
+    case DataType_t::UInt64:
+      appendVarintField(encoded, MetricField::LongValue, metric.longValue);
+      break;
+    case DataType_t::Double:
+      appendDoubleField(encoded, MetricField::DoubleValue, metric.doubleValue);
+      break;
+    case DataType_t::Boolean:
+      appendVarintField(encoded, MetricField::BooleanValue, metric.booleanValue ? 1 : 0);
+      break;
+    case DataType_t::String:
+      appendBytesField(encoded, MetricField::StringValue, metric.stringValue);
+      break;
+  }
+  return encoded;
+}
+
+class Reader {
+ public:
+  Reader(const char *data, std::size_t size) : m_data(data), m_end(data + size) {}
+
+  bool AtEnd() const { return m_data == m_end; }
+
+  bool ReadVarint(std::uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (m_data == m_end) {
+        return false;
+      }
+      auto byte = static_cast<std::uint8_t>(*m_data++);
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadFixed64(std::uint64_t &value) {
+    if (m_end - m_data < 8) {
+      return false;
+    }
+    value = 0;
+    for (int i = 0; i < 8; ++i) {
+      value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(*m_data++)) << (8 * i);
+    }
+    return true;
+  }
+
+  bool ReadBytes(std::string &value) {
+    std::uint64_t size;
+    if (!ReadVarint(size) || size > static_cast<std::uint64_t>(m_end - m_data)) {
+      return false;
+    }
+    value.assign(m_data, static_cast<std::size_t>(size));
+    m_data += size;
+    return true;
+  }
+
+  bool Skip(std::uint32_t wireType) {
+    std::uint64_t ignored;
+    std::string ignoredBytes;
+    switch (wireType) {
+      case Varint:
+        return ReadVarint(ignored);
+      case Fixed64:
+        return ReadFixed64(ignored);
+      case LengthDelimited:
+        return ReadBytes(ignoredBytes);
+      case Fixed32:
+        if (m_end - m_data < 4) {
+          return false;
+        }
+        m_data += 4;
+        return true;
+      default:
+        // Groups are not used by the Sparkplug B schema
+        return false;
+    }
+  }
+
+ private:
+  const char *m_data;
+  const char *m_end;
+};
+
+bool decodeMetric(const std::string &encoded, Metric_t &metric) {
+  Reader reader(encoded.data(), encoded.size());
+  while (!reader.AtEnd()) {
+    std::uint64_t tag;
+    if (!reader.ReadVarint(tag)) {
+      return false;
+    }
+    auto field = static_cast<std::uint32_t>(tag >> 3);
+    auto wireType = static_cast<std::uint32_t>(tag & 0x07);
+    std::uint64_t value = 0;
+    bool ok = true;
+    if (field == MetricField::Name && wireType == LengthDelimited) {
+      ok = reader.ReadBytes(metric.name);
+    } else if (field == MetricField::StringValue && wireType == LengthDelimited) {
+      ok = reader.ReadBytes(metric.stringValue);
+    } else if (field == MetricField::DoubleValue && wireType == Fixed64) {
+      ok = reader.ReadFixed64(value);
+      static_assert(sizeof(value) == sizeof(metric.doubleValue), "double must have 64 bits");
+      std::memcpy(&metric.doubleValue, &value, sizeof(value));
+    } else if (wireType == Varint) {
+      ok = reader.ReadVarint(value);
+      switch (field) {
+        case MetricField::Alias:
+          metric.alias = value;
+          break;
+        case MetricField::Timestamp:
+          metric.timestamp = value;
+          break;
+        case MetricField::DataType:
+          metric.dataType = static_cast<DataType_t>(value);
+          break;
+        case MetricField::IsNull:
+          metric.isNull = value != 0;
+          break;
+        case MetricField::LongValue:
+          metric.longValue = value;
+          break;
+        case MetricField::BooleanValue:
+          metric.booleanValue = value != 0;
+          break;
+        default:
+          break;
+      }
+    } else {
+      ok = reader.Skip(wireType);
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+std::string Encode(const Payload_t &payload) {
+  std::string encoded;
+  appendVarintField(encoded, PayloadField::Timestamp, payload.timestamp);
+  for (const auto &metric : payload.metrics) {
+    appendBytesField(encoded, PayloadField::Metrics, encodeMetric(metric));
+  }
+  appendVarintField(encoded, PayloadField::Seq, payload.seq);
+  return encoded;
+}
+
+bool Decode(const std::string &encoded, Payload_t &payload) {
+  payload = Payload_t();
+  Reader reader(encoded.data(), encoded.size());
+  while (!reader.AtEnd()) {
+    std::uint64_t tag;
+    if (!reader.ReadVarint(tag)) {
+      return false;
+    }
+    auto field = static_cast<std::uint32_t>(tag >> 3);
+    auto wireType = static_cast<std::uint32_t>(tag & 0x07);
+    bool ok = true;
+    if (field == PayloadField::Metrics && wireType == LengthDelimited) {
+      std::string encodedMetric;
+      Metric_t metric;
+      ok = reader.ReadBytes(encodedMetric) && decodeMetric(encodedMetric, metric);
+      payload.metrics.push_back(std::move(metric));
+    } else if (field == PayloadField::Timestamp && wireType == Varint) {
+      ok = reader.ReadVarint(payload.timestamp);
+    } else if (field == PayloadField::Seq && wireType == Varint) {
+      ok = reader.ReadVarint(payload.seq);
+    } else {
+      ok = reader.Skip(wireType);
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+DataType_t DataTypeOf(const nlohmann::json &value) {
+  switch (value.type()) {
+    case nlohmann::json::value_t::boolean:
+      return DataType_t::Boolean;
+    case nlohmann::json::value_t::number_unsigned:
+      return DataType_t::UInt64;
+    case nlohmann::json::value_t::number_integer:
+      return DataType_t::Int64;
+    case nlohmann::json::value_t::number_float:
+      return DataType_t::Double;
+    default:
+      return DataType_t::String;
+  }
+}
+
+bool SetValue(Metric_t &metric, const nlohmann::json &value) {
+  metric.isNull = value.is_null();
+  if (metric.isNull) {
+    return true;
+  }
+  switch (metric.dataType) {
+    case DataType_t::Int64:
+      // Non negative values are parsed as unsigned by nlohmann::json
+      if (!value.is_number_integer() || (value.is_number_unsigned() && value.get<std::uint64_t>() > INT64_MAX)) {
+        return false;
+      }
+      metric.longValue = static_cast<std::uint64_t>(value.get<std::int64_t>());
+      return true;
+    case DataType_t::UInt64:
+      if (!value.is_number_unsigned()) {
+        return false;
+      }
+      metric.longValue = value.get<std::uint64_t>();
+      return true;
+    case DataType_t::Double:
+      if (!value.is_number()) {
+        return false;
+      }
+      metric.doubleValue = value.get<double>();
+      return true;
+    case DataType_t::Boolean:
+      if (!value.is_boolean()) {
+        return false;
+      }
+      metric.booleanValue = value.get<bool>();
+      return true;
+    case DataType_t::String:
+      if (value.is_boolean() || value.is_number()) {
+        return false;
+      }
+      metric.stringValue = value.is_string() ? value.get<std::string>() : value.dump();
+      return true;
+  }
+  return false;
+}
+}  // namespace SparkplugB
+}  // namespace Util
+}  // namespace Umati
@@ -0,0 +1,56 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace Umati {
+namespace Util {
+/// Protobuf encoding of the Sparkplug B payload (org.eclipse.tahu.protobuf.Payload), limited to the fields used by the client
+namespace SparkplugB {
+/// Values of the Sparkplug B DataType enumeration
+enum class DataType_t : std::uint32_t { Int64 = 4, UInt64 = 8, Double = 10, Boolean = 11, String = 12 };
+
+struct Metric_t {
+  /// Only sent if not empty, data messages use the alias instead
+  std::string name;
+  std::uint64_t alias = 0;
+  /// Milliseconds since epoch, 0 for none
+  std::uint64_t timestamp = 0;
+  DataType_t dataType = DataType_t::String;
+  bool isNull = false;
+  /// Int64 is stored as two's complement in longValue
+  std::uint64_t longValue = 0;
+  double doubleValue = 0;
+  bool booleanValue = false;
+  std::string stringValue;
+};
+
+struct Payload_t {
+  /// Milliseconds since epoch
+  std::uint64_t timestamp = 0;
+  std::vector<Metric_t> metrics;
+  std::uint64_t seq = 0;
+};
+
+std::string Encode(const Payload_t &payload);
+
+/// Decodes the fields known to Encode and skips all others, returns false if encoded is no valid protobuf message
+bool Decode(const std::string &encoded, Payload_t &payload);
+
+/// Data type to declare for a JSON value, objects and arrays are sent as JSON string
+DataType_t DataTypeOf(const nlohmann::json &value);
+
+/// Sets the value of the metric, returns false if it does not match the declared data type of the metric
+bool SetValue(Metric_t &metric, const nlohmann::json &value);
+}  // namespace SparkplugB
+}  // namespace Util
+}  // namespace Umati
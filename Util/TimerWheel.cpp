@@ -0,0 +1,141 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+
+namespace Umati {
+namespace Util {
+constexpr unsigned TimerWheel::SlotBits;
+constexpr std::uint64_t TimerWheel::SlotsPerLevel;
+constexpr unsigned TimerWheel::Levels;
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick, Clock_t::time_point start)
+  : m_tick(std::max(tick, std::chrono::milliseconds(1))), m_start(start) {}
+
+TimerWheel::TimerId_t TimerWheel::Add(Clock_t::time_point deadline, Clock_t::duration interval) {
+  TimerId_t id = m_nextId++;
+  auto expiry = toTick(deadline);
+  m_timers[id] = Timer_t{expiry, deadline, std::max(interval, Clock_t::duration::zero())};
+  insert(id, expiry);
+  return id;
+}
+
+void TimerWheel::Remove(TimerId_t id) {
+  // The entry in the wheel is dropped when its slot is processed
+  m_timers.erase(id);
+}
+
+void TimerWheel::Advance(Clock_t::time_point now, std::vector<TimerId_t> &expired) {
+  if (now < m_start) {
+    return;
+  }
+  const std::uint64_t nowTick = (now - m_start) / m_tick;
+  while (m_currentTick < nowTick) {
+    if (m_timers.empty()) {
+      m_currentTick = nowTick;
+      break;
+    }
+    ++m_currentTick;
+
+    // Move the timers of the higher levels down, starting at the highest level that reached a slot boundary
+    unsigned levelsToCascade = 0;
+    while (levelsToCascade + 1 < Levels && ((m_currentTick >> (SlotBits * (levelsToCascade + 1))) << (SlotBits * (levelsToCascade + 1))) == m_currentTick) {
+      ++levelsToCascade;
+    }
+    for (unsigned level = levelsToCascade; level > 0; --level) {
+      cascade(level);
+    }
+
+    Slot_t slot;
+    slot.swap(m_wheel[0][m_currentTick & (SlotsPerLevel - 1)]);
+    for (const auto &entry : slot) {
+      if (!isCurrent(entry)) {
+        continue;
+      }
+      expired.push_back(entry.id);
+      auto &timer = m_timers[entry.id];
+      if (timer.interval == Clock_t::duration::zero()) {
+        m_timers.erase(entry.id);
+        continue;
+      }
+      // Keep the phase, but expire at most once per call, periods that already passed are skipped
+      do {
+        timer.deadline += timer.interval;
+        timer.expiry = toTick(timer.deadline);
+      } while (timer.expiry <= nowTick);
+      insert(entry.id, timer.expiry);
+    }
+  }
+}
+
+TimerWheel::Clock_t::time_point TimerWheel::NextDeadline() const {
+  std::uint64_t next = UINT64_MAX;
+  for (unsigned level = 0; level < Levels; ++level) {
+    const auto position = m_currentTick >> (SlotBits * level);
+    for (std::uint64_t offset = 1; offset <= SlotsPerLevel; ++offset) {
+      // The slots of a level cover consecutive ranges, so the first used slot contains the earliest timer of the level
+      bool used = false;
+      for (const auto &entry : m_wheel[level][(position + offset) & (SlotsPerLevel - 1)]) {
+        if (isCurrent(entry)) {
+          next = std::min(next, entry.expiry);
+          used = true;
+        }
+      }
+      if (used) {
+        break;
+      }
+    }
+  }
+  if (next == UINT64_MAX) {
+    return Clock_t::time_point::max();
+  }
+  return m_start + m_tick * static_cast<Clock_t::rep>(next);
+}
+
+std::uint64_t TimerWheel::toTick(Clock_t::time_point deadline) const {
+  if (deadline <= m_start) {
+    return m_currentTick + 1;
+  }
+  // Round up, a timer must not expire before its deadline
+  auto elapsed = deadline - m_start;
+  std::uint64_t tick = elapsed / m_tick;
+  if (m_tick * static_cast<Clock_t::rep>(tick) < elapsed) {
+    ++tick;
+  }
+  return std::max(tick, m_currentTick + 1);
+}
+
+void TimerWheel::insert(TimerId_t id, std::uint64_t expiry) {
+  const std::uint64_t delta = expiry - m_currentTick;
+  unsigned level = 0;
+  while (level + 1 < Levels && delta >= (std::uint64_t(1) << (SlotBits * (level + 1)))) {
+    ++level;
+  }
+  // Beyond the range of the wheel, the timer is cascaded again when the last slot is reached
+  const std::uint64_t maxDelta = (std::uint64_t(1) << (SlotBits * Levels)) - 1;
+  const std::uint64_t slotTick = delta > maxDelta ? m_currentTick + maxDelta : expiry;
+  m_wheel[level][(slotTick >> (SlotBits * level)) & (SlotsPerLevel - 1)].push_back(Entry_t{id, expiry});
+}
+
+void TimerWheel::cascade(unsigned level) {
+  Slot_t slot;
+  slot.swap(m_wheel[level][(m_currentTick >> (SlotBits * level)) & (SlotsPerLevel - 1)]);
+  for (const auto &entry : slot) {
+    if (isCurrent(entry)) {
+      insert(entry.id, entry.expiry);
+    }
+  }
+}
+
+bool TimerWheel::isCurrent(const Entry_t &entry) const {
+  auto it = m_timers.find(entry.id);
+  return it != m_timers.end() && it->second.expiry == entry.expiry;
+}
+}  // namespace Util
+}  // namespace Umati
@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Umati {
+namespace Util {
+/**
+ * Hierarchical timer wheel with a fixed tick resolution.
+ *
+ * Adding and removing a timer is O(1), a timer moves at most once per level towards the finest level before it
+ * expires. Timers never expire before their deadline, but up to one tick after it.
+ * Not thread safe.
+ */
+class TimerWheel {
+ public:
+  typedef std::chrono::steady_clock Clock_t;
+  typedef std::uint64_t TimerId_t;
+
+  explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(10), Clock_t::time_point start = Clock_t::now());
+
+  /// Adds a timer expiring at deadline, a positive interval restarts it periodically based on the previous deadline
+  TimerId_t Add(Clock_t::time_point deadline, Clock_t::duration interval = Clock_t::duration::zero());
+
+  void Remove(TimerId_t id);
+
+  /// Appends the ids of all timers expired until now to expired, periodic timers are restarted
+  void Advance(Clock_t::time_point now, std::vector<TimerId_t> &expired);
+
+  /// Time the next timer expires, rounded up to a full tick, Clock_t::time_point::max() if there is no timer
+  Clock_t::time_point NextDeadline() const;
+
+  std::size_t Size() const { return m_timers.size(); }
+
+ private:
+  static constexpr unsigned SlotBits = 6;
+  static constexpr std::uint64_t SlotsPerLevel = 1u << SlotBits;
+  static constexpr unsigned Levels = 4;
+
+  struct Timer_t {
+    std::uint64_t expiry;
+    Clock_t::time_point deadline;
+    Clock_t::duration interval;
+  };
+
+  struct Entry_t {
+    TimerId_t id;
+    /// Identifies outdated entries of removed or restarted timers
+    std::uint64_t expiry;
+  };
+
+  typedef std::vector<Entry_t> Slot_t;
+
+  std::uint64_t toTick(Clock_t::time_point deadline) const;
+  void insert(TimerId_t id, std::uint64_t expiry);
+  void cascade(unsigned level);
+  bool isCurrent(const Entry_t &entry) const;
+
+  const Clock_t::duration m_tick;
+  const Clock_t::time_point m_start;
+  /// Last processed tick
+  std::uint64_t m_currentTick = 0;
+  TimerId_t m_nextId = 1;
+  std::array<std::array<Slot_t, SlotsPerLevel>, Levels> m_wheel;
+  std::unordered_map<TimerId_t, Timer_t> m_timers;
+};
+}  // namespace Util
+}  // namespace Umati
@@ -0,0 +1,262 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#include "Uadp.hpp"
+
+#include <cstring>
+
+namespace Umati {
+namespace Util {
+namespace Uadp {
+namespace {
+const std::uint8_t UadpVersion = 1;
+
+namespace UadpFlags {
+const std::uint8_t PublisherId = 0x10;
+const std::uint8_t GroupHeader = 0x20;
+const std::uint8_t PayloadHeader = 0x40;
+const std::uint8_t ExtendedFlags1 = 0x80;
+}  // namespace UadpFlags
+
+namespace ExtendedFlags1 {
+const std::uint8_t PublisherIdString = 0x04;
+const std::uint8_t ExtendedFlags2 = 0x80;
+}  // namespace ExtendedFlags1
+
+namespace ExtendedFlags2 {
+const std::uint8_t DiscoveryResponse = 0x02 << 2;
+}  // namespace ExtendedFlags2
+
+namespace GroupFlags {
+const std::uint8_t WriterGroupId = 0x01;
+const std::uint8_t SequenceNumber = 0x08;
+}  // namespace GroupFlags
+
+namespace DataSetFlags1 {
+const std::uint8_t Valid = 0x01;
+const std::uint8_t FieldEncodingDataValue = 0x02 << 1;
+const std::uint8_t SequenceNumber = 0x08;
+const std::uint8_t MajorVersion = 0x20;
+const std::uint8_t MinorVersion = 0x40;
+const std::uint8_t DataSetFlags2 = 0x80;
+}  // namespace DataSetFlags1
+
+namespace DataSetFlags2 {
+const std::uint8_t Timestamp = 0x10;
+}  // namespace DataSetFlags2
+
+namespace DataValueMask {
+const std::uint8_t Value = 0x01;
+const std::uint8_t SourceTimestamp = 0x04;
+}  // namespace DataValueMask
+
+const std::uint8_t DiscoveryResponseDataSetMetaData = 2;
+/// Scalar
+const std::int32_t ValueRankScalar = -1;
+/// 100 ns intervals between 1601-01-01 and 1970-01-01
+const std::int64_t UnixEpochTicks = 116444736000000000LL;
+/// Seconds between 1970-01-01 and 2000-01-01
+const std::int64_t VersionTimeEpoch = 946684800;
+
+template <typename T>
+void appendLittleEndian(std::string &target, T value) {
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    target.push_back(static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFF));
+  }
+}
+
+void appendByte(std::string &target, std::uint8_t value) { target.push_back(static_cast<char>(value)); }
+
+void appendString(std::string &target, const std::string &value) {
+  appendLittleEndian(target, static_cast<std::int32_t>(value.size()));
+  target.append(value);
+}
+
+void appendNullArray(std::string &target) { appendLittleEndian(target, static_cast<std::int32_t>(-1)); }
+
+void appendEmptyLocalizedText(std::string &target) { appendByte(target, 0); }
+
+void appendNullGuid(std::string &target) { target.append(16, '\0'); }
+
+void appendDateTime(std::string &target, std::chrono::system_clock::time_point time) {
+  auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count() * 10 + UnixEpochTicks;
+  appendLittleEndian(target, static_cast<std::int64_t>(ticks));
+}
+
+void appendVariant(std::string &target, BuiltInType_t builtInType, const nlohmann::json &value) {
+  if (builtInType == BuiltInType_t::Variant) {
+    builtInType = BuiltInTypeOf(value);
+  }
+  appendByte(target, static_cast<std::uint8_t>(builtInType));
+  switch (builtInType) {
+    case BuiltInType_t::Boolean:
+      appendByte(target, value.get<bool>() ? 1 : 0);
+      break;
+    case BuiltInType_t::Int64:
+      appendLittleEndian(target, value.get<std::int64_t>());
+      break;
+    case BuiltInType_t::UInt64:
+      appendLittleEndian(target, value.get<std::uint64_t>());
+      break;
+    case BuiltInType_t::Double: {
+      double number = value.get<double>();
+      std::uint64_t bits;
+      static_assert(sizeof(bits) == sizeof(number), "double must have 64 bits");
+      std::memcpy(&bits, &number, sizeof(bits));
+      appendLittleEndian(target, bits);
+      break;
+    }
+    case BuiltInType_t::String:
+    case BuiltInType_t::Variant:
+      appendString(target, value.is_string() ? value.get<std::string>() : value.dump());
+      break;
+  }
+}
+
+void appendDataValue(std::string &target, const Field_t &field) {
+  bool hasSourceTimestamp = field.sourceTimestamp.time_since_epoch().count() != 0;
+  std::uint8_t mask = (field.value.is_null() ? 0 : DataValueMask::Value) | (hasSourceTimestamp ? DataValueMask::SourceTimestamp : 0);
+  appendByte(target, mask);
+  if (!field.value.is_null()) {
+    appendVariant(target, field.builtInType, field.value);
+  }
+  if (hasSourceTimestamp) {
+    appendDateTime(target, field.sourceTimestamp);
+  }
+}
+
+void appendFieldMetaData(std::string &target, const FieldMetaData_t &field) {
+  appendString(target, field.name);
+  appendEmptyLocalizedText(target);
+  // FieldFlags
+  appendLittleEndian(target, static_cast<std::uint16_t>(0));
+  appendByte(target, static_cast<std::uint8_t>(field.builtInType));
+  // DataType as two byte NodeId in namespace 0, the ids of the built-in types equal their DataType NodeIds
+  appendByte(target, 0);
+  appendByte(target, static_cast<std::uint8_t>(field.builtInType));
+  appendLittleEndian(target, ValueRankScalar);
+  // ArrayDimensions
+  appendNullArray(target);
+  // MaxStringLength
+  appendLittleEndian(target, static_cast<std::uint32_t>(0));
+  // DataSetFieldId
+  appendNullGuid(target);
+  // Properties
+  appendNullArray(target);
+}
+
+/// extendedFlags2 is only sent if not 0, which selects a NetworkMessage with DataSetMessages
+void appendNetworkMessageHeader(std::string &target, std::uint8_t flags, std::uint8_t extendedFlags2, const std::string &publisherId) {
+  appendByte(target, UadpVersion | UadpFlags::PublisherId | UadpFlags::ExtendedFlags1 | flags);
+  appendByte(target, ExtendedFlags1::PublisherIdString | (extendedFlags2 != 0 ? ExtendedFlags1::ExtendedFlags2 : 0));
+  if (extendedFlags2 != 0) {
+    appendByte(target, extendedFlags2);
+  }
+  appendString(target, publisherId);
+}
+}  // namespace
+
+std::string EncodeDataSetMessage(const NetworkMessageHeader_t &header, std::uint16_t dataSetWriterId, const DataSetMessage_t &message) {
+  std::string encoded;
+  appendNetworkMessageHeader(encoded, UadpFlags::GroupHeader | UadpFlags::PayloadHeader, 0, header.publisherId);
+  appendByte(encoded, GroupFlags::WriterGroupId | GroupFlags::SequenceNumber);
+  appendLittleEndian(encoded, header.writerGroupId);
+  appendLittleEndian(encoded, header.sequenceNumber);
+  // Payload header, the sizes of the DataSetMessages are omitted for a single one
+  appendByte(encoded, 1);
+  appendLittleEndian(encoded, dataSetWriterId);
+
+  appendByte(encoded,
+             DataSetFlags1::Valid | DataSetFlags1::FieldEncodingDataValue | DataSetFlags1::SequenceNumber | DataSetFlags1::MajorVersion |
+               DataSetFlags1::MinorVersion | DataSetFlags1::DataSetFlags2);
+  appendByte(encoded, static_cast<std::uint8_t>(message.type) | DataSetFlags2::Timestamp);
+  appendLittleEndian(encoded, message.sequenceNumber);
+  appendDateTime(encoded, message.timestamp);
+  appendLittleEndian(encoded, message.configurationVersion.major);
+  appendLittleEndian(encoded, message.configurationVersion.minor);
+  appendLittleEndian(encoded, static_cast<std::uint16_t>(message.fields.size()));
+  for (const auto &field : message.fields) {
+    if (message.type == DataSetMessageType_t::DeltaFrame) {
+      appendLittleEndian(encoded, field.index);
+    }
+    appendDataValue(encoded, field);
+  }
+  return encoded;
+}
+
+std::string EncodeMetaData(const NetworkMessageHeader_t &header, std::uint16_t dataSetWriterId, const DataSetMetaData_t &metaData) {
+  std::string encoded;
+  appendNetworkMessageHeader(encoded, 0, ExtendedFlags2::DiscoveryResponse, header.publisherId);
+  appendByte(encoded, DiscoveryResponseDataSetMetaData);
+  appendLittleEndian(encoded, header.sequenceNumber);
+  appendLittleEndian(encoded, dataSetWriterId);
+
+  // DataSetMetaDataType, without namespaces and structure, enumeration or simple type descriptions
+  appendNullArray(encoded);
+  appendNullArray(encoded);
+  appendNullArray(encoded);
+  appendNullArray(encoded);
+  appendString(encoded, metaData.name);
+  appendEmptyLocalizedText(encoded);
+  appendLittleEndian(encoded, static_cast<std::int32_t>(metaData.fields.size()));
+  for (const auto &field : metaData.fields) {
+    appendFieldMetaData(encoded, field);
+  }
+  // DataSetClassId
+  appendNullGuid(encoded);
+  appendLittleEndian(encoded, metaData.configurationVersion.major);
+  appendLittleEndian(encoded, metaData.configurationVersion.minor);
+  // StatusCode Good
+  appendLittleEndian(encoded, static_cast<std::uint32_t>(0));
+  return encoded;
+}
+
+BuiltInType_t BuiltInTypeOf(const nlohmann::json &value) {
+  switch (value.type()) {
+    case nlohmann::json::value_t::boolean:
+      return BuiltInType_t::Boolean;
+    case nlohmann::json::value_t::number_unsigned:
+      return BuiltInType_t::UInt64;
+    case nlohmann::json::value_t::number_integer:
+      return BuiltInType_t::Int64;
+    case nlohmann::json::value_t::number_float:
+      return BuiltInType_t::Double;
+    default:
+      return BuiltInType_t::String;
+  }
+}
+
+bool Fits(BuiltInType_t builtInType, const nlohmann::json &value) {
+  if (value.is_null()) {
+    return true;
+  }
+  switch (builtInType) {
+    case BuiltInType_t::Boolean:
+      return value.is_boolean();
+    case BuiltInType_t::Int64:
+      // Non negative values are parsed as unsigned by nlohmann::json
+      return value.is_number_integer() && !(value.is_number_unsigned() && value.get<std::uint64_t>() > INT64_MAX);
+    case BuiltInType_t::UInt64:
+      return value.is_number_unsigned();
+    case BuiltInType_t::Double:
+      return value.is_number();
+    case BuiltInType_t::String:
+      return !value.is_boolean() && !value.is_number();
+    case BuiltInType_t::Variant:
+      return true;
+  }
+  return false;
+}
+
+std::uint32_t VersionTime(std::uint32_t previous) {
+  auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() - VersionTimeEpoch;
+  auto versionTime = static_cast<std::uint32_t>(seconds);
+  return versionTime > previous ? versionTime : previous + 1;
+}
+}  // namespace Uadp
+}  // namespace Util
+}  // namespace Umati
@@ -0,0 +1,84 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace Umati {
+namespace Util {
+/// OPC UA Part 14 UADP NetworkMessages, limited to one DataSetMessage per NetworkMessage and the built-in types of JSON values
+namespace Uadp {
+/// Ids of the OPC UA built-in types, Variant is declared for fields of unknown or changing type (BaseDataType)
+enum class BuiltInType_t : std::uint8_t { Boolean = 1, Int64 = 8, UInt64 = 9, Double = 11, String = 12, Variant = 24 };
+
+struct ConfigurationVersion_t {
+  std::uint32_t major = 0;
+  std::uint32_t minor = 0;
+};
+
+struct FieldMetaData_t {
+  std::string name;
+  BuiltInType_t builtInType = BuiltInType_t::Variant;
+};
+
+struct DataSetMetaData_t {
+  std::string name;
+  std::vector<FieldMetaData_t> fields;
+  ConfigurationVersion_t configurationVersion;
+};
+
+struct Field_t {
+  /// Position of the field in DataSetMetaData_t::fields
+  std::uint16_t index = 0;
+  /// Declared type of the field, the value is converted to it
+  BuiltInType_t builtInType = BuiltInType_t::Variant;
+  /// Null is encoded as DataValue without value
+  nlohmann::json value;
+  /// Epoch for none
+  std::chrono::system_clock::time_point sourceTimestamp;
+};
+
+enum class DataSetMessageType_t : std::uint8_t { KeyFrame = 0, DeltaFrame = 1 };
+
+struct DataSetMessage_t {
+  DataSetMessageType_t type = DataSetMessageType_t::KeyFrame;
+  std::uint16_t sequenceNumber = 0;
+  std::chrono::system_clock::time_point timestamp;
+  ConfigurationVersion_t configurationVersion;
+  /// A key frame contains all fields in the order of the metadata, a delta frame the changed ones
+  std::vector<Field_t> fields;
+};
+
+/// Fields of the NetworkMessage header, the PublisherId is sent as String
+struct NetworkMessageHeader_t {
+  std::string publisherId;
+  std::uint16_t writerGroupId = 0;
+  std::uint16_t sequenceNumber = 0;
+};
+
+/// NetworkMessage with the DataSetMessage of one DataSetWriter, the fields are encoded as DataValue
+std::string EncodeDataSetMessage(const NetworkMessageHeader_t &header, std::uint16_t dataSetWriterId, const DataSetMessage_t &message);
+
+/// Discovery response NetworkMessage announcing the DataSetMetaData of a DataSetWriter, header.writerGroupId is not used
+std::string EncodeMetaData(const NetworkMessageHeader_t &header, std::uint16_t dataSetWriterId, const DataSetMetaData_t &metaData);
+
+/// Type of a JSON value when encoded as Variant, objects and arrays are sent as JSON string
+BuiltInType_t BuiltInTypeOf(const nlohmann::json &value);
+
+/// True if value can be sent as field of the declared type, null fits every type
+bool Fits(BuiltInType_t builtInType, const nlohmann::json &value);
+
+/// ConfigurationVersion value for now (seconds since 2000-01-01), always greater than previous
+std::uint32_t VersionTime(std::uint32_t previous);
+}  // namespace Uadp
+}  // namespace Util
+}  // namespace Umati
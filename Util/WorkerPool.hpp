@@ -0,0 +1,46 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 2026 (c) umati Dashboard OPC UA Client contributors (for umati and VDW e.V.)
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Umati {
+namespace Util {
+/**
+ * Fixed number of threads executing posted tasks in FIFO order.
+ * Exceptions of a task are logged and do not stop the thread.
+ */
+class WorkerPool {
+ public:
+  explicit WorkerPool(std::size_t threads);
+  /// Executes all posted tasks before returning
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  void Post(std::function<void()> task);
+
+  std::size_t Size() const { return m_threads.size(); }
+
+ private:
+  void run();
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<std::function<void()>> m_tasks;
+  bool m_stopped = false;
+  std::vector<std::thread> m_threads;
+};
+}  // namespace Util
+}  // namespace Umati
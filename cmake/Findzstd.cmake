@@ -0,0 +1,18 @@
+find_library(ZSTD_LIB NAMES zstd zstd_static HINTS ${ZSTD_DIR})
+if ("${ZSTD_LIB}" STREQUAL "ZSTD_LIB-NOTFOUND")
+    message(SEND_ERROR "### Could not found ZSTD, please specify CMAKE_PREFIX_PATH")
+else ()
+    message("### Found ZSTD_LIB library: '${ZSTD_LIB}'")
+endif ()
+
+
+find_path(ZSTD_INCLUDE zdict.h HINTS ${ZSTD_DIR})
+if ("${ZSTD_INCLUDE}" STREQUAL "ZSTD_INCLUDE-NOTFOUND")
+    message(SEND_ERROR "### Could not found ZSTD header, please specify CMAKE_PREFIX_PATH")
+else ()
+    message("### Found ZSTD include: '${ZSTD_INCLUDE}'")
+endif ()
+
+add_library(zstd::zstd INTERFACE IMPORTED)
+target_link_libraries(zstd::zstd INTERFACE ${ZSTD_LIB})
+target_include_directories(zstd::zstd INTERFACE ${ZSTD_INCLUDE})